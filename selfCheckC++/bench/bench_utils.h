@@ -0,0 +1,34 @@
+#ifndef BENCH_UTILS_H
+#define BENCH_UTILS_H
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+// 基准测试辅助：重复执行 fn 并打印每次调用的平均耗时与吞吐
+template <typename Fn>
+double run_benchmark(const std::string& label, long iterations, Fn&& fn) {
+    // 预热，避免首次调用的缓存/页缺失影响结果
+    for (long i = 0; i < iterations / 100 + 1; ++i) {
+        fn();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < iterations; ++i) {
+        fn();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double total_ns = std::chrono::duration<double, std::nano>(end - start).count();
+    double per_call_ns = total_ns / static_cast<double>(iterations);
+    std::printf("%-40s %12.1f ns/次  %14.0f 次/秒\n", label.c_str(), per_call_ns, 1e9 / per_call_ns);
+    return per_call_ns;
+}
+
+// 防止编译器优化掉基准测试中的计算结果
+template <typename T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+#endif // BENCH_UTILS_H
@@ -0,0 +1,165 @@
+// 自适应降载场景：子进程模拟飞控（100 Hz 周期任务，每周期 2 ms 计算），
+// 父进程模拟一波图片下载（多线程读文件并写入 socket），
+// 对比无负载、负载未降载、负载且降载三种情况下飞控周期的完成延迟
+#include "load_shedder.h"
+#include "logger.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fcntl.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+constexpr int PERIOD_US = 10000;
+constexpr int WORK_US = 2000;
+constexpr int PHASE_SECONDS = 3;
+constexpr int TRANSFER_THREADS = 4;
+constexpr size_t CHUNK = 64 * 1024;
+constexpr size_t IMAGE_BYTES = 8 * 1024 * 1024;
+const char* IMAGE_PATH = "/tmp/load_shedding_bench.img";
+
+int64_t now_us() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+// 飞控替身：按绝对时间唤醒，忙等 WORK_US 模拟一帧计算，记录从周期起点到完成的延迟
+void flight_stack_stand_in(int result_fd) {
+    std::vector<int64_t> latencies;
+    timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    const int cycles = PHASE_SECONDS * 1000000 / PERIOD_US;
+    for (int i = 0; i < cycles; ++i) {
+        next.tv_nsec += PERIOD_US * 1000L;
+        if (next.tv_nsec >= 1000000000L) {
+            next.tv_nsec -= 1000000000L;
+            ++next.tv_sec;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, nullptr);
+        const int64_t start = next.tv_sec * 1000000LL + next.tv_nsec / 1000;
+        // 按 CPU 时间计量工作量，被抢占的时间体现为延迟
+        timespec cpu_start;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_start);
+        while (true) {
+            timespec cpu_now;
+            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_now);
+            if ((cpu_now.tv_sec - cpu_start.tv_sec) * 1000000LL + (cpu_now.tv_nsec - cpu_start.tv_nsec) / 1000 >= WORK_US) {
+                break;
+            }
+        }
+        latencies.push_back(now_us() - start);
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    auto pct = [&latencies](double p) {
+        return latencies[std::min(latencies.size() - 1, static_cast<size_t>(p * latencies.size()))];
+    };
+    int64_t missed = std::count_if(latencies.begin(), latencies.end(), [](int64_t l) { return l > PERIOD_US; });
+    char line[128];
+    int n = snprintf(line, sizeof(line), "%8lld %8lld %8lld %6lld",
+                     static_cast<long long>(pct(0.5)), static_cast<long long>(pct(0.99)),
+                     static_cast<long long>(latencies.back()), static_cast<long long>(missed));
+    if (write(result_fd, line, static_cast<size_t>(n)) < 0) {
+        perror("write");
+    }
+}
+
+// 模拟图片下载：pread 读取文件块，经令牌桶限速后写入 socket，对端线程负责读空
+void transfer_worker(std::atomic<bool>& stop, std::atomic<uint64_t>& sent_bytes) {
+    int pair[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0) return;
+    std::thread drain([fd = pair[1]] {
+        std::vector<char> buffer(CHUNK);
+        while (read(fd, buffer.data(), buffer.size()) > 0) {}
+    });
+
+    int file = open(IMAGE_PATH, O_RDONLY);
+    std::vector<char> buffer(CHUNK);
+    off_t offset = 0;
+    while (!stop) {
+        ssize_t n = pread(file, buffer.data(), buffer.size(), offset);
+        if (n <= 0) {
+            offset = 0;
+            continue;
+        }
+        offset += n;
+        LoadShedder::throttle_image(static_cast<size_t>(n));
+        if (send(pair[0], buffer.data(), static_cast<size_t>(n), MSG_NOSIGNAL) < 0) break;
+        sent_bytes += static_cast<uint64_t>(n);
+    }
+    close(file);
+    shutdown(pair[0], SHUT_WR);
+    drain.join();
+    close(pair[0]);
+    close(pair[1]);
+}
+
+void run_phase(const char* label, bool with_load, bool shed) {
+    int result_pipe[2];
+    if (pipe(result_pipe) != 0) return;
+
+    pid_t child = fork();
+    if (child == 0) {
+        close(result_pipe[0]);
+        flight_stack_stand_in(result_pipe[1]);
+        _exit(0);
+    }
+    close(result_pipe[1]);
+
+    // 降载先于工作线程创建，新线程继承降低后的优先级
+    LoadShedder::set_shedding(shed, "基准测试");
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> sent_bytes{0};
+    std::vector<std::thread> workers;
+    const int64_t start = now_us();
+    if (with_load) {
+        for (int i = 0; i < TRANSFER_THREADS; ++i) {
+            workers.emplace_back(transfer_worker, std::ref(stop), std::ref(sent_bytes));
+        }
+    }
+
+    char result[128] = {0};
+    ssize_t n = read(result_pipe[0], result, sizeof(result) - 1);
+    waitpid(child, nullptr, 0);
+    stop = true;
+    for (auto& worker : workers) worker.join();
+    const double seconds = (now_us() - start) / 1e6;
+    LoadShedder::set_shedding(false, "基准测试");
+    close(result_pipe[0]);
+
+    std::printf("%-20s %s %10.1f\n", label, n > 0 ? result : "(无结果)", sent_bytes / seconds / (1024 * 1024));
+}
+
+} // namespace
+
+int main() {
+    Logger::initialize(Logger::ERROR);
+
+    int file = open(IMAGE_PATH, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    std::vector<char> block(CHUNK, 0x5a);
+    for (size_t written = 0; written < IMAGE_BYTES; written += CHUNK) {
+        if (write(file, block.data(), block.size()) < 0) {
+            perror("write");
+            return 1;
+        }
+    }
+    close(file);
+
+    std::printf("飞控替身: %d Hz，每周期计算 %d us；图片传输 %d 线程\n", 1000000 / PERIOD_US, WORK_US, TRANSFER_THREADS);
+    std::printf("%-20s %8s %8s %8s %6s %10s\n", "场景", "p50(us)", "p99(us)", "max(us)", "超周期", "传输MB/s");
+    run_phase("无负载", false, false);
+    run_phase("图片下载/未降载", true, false);
+    run_phase("图片下载/降载", true, true);
+
+    unlink(IMAGE_PATH);
+    return 0;
+}
@@ -0,0 +1,86 @@
+// 后台监控采样开销基准：验证各监控的单次采样成本足以支撑其采样频率
+#include "bench_utils.h"
+#include "cpu_monitor.h"
+#include "gpu_monitor.h"
+#include "interrupt_monitor.h"
+#include "memory_monitor.h"
+#include "network_monitor.h"
+#include "process_monitor.h"
+#include "storage_monitor.h"
+#include "thermal_monitor.h"
+#include "logger.h"
+#include <atomic>
+#include <fstream>
+#include <thread>
+#include <unistd.h>
+
+int main() {
+    Logger::initialize(Logger::WARNING);
+
+    CpuMonitor::initialize();
+    double cpu_ns = run_benchmark("CpuMonitor::sample", 20000, [] {
+        CpuMonitor::sample();
+    });
+    // 10 Hz 采样下每秒的 CPU 占用
+    std::printf("CPU 监控 10 Hz 采样占用: %.4f%% 单核\n", cpu_ns * 10 / 1e9 * 100);
+
+    GpuMonitor::initialize();
+    double gpu_ns = run_benchmark("GpuMonitor::sample", 20000, [] {
+        GpuMonitor::sample();
+    });
+    std::printf("GPU 监控 2 Hz 采样占用: %.4f%% 单核\n", gpu_ns * 2 / 1e9 * 100);
+
+    ThermalMonitor::initialize();
+    double thermal_ns = run_benchmark("ThermalMonitor::sample", 20000, [] {
+        ThermalMonitor::sample();
+    });
+    std::printf("温度监控 1 Hz 采样占用: %.4f%% 单核\n", thermal_ns / 1e9 * 100);
+
+    MemoryMonitor::initialize();
+    double memory_ns = run_benchmark("MemoryMonitor::sample", 20000, [] {
+        MemoryMonitor::sample();
+    });
+    std::printf("内存监控 1 Hz 采样占用: %.4f%% 单核\n", memory_ns / 1e9 * 100);
+    MemoryMonitor::shutdown();
+
+    InterruptMonitor::initialize();
+    double interrupt_ns = run_benchmark("InterruptMonitor::sample", 20000, [] {
+        InterruptMonitor::sample();
+    });
+    std::printf("中断监控 1 Hz 采样占用: %.4f%% 单核\n", interrupt_ns / 1e9 * 100);
+
+    StorageMonitor::initialize();
+    double storage_ns = run_benchmark("StorageMonitor::sample", 20000, [] {
+        StorageMonitor::sample();
+    });
+    std::printf("存储监控 1 Hz 采样占用: %.4f%% 单核\n", storage_ns / 1e9 * 100);
+
+    NetworkMonitor::initialize();
+    double network_ns = run_benchmark("NetworkMonitor::sample", 20000, [] {
+        NetworkMonitor::sample();
+    });
+    std::printf("网络监控 1 Hz 采样占用: %.4f%% 单核\n", network_ns / 1e9 * 100);
+
+    // 以本进程（含 8 个空闲线程）作为监视对象，通过 pidfile 解析
+    const std::string pidfile = "/tmp/monitor_sample_bench.pid";
+    std::ofstream(pidfile) << getpid() << "\n";
+    std::vector<std::thread> idle_threads;
+    std::atomic<bool> stop{false};
+    for (int i = 0; i < 8; ++i) {
+        idle_threads.emplace_back([&stop] {
+            while (!stop) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        });
+    }
+    ProcessWatchSpec spec;
+    spec.name = "bench";
+    spec.pidfile = pidfile;
+    ProcessMonitor::watch(spec);
+    double process_ns = run_benchmark("ProcessMonitor::sample（9 线程）", 20000, [] {
+        ProcessMonitor::sample();
+    });
+    std::printf("进程监控 20 Hz 采样占用: %.4f%% 单核（每个被监视进程）\n", process_ns * 20 / 1e9 * 100);
+    stop = true;
+    for (auto& thread : idle_threads) thread.join();
+    unlink(pidfile.c_str());
+    return 0;
+}
@@ -0,0 +1,45 @@
+/*
+ * 基准测试用空插件：不做任何工作，只测量插件调用路径本身的开销
+ */
+
+#include "check_plugin.h"
+
+#include <string.h>
+
+static int noop_run(void* state, selfcheck_run_result* result) {
+    (void)state;
+    result->status = SELFCHECK_STATUS_SUCCESS;
+    result->payload = NULL;
+    return 0;
+}
+
+static size_t noop_serialize(void* state, const selfcheck_run_result* result, char* buffer, size_t capacity) {
+    (void)state;
+    (void)result;
+    static const char MESSAGE[] = "ok";
+    if (capacity > 0) {
+        size_t n = capacity - 1 < sizeof(MESSAGE) - 1 ? capacity - 1 : sizeof(MESSAGE) - 1;
+        memcpy(buffer, MESSAGE, n);
+        buffer[n] = '\0';
+    }
+    return sizeof(MESSAGE) - 1;
+}
+
+static const selfcheck_check_descriptor DESCRIPTOR = {
+    SELFCHECK_PLUGIN_ABI_VERSION,
+    "noop",
+    "基准测试空插件",
+    100,
+    SELFCHECK_COST_CHEAP,
+    0,
+    NULL,
+    NULL,
+    NULL,
+    noop_run,
+    noop_serialize,
+    NULL
+};
+
+const selfcheck_check_descriptor* selfcheck_plugin_descriptor(void) {
+    return &DESCRIPTOR;
+}
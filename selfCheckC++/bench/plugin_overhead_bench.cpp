@@ -0,0 +1,70 @@
+// 插件调用开销基准：比较直接调用、注册表调用内置检测与通过 C ABI 调用插件
+#include "bench_utils.h"
+#include "check_plugin.h"
+#include "check_registry.h"
+#include "logger.h"
+#include <dlfcn.h>
+#include <string>
+
+namespace {
+
+SystemCheckResult builtin_noop() {
+    return {"success", "ok"};
+}
+
+} // namespace
+
+int main() {
+    Logger::initialize(Logger::WARNING);
+    CheckRegistry::initialize(BENCH_PLUGIN_DIR);
+
+    const CheckDefinition* plugin = CheckRegistry::find("noop");
+    if (!plugin) {
+        std::fprintf(stderr, "未找到 noop 插件，请确认已构建 %s\n", BENCH_PLUGIN_DIR);
+        return 1;
+    }
+
+    const long iterations = 2000000;
+    std::printf("插件调用开销 (%ld 次迭代)\n", iterations);
+
+    double direct = run_benchmark("直接调用内置函数", iterations, [] {
+        SystemCheckResult r = builtin_noop();
+        do_not_optimize(r);
+    });
+
+    CheckDefinition wrapped{"builtin_noop", &builtin_noop, 100, CostClass::CHEAP, {}};
+    run_benchmark("CheckDefinition 包装调用", iterations, [&] {
+        SystemCheckResult r = wrapped.run();
+        do_not_optimize(r);
+    });
+
+    // 直接通过描述符调用，不经过注册表
+    void* handle = dlopen(BENCH_PLUGIN_DIR "/noop_check_plugin.so", RTLD_NOW | RTLD_LOCAL);
+    auto entry = handle ? reinterpret_cast<selfcheck_plugin_entry_fn>(dlsym(handle, SELFCHECK_PLUGIN_ENTRY)) : nullptr;
+    if (entry) {
+        const selfcheck_check_descriptor* d = entry();
+        run_benchmark("C ABI 裸调用 (run + serialize)", iterations, [d] {
+            selfcheck_run_result result = {SELFCHECK_STATUS_ERROR, nullptr};
+            char buffer[64];
+            d->run(nullptr, &result);
+            size_t n = d->serialize(nullptr, &result, buffer, sizeof(buffer));
+            do_not_optimize(n);
+        });
+    }
+
+    double registered = run_benchmark("注册表调用插件 (缓存的定义)", iterations, [plugin] {
+        SystemCheckResult r = plugin->run();
+        do_not_optimize(r);
+    });
+
+    run_benchmark("注册表查找 + 调用插件", iterations, [] {
+        SystemCheckResult r = CheckRegistry::find("noop")->run();
+        do_not_optimize(r);
+    });
+
+    std::printf("插件路径相对直接调用的额外开销: %.1f ns/次\n", registered - direct);
+
+    if (handle) dlclose(handle);
+    CheckRegistry::shutdown();
+    return 0;
+}
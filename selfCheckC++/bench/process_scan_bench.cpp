@@ -0,0 +1,90 @@
+// 全系统进程遍历基准：派生子进程使进程总数达到约 500，
+// 对比 opendir + ifstream 逐个读取、首次遍历（打开全部 fd）与增量遍历（只 pread）的耗时
+#include "bench_utils.h"
+#include "process_table.h"
+#include "logger.h"
+#include <csignal>
+#include <cstdio>
+#include <dirent.h>
+#include <fstream>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+constexpr size_t TARGET_PROCESSES = 500;
+
+size_t count_processes() {
+    size_t count = 0;
+    DIR* dir = opendir("/proc");
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] >= '1' && entry->d_name[0] <= '9') ++count;
+    }
+    closedir(dir);
+    return count;
+}
+
+// 常见写法：每次遍历都重新打开每个进程的 stat 并用流解析
+size_t naive_scan() {
+    size_t total_rss = 0;
+    DIR* dir = opendir("/proc");
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] < '1' || entry->d_name[0] > '9') continue;
+        std::ifstream stat(std::string("/proc/") + entry->d_name + "/stat");
+        std::string line;
+        if (!std::getline(stat, line)) continue;
+        size_t paren = line.rfind(')');
+        if (paren == std::string::npos) continue;
+        unsigned long rss = 0;
+        unsigned long long utime = 0, stime = 0;
+        if (sscanf(line.c_str() + paren + 2,
+                   "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %llu %llu %*d %*d %*d %*d %*d %*d %*u %*u %lu",
+                   &utime, &stime, &rss) == 3) {
+            total_rss += rss;
+        }
+    }
+    closedir(dir);
+    return total_rss;
+}
+
+} // namespace
+
+int main() {
+    Logger::initialize(Logger::WARNING);
+
+    std::vector<pid_t> children;
+    for (size_t existing = count_processes(); existing + children.size() < TARGET_PROCESSES;) {
+        pid_t child = fork();
+        if (child == 0) {
+            pause();
+            _exit(0);
+        }
+        if (child < 0) break;
+        children.push_back(child);
+    }
+
+    const int64_t cold_start = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    ProcessTable::initialize();
+    const double cold_ms = (std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count() - cold_start) / 1e6;
+    std::printf("进程数 %zu，首次遍历（含打开 fd）%.2f ms\n", ProcessTable::process_count(), cold_ms);
+
+    double naive_ns = run_benchmark("opendir + ifstream + sscanf", 200, [] {
+        do_not_optimize(naive_scan());
+    });
+    double table_ns = run_benchmark("ProcessTable::refresh（增量）", 200, [] {
+        ProcessTable::refresh();
+    });
+    std::printf("增量遍历 %.2f ms，旧写法 %.2f ms\n", table_ns / 1e6, naive_ns / 1e6);
+
+    run_benchmark("top_rss(5) 最小堆", 20000, [] {
+        do_not_optimize(ProcessTable::top_rss(5));
+    });
+
+    for (pid_t child : children) kill(child, SIGKILL);
+    for (pid_t child : children) waitpid(child, nullptr, 0);
+    return 0;
+}
@@ -0,0 +1,99 @@
+// 模型文件摘要基准：SHA-256 压缩函数（硬件加速/可移植）的内存吞吐，
+// 以及对页缓存中的文件用 read 缓冲与 mmap 计算、单线程与多线程并行的 GB/s
+#include "bench_utils.h"
+#include "model_verifier.h"
+#include "sha256.h"
+#include "logger.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fcntl.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+constexpr size_t BUFFER_BYTES = 64 << 20;
+constexpr size_t FILE_COUNT = 4;
+constexpr size_t FILE_BYTES = 64 << 20;
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 常见写法：1 MiB 缓冲区循环 read
+std::string hash_with_read(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    std::vector<char> buffer(1 << 20);
+    Sha256 sha;
+    ssize_t n;
+    while ((n = read(fd, buffer.data(), buffer.size())) > 0) {
+        sha.update(buffer.data(), static_cast<size_t>(n));
+    }
+    close(fd);
+    return Sha256::to_hex(sha.finish());
+}
+
+double hash_files(const std::vector<std::string>& paths, size_t threads) {
+    std::atomic<size_t> next{0};
+    auto worker = [&] {
+        for (size_t i = next++; i < paths.size(); i = next++) {
+            std::string digest;
+            std::string error;
+            ModelVerifier::hash_file(paths[i], digest, error);
+        }
+    };
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (size_t t = 1; t < threads; ++t) pool.emplace_back(worker);
+    worker();
+    for (auto& thread : pool) thread.join();
+    return seconds_since(start);
+}
+
+} // namespace
+
+int main() {
+    Logger::initialize(Logger::WARNING);
+
+    std::vector<uint8_t> buffer(BUFFER_BYTES);
+    for (size_t i = 0; i < buffer.size(); ++i) buffer[i] = static_cast<uint8_t>(i * 2654435761u >> 24);
+
+    const char* accelerated = Sha256::implementation();
+    for (bool portable : {true, false}) {
+        Sha256::force_portable(portable);
+        const double ns = run_benchmark(std::string("Sha256::hash 64 MiB（") + Sha256::implementation() + "）", 5, [&] {
+            do_not_optimize(Sha256::hash(buffer.data(), buffer.size()));
+        });
+        std::printf("  %s: %.2f GB/s\n", Sha256::implementation(), BUFFER_BYTES / ns);
+    }
+    Sha256::force_portable(false);
+
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < FILE_COUNT; ++i) {
+        paths.push_back("/tmp/sha256_bench_" + std::to_string(i) + ".bin");
+        int fd = open(paths.back().c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+        for (size_t written = 0; written < FILE_BYTES; written += BUFFER_BYTES) {
+            if (write(fd, buffer.data(), std::min(BUFFER_BYTES, FILE_BYTES - written)) < 0) break;
+        }
+        close(fd);
+    }
+    const double total_gb = FILE_COUNT * FILE_BYTES / 1e9;
+
+    // 先各读一遍使文件进入页缓存，之后只比较计算路径
+    hash_files(paths, 1);
+
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& path : paths) do_not_optimize(hash_with_read(path));
+    std::printf("read + 1 MiB 缓冲，单线程（%s）:   %.2f GB/s\n", accelerated, total_gb / seconds_since(start));
+
+    std::printf("mmap，单线程（%s）:               %.2f GB/s\n", accelerated, total_gb / hash_files(paths, 1));
+    const size_t threads = std::min<size_t>(FILE_COUNT, std::max(1u, std::thread::hardware_concurrency()));
+    std::printf("mmap，%zu 线程并行（%s）:           %.2f GB/s\n", threads, accelerated,
+                total_gb / hash_files(paths, threads));
+
+    for (const auto& path : paths) unlink(path.c_str());
+    return 0;
+}
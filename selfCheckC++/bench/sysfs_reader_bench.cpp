@@ -0,0 +1,62 @@
+// sysfs 采样基准：比较每次 fs::exists + ifstream 解析与常驻 fd + pread 的采样速率
+#include "bench_utils.h"
+#include "sysfs_reader.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// 旧实现：每次采样都检查路径、构造 ifstream 并用 iostream 解析
+long legacy_read(const std::vector<std::string>& candidates) {
+    for (const auto& path : candidates) {
+        if (fs::exists(path)) {
+            std::ifstream file(path);
+            if (file.is_open()) {
+                long value = -1;
+                file >> value;
+                return value;
+            }
+        }
+    }
+    return -1;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    // 默认使用 GPU 频率节点，开发机上回退到任意存在的数值型节点
+    std::vector<std::string> candidates = {
+        "/sys/class/devfreq/fb000000.gpu/cur_freq",
+        "/sys/class/thermal/thermal_zone0/temp",
+        "/sys/devices/system/cpu/cpu0/cpufreq/scaling_cur_freq",
+        "/proc/sys/kernel/pid_max"
+    };
+    if (argc > 1) {
+        candidates.assign(argv + 1, argv + argc);
+    }
+
+    SysfsReader reader(candidates);
+    if (!reader.is_open()) {
+        std::fprintf(stderr, "没有可读取的候选节点\n");
+        return 1;
+    }
+    std::printf("采样节点: %s\n", reader.path().c_str());
+
+    const long iterations = 200000;
+    double legacy = run_benchmark("fs::exists + ifstream", iterations, [&] {
+        long value = legacy_read(candidates);
+        do_not_optimize(value);
+    });
+    double pread_ns = run_benchmark("SysfsReader::read_long (pread)", iterations, [&] {
+        long value = 0;
+        reader.read_long(value);
+        do_not_optimize(value);
+    });
+
+    std::printf("加速比: %.1fx\n", legacy / pread_ns);
+    return 0;
+}
@@ -0,0 +1,122 @@
+// 线程放置干扰基准：子进程在最后一个 CPU（RK3588 上为 A76 大核）上忙循环，模拟 VO；
+// 父进程启动与在线 CPU 数相同的“服务线程”（2 ms 计算 / 2 ms 休眠），
+// 分别在不限制、绑定到其余 CPU、SCHED_IDLE 三种放置下统计替身的吞吐与最长被抢占间隔
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <sched.h>
+#include <sys/wait.h>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+constexpr int PHASE_MS = 2000;
+constexpr int BURST_US = 2000;
+
+enum class Placement { NONE, UNPINNED, PINNED, IDLE };
+
+int64_t now_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+void pin_to(const std::vector<int>& cpus) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) CPU_SET(cpu, &set);
+    sched_setaffinity(0, sizeof(set), &set);
+}
+
+// 替身：统计固定时长内的循环次数，以及相邻两次循环之间的最大间隔（即被抢占的时长）
+void stand_in(int cpu, int result_fd) {
+    pin_to({cpu});
+    uint64_t iterations = 0;
+    int64_t max_gap = 0;
+    const int64_t end = now_ns() + PHASE_MS * 1000000LL;
+    int64_t last = now_ns();
+    while (last < end) {
+        for (volatile int i = 0; i < 1000; ++i) {}
+        int64_t now = now_ns();
+        max_gap = std::max(max_gap, now - last);
+        last = now;
+        ++iterations;
+    }
+    int64_t result[2] = {static_cast<int64_t>(iterations), max_gap};
+    if (write(result_fd, result, sizeof(result)) < 0) perror("write");
+}
+
+// 服务线程：周期性的短时计算，模拟检测与请求处理
+void server_thread(std::atomic<bool>& stop, Placement placement, const std::vector<int>& server_cpus) {
+    if (placement == Placement::PINNED) {
+        pin_to(server_cpus);
+    } else if (placement == Placement::IDLE) {
+        sched_param param{};
+        sched_setscheduler(0, SCHED_IDLE, &param);
+    }
+    while (!stop) {
+        const int64_t end = now_ns() + BURST_US * 1000LL;
+        while (now_ns() < end) {}
+        std::this_thread::sleep_for(std::chrono::microseconds(BURST_US));
+    }
+}
+
+double run_phase(const char* label, Placement placement, int stand_in_cpu,
+                 const std::vector<int>& server_cpus, int threads, double baseline) {
+    int result_pipe[2];
+    if (pipe(result_pipe) != 0) return 0;
+    pid_t child = fork();
+    if (child == 0) {
+        close(result_pipe[0]);
+        stand_in(stand_in_cpu, result_pipe[1]);
+        _exit(0);
+    }
+    close(result_pipe[1]);
+
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> workers;
+    if (placement != Placement::NONE) {
+        for (int i = 0; i < threads; ++i) {
+            workers.emplace_back(server_thread, std::ref(stop), placement, std::cref(server_cpus));
+        }
+    }
+
+    int64_t result[2] = {0, 0};
+    if (read(result_pipe[0], result, sizeof(result)) != sizeof(result)) perror("read");
+    waitpid(child, nullptr, 0);
+    stop = true;
+    for (auto& worker : workers) worker.join();
+    close(result_pipe[0]);
+
+    const double rate = static_cast<double>(result[0]) / PHASE_MS;
+    std::printf("%-22s %14.0f %9.1f%% %14.1f\n", label, rate,
+                baseline > 0 ? rate / baseline * 100 : 100.0, result[1] / 1000.0);
+    return rate;
+}
+
+} // namespace
+
+int main() {
+    const int cpus = static_cast<int>(sysconf(_SC_NPROCESSORS_ONLN));
+    const int stand_in_cpu = cpus - 1;
+    std::vector<int> server_cpus;
+    for (int cpu = 0; cpu < stand_in_cpu; ++cpu) server_cpus.push_back(cpu);
+    if (server_cpus.empty()) {
+        // 单核环境无法隔离，绑定结果等同于不限制，仅 SCHED_IDLE 有意义
+        std::printf("注意: 仅 1 个在线 CPU，绑定场景无法与替身隔离\n");
+        server_cpus.push_back(0);
+    }
+
+    std::printf("替身 CPU %d，服务线程 %d 个（%d us 计算 / %d us 休眠）\n", stand_in_cpu, cpus, BURST_US, BURST_US);
+    std::printf("%-22s %14s %10s %14s\n", "场景", "替身循环/ms", "相对基线", "最长抢占(us)");
+    const double baseline = run_phase("无服务线程", Placement::NONE, stand_in_cpu, server_cpus, cpus, 0);
+    run_phase("服务线程/不限制", Placement::UNPINNED, stand_in_cpu, server_cpus, cpus, baseline);
+    run_phase("服务线程/绑定其余CPU", Placement::PINNED, stand_in_cpu, server_cpus, cpus, baseline);
+    run_phase("服务线程/SCHED_IDLE", Placement::IDLE, stand_in_cpu, server_cpus, cpus, baseline);
+    return 0;
+}
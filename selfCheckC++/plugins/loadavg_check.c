@@ -0,0 +1,91 @@
+/*
+ * 示例检测插件：系统平均负载
+ *
+ * 读取 /proc/loadavg，1 分钟平均负载超过在线 CPU 数时给出警告。
+ * 编译后放入 system.plugin_directory 即可通过 /api/v1/check/loadavg 访问。
+ */
+
+#include "check_plugin.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+typedef struct {
+    const selfcheck_host_api* host;
+    long cpu_count;
+} loadavg_state;
+
+typedef struct {
+    double load1;
+    double load5;
+    double load15;
+    long cpu_count;
+} loadavg_payload;
+
+static int loadavg_init(const selfcheck_host_api* host, void** state) {
+    loadavg_state* s = (loadavg_state*)calloc(1, sizeof(loadavg_state));
+    if (!s) return -1;
+    s->host = host;
+    s->cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+    if (s->cpu_count <= 0) s->cpu_count = 1;
+    *state = s;
+    return 0;
+}
+
+static void loadavg_shutdown(void* state) {
+    free(state);
+}
+
+static int loadavg_run(void* state, selfcheck_run_result* result) {
+    loadavg_state* s = (loadavg_state*)state;
+    loadavg_payload* p = (loadavg_payload*)malloc(sizeof(loadavg_payload));
+    if (!p) return -1;
+
+    FILE* file = fopen("/proc/loadavg", "r");
+    if (!file || fscanf(file, "%lf %lf %lf", &p->load1, &p->load5, &p->load15) != 3) {
+        if (file) fclose(file);
+        free(p);
+        s->host->log(SELFCHECK_LOG_ERROR, "无法读取 /proc/loadavg");
+        return -1;
+    }
+    fclose(file);
+
+    p->cpu_count = s->cpu_count;
+    result->payload = p;
+    result->status = p->load1 > (double)s->cpu_count ? SELFCHECK_STATUS_WARNING : SELFCHECK_STATUS_SUCCESS;
+    return 0;
+}
+
+static size_t loadavg_serialize(void* state, const selfcheck_run_result* result, char* buffer, size_t capacity) {
+    (void)state;
+    const loadavg_payload* p = (const loadavg_payload*)result->payload;
+    int n = snprintf(buffer, capacity, "平均负载: %.2f %.2f %.2f (CPU数: %ld)",
+                     p->load1, p->load5, p->load15, p->cpu_count);
+    return n < 0 ? 0 : (size_t)n;
+}
+
+static void loadavg_release(void* state, selfcheck_run_result* result) {
+    (void)state;
+    free(result->payload);
+    result->payload = NULL;
+}
+
+static const selfcheck_check_descriptor DESCRIPTOR = {
+    SELFCHECK_PLUGIN_ABI_VERSION,
+    "loadavg",
+    "系统平均负载检测",
+    500,
+    SELFCHECK_COST_CHEAP,
+    0,
+    NULL,
+    loadavg_init,
+    loadavg_shutdown,
+    loadavg_run,
+    loadavg_serialize,
+    loadavg_release
+};
+
+const selfcheck_check_descriptor* selfcheck_plugin_descriptor(void) {
+    return &DESCRIPTOR;
+}
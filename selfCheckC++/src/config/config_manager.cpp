@@ -3,6 +3,7 @@
 #include "logger.h"
 #include <nlohmann/json.hpp>
 #include <fstream>
+#include <algorithm>
 
 using json = nlohmann::json;
 
@@ -150,4 +151,54 @@ std::string ConfigManager::get_image_directory() {
         // 忽略错误
     }
     return "images/"; // 默认目录
-}
\ No newline at end of file
+}
+
+YAML::Node ConfigManager::get_system_config() {
+    try {
+        auto yaml = YAML::Load(config_store["main"]);
+        if (yaml["system"] && yaml["system"].IsMap()) {
+            return yaml["system"];
+        }
+    } catch (...) {
+        // 忽略错误
+    }
+    return YAML::Node();
+}
+
+namespace {
+
+void walk_scalars(const YAML::Node& node, const std::string& path,
+                  const std::function<void(const std::string&, const std::string&)>& fn) {
+    if (node.IsMap()) {
+        for (const auto& item : node) {
+            const std::string key = item.first.as<std::string>("");
+            walk_scalars(item.second, path.empty() ? key : path + "." + key, fn);
+        }
+    } else if (node.IsSequence()) {
+        for (size_t i = 0; i < node.size(); ++i) {
+            walk_scalars(node[i], path + "[" + std::to_string(i) + "]", fn);
+        }
+    } else if (node.IsScalar()) {
+        fn(path, node.Scalar());
+    }
+}
+
+} // namespace
+
+void ConfigManager::for_each_config_value(
+    const std::function<void(const std::string&, const std::string&, const std::string&)>& fn) {
+    std::vector<std::string> names = get_config_files();
+    std::sort(names.begin(), names.end());
+    for (const auto& name : names) {
+        YAML::Node root;
+        try {
+            root = YAML::Load(get_current_config(name));
+        } catch (const std::exception& e) {
+            Logger::warning("解析配置 " + name + " 失败: " + e.what());
+            continue;
+        }
+        walk_scalars(root, "", [&](const std::string& key, const std::string& value) {
+            fn(name, key, value);
+        });
+    }
+}
@@ -9,6 +9,7 @@
 #include "config_parser.h"
 #include <unordered_map>
 #include <map>
+#include <functional>
 
 class ConfigManager {
     public:
@@ -42,6 +43,14 @@ class ConfigManager {
         
         // 获取图片目录（从配置文件中）
         static std::string get_image_directory();
+        
+        // 获取主配置中的 system 节点（不存在时返回空节点）
+        static YAML::Node get_system_config();
+        
+        // 按文件名顺序遍历已加载配置中的每个字符串值，调用 fn(配置名, 配置项路径, 值)；
+        // 配置项路径形如 "DMatcher.dfeature_model_path.path_00"，注释中的内容不会被遍历
+        static void for_each_config_value(
+            const std::function<void(const std::string&, const std::string&, const std::string&)>& fn);
     
     private:
         // 配置文件路径映射
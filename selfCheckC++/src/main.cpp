@@ -8,6 +8,22 @@
 #include "config/config_manager.h"
 #include "network/request_handler.h"
 #include "system/system_check.h"
+#include "system/check_scheduler.h"
+#include "system/check_registry.h"
+#include "system/cpu_monitor.h"
+#include "system/gpu_monitor.h"
+#include "system/interrupt_monitor.h"
+#include "system/kernel_log_monitor.h"
+#include "system/usb_topology.h"
+#include "system/network_monitor.h"
+#include "system/storage_monitor.h"
+#include "system/load_shedder.h"
+#include "system/memory_monitor.h"
+#include "system/process_monitor.h"
+#include "system/process_table.h"
+#include "system/thermal_monitor.h"
+#include "system/thread_placement.h"
+#include "system/metric_sampler.h"
 #include "types/common_types.h"
 #include "utils/logger.h"
 
@@ -21,6 +37,36 @@ int main(int argc, char* argv[]) {
     // 初始化配置管理器
     ConfigManager::initialize();
     
+    // 解析 sysfs/procfs 节点
+    SystemCheck::initialize();
+    
+    // 注册内置检测并加载检测插件
+    YAML::Node system_config = ConfigManager::get_system_config();
+    CheckRegistry::initialize(system_config["plugin_directory"].as<std::string>("plugins"));
+    
+    // 注册后台采样任务并启动采样线程
+    CpuMonitor::initialize();
+    
+    // 按 CPU 拓扑放置线程；之后创建的线程继承主线程的亲和性
+    ThreadPlacement::initialize();
+    ThreadPlacement::apply(ThreadRole::SERVER);
+    
+    GpuMonitor::initialize();
+    ThermalMonitor::initialize();
+    MemoryMonitor::initialize();
+    ProcessMonitor::initialize();
+    ProcessTable::initialize();
+    InterruptMonitor::initialize();
+    StorageMonitor::initialize();
+    NetworkMonitor::initialize();
+    KernelLogMonitor::initialize();
+    UsbTopology::initialize();
+    LoadShedder::initialize();
+    MetricSampler::start();
+    
+    // 初始化批量检测线程池
+    CheckScheduler::initialize(system_config["check_workers"].as<size_t>(4));
+    
     // 设置固定端口
     const int SERVER_PORT = 8080; // 使用固定端口 8080
     Logger::info("服务器端口: " + to_string(SERVER_PORT));
@@ -74,6 +120,27 @@ int main(int argc, char* argv[]) {
     Logger::info("  GPU频率:       http://" + string(ip_str) + ":" + to_string(SERVER_PORT) + "/api/v1/check/gpu");
     Logger::info("  串口设备状态:  http://" + string(ip_str) + ":" + to_string(SERVER_PORT) + "/api/v1/check/serial");
     Logger::info("  相机设备状态:  http://" + string(ip_str) + ":" + to_string(SERVER_PORT) + "/api/v1/check/camera");
+    Logger::info("  检测项列表:    http://" + string(ip_str) + ":" + to_string(SERVER_PORT) + "/api/v1/check");
+    Logger::info("  批量检测:      http://" + string(ip_str) + ":" + to_string(SERVER_PORT) + "/api/v1/check/all?checks=ssh,memory&stream=1");
+    Logger::info("  CPU状态:       http://" + string(ip_str) + ":" + to_string(SERVER_PORT) + "/api/v1/check/cpu");
+    Logger::info("  温度状态:      http://" + string(ip_str) + ":" + to_string(SERVER_PORT) + "/api/v1/check/thermal");
+    Logger::info("  负载状态:      http://" + string(ip_str) + ":" + to_string(SERVER_PORT) + "/api/v1/check/load");
+    Logger::info("  飞控进程:      http://" + string(ip_str) + ":" + to_string(SERVER_PORT) + "/api/v1/check/processes");
+    Logger::info("  中断状态:      http://" + string(ip_str) + ":" + to_string(SERVER_PORT) + "/api/v1/check/interrupts");
+    Logger::info("  存储状态:      http://" + string(ip_str) + ":" + to_string(SERVER_PORT) + "/api/v1/check/storage");
+    Logger::info("  存储读写探测:  http://" + string(ip_str) + ":" + to_string(SERVER_PORT) + "/api/v1/check/storage_probe");
+    Logger::info("  网络状态:      http://" + string(ip_str) + ":" + to_string(SERVER_PORT) + "/api/v1/check/network");
+    Logger::info("  IPC端点状态:   http://" + string(ip_str) + ":" + to_string(SERVER_PORT) + "/api/v1/check/ipc");
+    Logger::info("  模型文件校验:  http://" + string(ip_str) + ":" + to_string(SERVER_PORT) + "/api/v1/check/models");
+    Logger::info("  CAN总线状态:   http://" + string(ip_str) + ":" + to_string(SERVER_PORT) + "/api/v1/check/can");
+    Logger::info("  内核日志:      http://" + string(ip_str) + ":" + to_string(SERVER_PORT) + "/api/v1/check/kernel");
+    Logger::info("  USB拓扑:       http://" + string(ip_str) + ":" + to_string(SERVER_PORT) + "/api/v1/check/usb");
+    Logger::info("  串口回环测试:  http://" + string(ip_str) + ":" + to_string(SERVER_PORT) + "/api/v1/check/serial_loopback");
+    Logger::info("  串口数据流:    http://" + string(ip_str) + ":" + to_string(SERVER_PORT) + "/api/v1/check/serial_stream");
+    Logger::info("  调度延迟测量:  http://" + string(ip_str) + ":" + to_string(SERVER_PORT) + "/api/v1/check/latency");
+    Logger::info("  硬件自测:      http://" + string(ip_str) + ":" + to_string(SERVER_PORT) + "/api/v1/check/hardware");
+    Logger::info("  事件推送(SSE): http://" + string(ip_str) + ":" + to_string(SERVER_PORT) + "/api/v1/events");
+    Logger::info("  指标序列:      http://" + string(ip_str) + ":" + to_string(SERVER_PORT) + "/api/v1/metrics");
     Logger::info("  获取图片列表:  http://" + string(ip_str) + ":" + to_string(SERVER_PORT) + "/api/v1/image");
     
     // 主循环
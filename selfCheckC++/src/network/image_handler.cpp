@@ -1,5 +1,7 @@
 #include "image_handler.h"
 #include "../config/config_manager.h"
+#include "../system/load_shedder.h"
+#include "../system/thread_placement.h"
 #include "../utils/file_utils.h"
 #include "../utils/logger.h"
 #include <sys/stat.h>
@@ -121,6 +123,9 @@ void ImageHandler::send_image_response(int client_socket, const std::string& ima
     std::string header = header_oss.str();
     send(client_socket, header.c_str(), header.size(), 0);
     
+    // 连接线程在发送完成后即退出，直接切换为图片传输的调度策略
+    ThreadPlacement::apply(ThreadRole::IMAGE_TRANSFER);
+    
     // 发送文件内容
     std::ifstream file(image_path, std::ios::binary);
     if (!file) {
@@ -136,6 +141,8 @@ void ImageHandler::send_image_response(int client_socket, const std::string& ima
         std::streamsize bytes_read = file.gcount();
         
         if (bytes_read > 0) {
+            // 降载期间按令牌桶限速，避免与飞控进程争抢 CPU 与内存带宽
+            LoadShedder::throttle_image(static_cast<size_t>(bytes_read));
             ssize_t bytes_sent = send(client_socket, buffer, bytes_read, 0);
             if (bytes_sent < 0) {
                 Logger::error("发送图片数据中断: " + std::string(strerror(errno)));
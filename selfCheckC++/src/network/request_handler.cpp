@@ -1,6 +1,11 @@
 #include "request_handler.h"
 #include "image_handler.h"
 #include "../system/system_check.h"
+#include "../system/check_scheduler.h"
+#include "../system/check_registry.h"
+#include "../system/metric_sampler.h"
+#include "../system/event_bus.h"
+#include "../system/load_shedder.h"
 #include "../config/config_manager.h"
 #include "../utils/logger.h"
 #include <sstream>
@@ -11,6 +16,8 @@
 #include <nlohmann/json.hpp>
 #include <arpa/inet.h>
 #include <map>
+#include <chrono>
+#include <cstdlib>
 
 using json = nlohmann::json;
 
@@ -83,6 +90,22 @@ void RequestHandler::process_request(int client_socket, const std::string& reque
         return;
     }
     
+    // 降载期间拒绝非关键请求，检测接口照常应答
+    // 按去掉查询串的路径判断，否则 /api/v1/check/<name>?... 查不到检测定义而被当作关键请求
+    if (LoadShedder::shedding() && !LoadShedder::is_critical_request(path.substr(0, path.find('?')))) {
+        std::string response =
+            "HTTP/1.1 503 Service Unavailable\r\n"
+            "Content-Type: application/json\r\n"
+            "Retry-After: " + std::to_string(LoadShedder::retry_after_seconds()) + "\r\n"
+            "Access-Control-Allow-Origin: *\r\n"
+            "Access-Control-Expose-Headers: Retry-After\r\n"
+            "Connection: close\r\n\r\n"
+            "{\"error\":\"Server is shedding load, retry later\"}";
+        ::send(client_socket, response.c_str(), response.size(), MSG_NOSIGNAL);
+        Logger::info("降载中，拒绝非关键请求: " + path);
+        return;
+    }
+    
     // 提取请求体
     std::string body;
     size_t body_start = request.find("\r\n\r\n");
@@ -169,7 +192,236 @@ void RequestHandler::handle_post_request(int client_socket, const std::string& p
     }
 }
 
-void RequestHandler::handle_get_request(int client_socket, const std::string& path) {
+std::string RequestHandler::split_query(const std::string& target, std::map<std::string, std::string>& query) {
+    size_t question = target.find('?');
+    if (question == std::string::npos) {
+        return target;
+    }
+    
+    std::istringstream params(target.substr(question + 1));
+    std::string pair;
+    while (std::getline(params, pair, '&')) {
+        if (pair.empty()) continue;
+        size_t eq = pair.find('=');
+        if (eq == std::string::npos) {
+            query[pair] = "";
+        } else {
+            query[pair.substr(0, eq)] = pair.substr(eq + 1);
+        }
+    }
+    return target.substr(0, question);
+}
+
+void RequestHandler::handle_batch_check(int client_socket, const std::map<std::string, std::string>& query) {
+    // 选择要执行的检测项，默认执行全部
+    std::vector<std::string> names;
+    auto checks_it = query.find("checks");
+    if (checks_it != query.end() && !checks_it->second.empty()) {
+        std::istringstream list(checks_it->second);
+        std::string name;
+        while (std::getline(list, name, ',')) {
+            if (!name.empty() && std::find(names.begin(), names.end(), name) == names.end()) {
+                names.push_back(name);
+            }
+        }
+    } else {
+        for (const auto& def : CheckRegistry::get_definitions()) {
+            if (!def.on_demand) names.push_back(def.name);
+        }
+    }
+    
+    int timeout_ms = 0;
+    if (auto it = query.find("timeout_ms"); it != query.end()) {
+        timeout_ms = std::atoi(it->second.c_str());
+    }
+    
+    bool stream = false;
+    if (auto it = query.find("stream"); it != query.end()) {
+        stream = (it->second == "1" || it->second == "true");
+    }
+    
+    auto outcome_to_json = [](const CheckOutcome& outcome) {
+        json j = json::parse(SystemCheck::create_json_response(outcome.result));
+        j["name"] = outcome.name;
+        j["state"] = CheckScheduler::state_to_string(outcome.state);
+        j["started_ms"] = outcome.started_ms;
+        j["elapsed_ms"] = outcome.elapsed_ms;
+        return j;
+    };
+    auto dump = [](const json& j) {
+        return j.dump(-1, ' ', false, json::error_handler_t::replace);
+    };
+    
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed_ms = [&start] {
+        return static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count());
+    };
+    
+    if (stream) {
+        // 流式输出：每完成一个检测项写出一行JSON（NDJSON），连接关闭即表示结束
+        const std::string header =
+            "HTTP/1.1 200 OK\r\n"
+            "Content-Type: application/x-ndjson\r\n"
+            "Cache-Control: no-cache\r\n"
+            "Access-Control-Allow-Origin: *\r\n"
+            "Connection: close\r\n\r\n";
+        if (::send(client_socket, header.c_str(), header.size(), MSG_NOSIGNAL) < 0) {
+            Logger::error("发送批量检测响应头失败: " + std::string(strerror(errno)));
+            return;
+        }
+        
+        auto outcomes = CheckScheduler::run_batch(names, timeout_ms, [client_socket, &outcome_to_json, &dump](const CheckOutcome& outcome) {
+            std::string line = dump(outcome_to_json(outcome)) + "\n";
+            if (::send(client_socket, line.c_str(), line.size(), MSG_NOSIGNAL) < 0) {
+                Logger::error("发送检测结果失败: " + std::string(strerror(errno)));
+            }
+        });
+        
+        std::string summary = dump(json{
+            {"done", true},
+            {"status", CheckScheduler::overall_status(outcomes)},
+            {"elapsed_ms", elapsed_ms()}
+        }) + "\n";
+        ::send(client_socket, summary.c_str(), summary.size(), MSG_NOSIGNAL);
+        return;
+    }
+    
+    auto outcomes = CheckScheduler::run_batch(names, timeout_ms);
+    json results = json::array();
+    for (const auto& outcome : outcomes) {
+        results.push_back(outcome_to_json(outcome));
+    }
+    json response_json = {
+        {"status", CheckScheduler::overall_status(outcomes)},
+        {"elapsed_ms", elapsed_ms()},
+        {"results", results}
+    };
+    
+    std::string response = HTTP_OK_HEADER + dump(response_json);
+    ssize_t sent = ::send(client_socket, response.c_str(), response.size(), MSG_NOSIGNAL);
+    if (sent < 0) {
+        Logger::error("发送批量检测结果失败: " + std::string(strerror(errno)));
+    }
+}
+
+void RequestHandler::handle_metrics_request(int client_socket, const std::string& path, const std::map<std::string, std::string>& query) {
+    const std::string prefix = "/api/v1/metrics/";
+    json response_json;
+    
+    if (path.compare(0, prefix.size(), prefix) == 0 && path.size() > prefix.size()) {
+        std::string name = path.substr(prefix.size());
+        auto series = MetricSampler::get_series(name);
+        if (!series) {
+            std::string response = HTTP_NOT_FOUND + json{{"error", "Metric not found: " + name}}.dump();
+            ::send(client_socket, response.c_str(), response.size(), MSG_NOSIGNAL);
+            return;
+        }
+        
+        // 默认返回最近 60 秒
+        int seconds = 60;
+        if (auto it = query.find("seconds"); it != query.end()) {
+            seconds = std::max(1, std::atoi(it->second.c_str()));
+        }
+        json points = json::array();
+        for (const auto& point : series->snapshot(MetricSampler::now_ms() - seconds * 1000LL)) {
+            points.push_back({point.timestamp_ms, point.value});
+        }
+        response_json = {{"name", name}, {"points", points}};
+    } else {
+        json series_list = json::array();
+        for (const auto& name : MetricSampler::series_names()) {
+            auto series = MetricSampler::get_series(name);
+            MetricPoint latest{0, 0.0};
+            if (!series || !series->latest(latest)) continue;
+            series_list.push_back({
+                {"name", name},
+                {"latest", latest.value},
+                {"timestamp_ms", latest.timestamp_ms},
+                {"count", series->size()}
+            });
+        }
+        response_json = {{"series", series_list}};
+    }
+    
+    std::string response = HTTP_OK_HEADER + response_json.dump();
+    ssize_t sent = ::send(client_socket, response.c_str(), response.size(), MSG_NOSIGNAL);
+    if (sent < 0) {
+        Logger::error("发送指标数据失败: " + std::string(strerror(errno)));
+    }
+}
+
+void RequestHandler::handle_events_request(int client_socket, const std::map<std::string, std::string>& query) {
+    // 默认只推送连接之后的事件；after=N 可补发编号大于 N 的历史事件
+    uint64_t last_id = EventBus::latest_id();
+    if (auto it = query.find("after"); it != query.end()) {
+        last_id = std::strtoull(it->second.c_str(), nullptr, 10);
+    }
+    
+    const std::string header =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/event-stream\r\n"
+        "Cache-Control: no-cache\r\n"
+        "Access-Control-Allow-Origin: *\r\n"
+        "Connection: close\r\n\r\n"
+        "retry: 3000\n\n";
+    if (::send(client_socket, header.c_str(), header.size(), MSG_NOSIGNAL) < 0) {
+        Logger::error("发送事件流响应头失败: " + std::string(strerror(errno)));
+        return;
+    }
+    Logger::info("事件订阅连接已建立");
+    
+    // 每 15 秒无事件时发送注释行保活，同时借此发现已断开的客户端
+    while (true) {
+        std::string chunk;
+        for (const auto& event : EventBus::wait_after(last_id, std::chrono::seconds(15))) {
+            json data = {
+                {"id", event.id},
+                {"timestamp_ms", event.timestamp_ms},
+                {"source", event.source},
+                {"status", event.status},
+                {"message", event.message}
+            };
+            if (!event.details.empty()) {
+                data["details"] = json::parse(event.details, nullptr, false);
+            }
+            chunk += "id: " + std::to_string(event.id) + "\n"
+                     "event: " + event.source + "\n"
+                     "data: " + data.dump(-1, ' ', false, json::error_handler_t::replace) + "\n\n";
+            last_id = event.id;
+        }
+        if (chunk.empty()) {
+            chunk = ": keepalive\n\n";
+        }
+        if (::send(client_socket, chunk.c_str(), chunk.size(), MSG_NOSIGNAL) < 0) {
+            break;
+        }
+    }
+    Logger::info("事件订阅连接已断开");
+}
+
+void RequestHandler::handle_get_request(int client_socket, const std::string& target) {
+    std::map<std::string, std::string> query;
+    std::string path = split_query(target, query);
+    
+    // 批量检测
+    if (path == "/api/v1/check/all") {
+        handle_batch_check(client_socket, query);
+        return;
+    }
+    
+    // 监控事件推送
+    if (path == "/api/v1/events") {
+        handle_events_request(client_socket, query);
+        return;
+    }
+    
+    // 指标时间序列
+    if (path.find("/api/v1/metrics") == 0) {
+        handle_metrics_request(client_socket, path, query);
+        return;
+    }
+    
     // 配置文件列表
     if (path == "/api/v1/config/files") {
         std::vector<std::string> files = ConfigManager::get_config_files();
@@ -212,18 +464,40 @@ void RequestHandler::handle_get_request(int client_socket, const std::string& pa
         return;
     }
     
-    // 系统检查端点
+    // 已注册检测项列表（内置 + 插件）
+    if (path == "/api/v1/check" || path == "/api/v1/check/") {
+        json checks = json::array();
+        for (const auto& def : CheckRegistry::get_definitions()) {
+            checks.push_back({
+                {"name", def.name},
+                {"timeout_ms", def.timeout_ms},
+                {"depends_on", def.depends_on},
+                {"source", def.source},
+                {"on_demand", def.on_demand}
+            });
+        }
+        std::string response = HTTP_OK_HEADER + json{{"checks", checks}}.dump();
+        ssize_t sent = ::send(client_socket, response.c_str(), response.size(), 0);
+        if (sent < 0) {
+            Logger::error("发送检测项列表失败: " + std::string(strerror(errno)));
+        }
+        return;
+    }
+    
+    // 系统检查端点：/api/v1/check/{name}，由注册表查找（含插件）
     SystemCheckResult result;
-    if (path == "/api/v1/check/ssh") {
-        result = SystemCheck::check_ssh_connection();
-    } else if (path == "/api/v1/check/memory") {
-        result = SystemCheck::check_memory_usage();
-    } else if (path == "/api/v1/check/gpu") {
-        result = SystemCheck::check_gpu_frequency();
-    } else if (path == "/api/v1/check/serial") {
-        result = SystemCheck::check_serial_devices();
-    } else if (path == "/api/v1/check/camera") {
-        result = SystemCheck::check_camera_devices();
+    const std::string check_prefix = "/api/v1/check/";
+    const CheckDefinition* check = nullptr;
+    if (path.compare(0, check_prefix.size(), check_prefix) == 0) {
+        check = CheckRegistry::find(path.substr(check_prefix.size()));
+    }
+    
+    if (check) {
+        // 与批量检测一样经调度器执行：共享全进程的重型检测槽位，超时后取消
+        const std::string name = check->name;
+        for (const auto& outcome : CheckScheduler::run_batch({name}, check->timeout_ms)) {
+            if (outcome.name == name) result = outcome.result;
+        }
     } else if (path == "/") {
         const char* response = "HTTP/1.1 200 OK\r\n"
                                "Content-Type: application/json\r\n"
@@ -2,6 +2,7 @@
 #define REQUEST_HANDLER_H
 
 #include <string>
+#include <map>
 
 class RequestHandler {
 public:
@@ -10,7 +11,19 @@ private:
     static void process_request(int client_socket, const std::string& request);
     static void handle_options_request(int client_socket);
     static void handle_post_request(int client_socket, const std::string& path, const std::string& body);
-    static void handle_get_request(int client_socket, const std::string& path);
+    static void handle_get_request(int client_socket, const std::string& target);
+    
+    // 批量检测：按依赖图并发执行多个检测项，一次性或流式返回结果
+    static void handle_batch_check(int client_socket, const std::map<std::string, std::string>& query);
+    
+    // 指标时间序列查询：/api/v1/metrics 与 /api/v1/metrics/{name}
+    static void handle_metrics_request(int client_socket, const std::string& path, const std::map<std::string, std::string>& query);
+    
+    // 事件推送：/api/v1/events，以 Server-Sent Events 持续推送监控告警
+    static void handle_events_request(int client_socket, const std::map<std::string, std::string>& query);
+    
+    // 拆分请求路径与查询参数
+    static std::string split_query(const std::string& target, std::map<std::string, std::string>& query);
     
     // 添加 HTTP 响应头声明
     static const std::string HTTP_OK_HEADER;
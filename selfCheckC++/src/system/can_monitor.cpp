@@ -0,0 +1,326 @@
+#include "can_monitor.h"
+#include "../config/config_manager.h"
+#include "../utils/logger.h"
+#include "../utils/monotonic_clock.h"
+#include "../utils/sysfs_reader.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <dirent.h>
+#include <linux/can.h>
+#include <linux/can/error.h>
+#include <linux/can/raw.h>
+#include <net/if.h>
+#include <net/if_arp.h>
+#include <nlohmann/json.hpp>
+#include <poll.h>
+#include <sstream>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <unordered_map>
+
+namespace {
+
+// 单次 recvmmsg 最多接收的帧数；1 Mbit/s 满载约 8000 帧/秒，一次系统调用可取走数毫秒的积压
+constexpr unsigned int RECV_BATCH = 64;
+constexpr int SOCKET_RCVBUF_BYTES = 1 << 20;
+
+const char* const STAT_NAMES[] = {"rx_errors", "tx_errors", "rx_dropped", "tx_dropped"};
+constexpr size_t STAT_COUNT = sizeof(STAT_NAMES) / sizeof(STAT_NAMES[0]);
+
+bool read_text(const std::string& path, std::string& text) {
+    char buffer[64];
+    SysfsReader reader({path});
+    const ssize_t n = reader.read(buffer, sizeof(buffer) - 1);
+    if (n <= 0) return false;
+    text.assign(buffer, static_cast<size_t>(n));
+    while (!text.empty() && (text.back() == '\n' || text.back() == ' ')) text.pop_back();
+    return true;
+}
+
+struct ErrorCounts {
+    uint64_t frames = 0;
+    uint64_t bus_off = 0;
+    uint64_t error_passive = 0;
+    uint64_t error_warning = 0;
+    uint64_t bus_errors = 0;       // 协议错误（位错误、填充错误、格式错误等）
+    uint64_t no_ack = 0;
+    uint64_t overflow = 0;         // 控制器收发缓冲溢出
+    uint64_t restarted = 0;
+
+    void add(const canfd_frame& frame) {
+        const canid_t classes = frame.can_id & CAN_ERR_MASK;
+        ++frames;
+        if (classes & CAN_ERR_BUSOFF) ++bus_off;
+        if (classes & (CAN_ERR_PROT | CAN_ERR_BUSERROR)) ++bus_errors;
+        if (classes & CAN_ERR_ACK) ++no_ack;
+        if (classes & CAN_ERR_RESTARTED) ++restarted;
+        if (classes & CAN_ERR_CRTL) {
+            const uint8_t status = frame.data[1];
+            if (status & (CAN_ERR_CRTL_RX_PASSIVE | CAN_ERR_CRTL_TX_PASSIVE)) ++error_passive;
+            if (status & (CAN_ERR_CRTL_RX_WARNING | CAN_ERR_CRTL_TX_WARNING)) ++error_warning;
+            if (status & (CAN_ERR_CRTL_RX_OVERFLOW | CAN_ERR_CRTL_TX_OVERFLOW)) ++overflow;
+        }
+    }
+};
+
+struct Bus {
+    std::string name;
+    int ifindex = 0;
+    bool present = false;
+    bool up = false;
+    bool carrier = false;
+    std::vector<SysfsReader> stats;     // 与 STAT_NAMES 对应
+    long stats_before[STAT_COUNT] = {};
+    long stats_delta[STAT_COUNT] = {};
+    uint64_t frames = 0;
+    uint64_t fd_frames = 0;
+    uint64_t extended_frames = 0;
+    uint64_t bits = 0;
+    std::unordered_map<canid_t, uint64_t> ids;   // 键包含 CAN_EFF_FLAG，区分同值的标准帧与扩展帧
+    ErrorCounts errors;
+};
+
+void read_state(Bus& bus) {
+    const std::string base = "/sys/class/net/" + bus.name + "/";
+    std::string text;
+    bus.present = read_text(base + "flags", text);
+    if (!bus.present) return;
+    bus.up = (std::strtoul(text.c_str(), nullptr, 16) & IFF_UP) != 0;
+    // 接口 down 时读取 carrier 返回 EINVAL
+    bus.carrier = read_text(base + "carrier", text) && text == "1";
+}
+
+std::string format_id(canid_t id) {
+    char buffer[16];
+    if (id & CAN_EFF_FLAG) {
+        snprintf(buffer, sizeof(buffer), "0x%08X", id & CAN_EFF_MASK);
+    } else {
+        snprintf(buffer, sizeof(buffer), "0x%03X", id & CAN_SFF_MASK);
+    }
+    return buffer;
+}
+
+} // namespace
+
+uint32_t CanMonitor::frame_bits(bool extended, bool remote, size_t length, bool fd) {
+    const uint32_t data_bits = remote ? 0 : static_cast<uint32_t>(length) * 8;
+    uint32_t stuffed;      // 参与位填充的区段：帧起始到 CRC
+    uint32_t trailer;      // CRC 界定符、应答、帧结束与帧间隔，不填充
+    if (!fd) {
+        stuffed = (extended ? 54 : 34) + data_bits;
+        trailer = 1 + 2 + 7 + 3;
+    } else {
+        // FD 帧头多出 FDF/res/BRS/ESI 位，CRC 为 17/21 位另加 4 位填充计数；CRC 段为固定填充
+        const uint32_t crc = length <= 16 ? 17 : 21;
+        stuffed = (extended ? 41 : 22) + data_bits;
+        trailer = 4 + crc + crc / 4 + 1 + 2 + 7 + 3;
+    }
+    return stuffed + (stuffed - 1) / 4 + trailer;
+}
+
+std::vector<std::string> CanMonitor::interfaces() {
+    YAML::Node config = ConfigManager::get_system_config();
+    std::vector<std::string> names;
+    if (config["can_interfaces"] && config["can_interfaces"].IsSequence() && config["can_interfaces"].size() > 0) {
+        for (const auto& node : config["can_interfaces"]) names.push_back(node.as<std::string>());
+        return names;
+    }
+    DIR* dir = ::opendir("/sys/class/net");
+    if (!dir) return names;
+    while (dirent* entry = ::readdir(dir)) {
+        if (entry->d_name[0] == '.') continue;
+        std::string type;
+        if (read_text(std::string("/sys/class/net/") + entry->d_name + "/type", type) &&
+            std::atoi(type.c_str()) == ARPHRD_CAN) {
+            names.push_back(entry->d_name);
+        }
+    }
+    ::closedir(dir);
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+SystemCheckResult CanMonitor::check() {
+    Logger::info("执行CAN总线检测");
+
+    YAML::Node config = ConfigManager::get_system_config();
+    const int window_ms = std::clamp(config["can_window_ms"].as<int>(500), 50, 5000);
+    const double bitrate = std::max(1000.0, config["can_bitrate"].as<double>(1000000.0));
+    const double load_warn_percent = config["can_load_warn_percent"].as<double>(70.0);
+    const size_t top_ids = static_cast<size_t>(std::max(0, config["can_top_ids"].as<int>(10)));
+
+    const auto names = interfaces();
+    if (names.empty()) {
+        return {"warning", "未发现 CAN 接口（可在 system.can_interfaces 中配置）"};
+    }
+
+    std::vector<Bus> buses(names.size());
+    bool any_up = false;
+    for (size_t i = 0; i < names.size(); ++i) {
+        Bus& bus = buses[i];
+        bus.name = names[i];
+        read_state(bus);
+        if (!bus.present) continue;
+        bus.ifindex = static_cast<int>(::if_nametoindex(bus.name.c_str()));
+        for (size_t s = 0; s < STAT_COUNT; ++s) {
+            bus.stats.emplace_back(std::vector<std::string>{"/sys/class/net/" + bus.name + "/statistics/" + STAT_NAMES[s]});
+            bus.stats[s].read_long(bus.stats_before[s]);
+        }
+        any_up = any_up || bus.up;
+    }
+
+    // 一个绑定到 ifindex 0 的套接字接收全部 CAN 接口的帧，按 msg_name 中的接口号区分
+    std::string socket_error;
+    int64_t elapsed_ms = 0;
+    const int sock = any_up ? ::socket(PF_CAN, SOCK_RAW | SOCK_CLOEXEC | SOCK_NONBLOCK, CAN_RAW) : -1;
+    if (any_up && sock < 0) {
+        socket_error = std::string("无法创建 CAN 套接字: ") + strerror(errno);
+    } else if (sock >= 0) {
+        const can_err_mask_t error_mask = CAN_ERR_MASK;
+        const int enable = 1;
+        ::setsockopt(sock, SOL_CAN_RAW, CAN_RAW_ERR_FILTER, &error_mask, sizeof(error_mask));
+        ::setsockopt(sock, SOL_CAN_RAW, CAN_RAW_FD_FRAMES, &enable, sizeof(enable));
+        ::setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &SOCKET_RCVBUF_BYTES, sizeof(SOCKET_RCVBUF_BYTES));
+        sockaddr_can address{};
+        address.can_family = AF_CAN;
+        address.can_ifindex = 0;
+        if (::bind(sock, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            socket_error = std::string("绑定 CAN 套接字失败: ") + strerror(errno);
+        } else {
+            canfd_frame frames[RECV_BATCH];
+            sockaddr_can sources[RECV_BATCH];
+            iovec iov[RECV_BATCH];
+            mmsghdr messages[RECV_BATCH];
+            const int64_t start_ms = monotonic_ms();
+            const int64_t deadline_ms = start_ms + window_ms;
+            for (int64_t now = start_ms; now < deadline_ms; now = monotonic_ms()) {
+                pollfd pfd{sock, POLLIN, 0};
+                if (::poll(&pfd, 1, static_cast<int>(deadline_ms - now)) <= 0) continue;
+                for (unsigned int m = 0; m < RECV_BATCH; ++m) {
+                    iov[m] = {&frames[m], sizeof(frames[m])};
+                    messages[m] = {};
+                    messages[m].msg_hdr.msg_iov = &iov[m];
+                    messages[m].msg_hdr.msg_iovlen = 1;
+                    messages[m].msg_hdr.msg_name = &sources[m];
+                    messages[m].msg_hdr.msg_namelen = sizeof(sources[m]);
+                }
+                const int received = ::recvmmsg(sock, messages, RECV_BATCH, MSG_DONTWAIT, nullptr);
+                for (int m = 0; m < received; ++m) {
+                    auto found = std::find_if(buses.begin(), buses.end(), [&](const Bus& bus) {
+                        return bus.ifindex == sources[m].can_ifindex;
+                    });
+                    if (found == buses.end()) continue;
+                    const canfd_frame& frame = frames[m];
+                    if (frame.can_id & CAN_ERR_FLAG) {
+                        found->errors.add(frame);
+                        continue;
+                    }
+                    const bool fd = messages[m].msg_len == CANFD_MTU;
+                    const bool extended = (frame.can_id & CAN_EFF_FLAG) != 0;
+                    ++found->frames;
+                    if (fd) ++found->fd_frames;
+                    if (extended) ++found->extended_frames;
+                    found->bits += frame_bits(extended, (frame.can_id & CAN_RTR_FLAG) != 0, frame.len, fd);
+                    ++found->ids[frame.can_id & (CAN_EFF_FLAG | CAN_EFF_MASK)];
+                }
+            }
+            elapsed_ms = monotonic_ms() - start_ms;
+        }
+        ::close(sock);
+    }
+    const double seconds = std::max(1, static_cast<int>(elapsed_ms)) / 1000.0;
+
+    std::string status = "success";
+    std::ostringstream message;
+    nlohmann::json list = nlohmann::json::array();
+    auto raise = [&status](const std::string& level) {
+        if (level == "error" || status == "success") status = level;
+    };
+    for (Bus& bus : buses) {
+        nlohmann::json entry = {{"interface", bus.name}, {"present", bus.present}};
+        if (!message.str().empty()) message << "; ";
+        message << bus.name;
+        if (!bus.present) {
+            raise("error");
+            message << " 不存在";
+            list.push_back(std::move(entry));
+            continue;
+        }
+
+        // 窗口结束后再读一次状态与统计计数，窗口内发生的 bus-off 也能体现在载波上
+        read_state(bus);
+        for (size_t s = 0; s < STAT_COUNT; ++s) {
+            long after = bus.stats_before[s];
+            bus.stats[s].read_long(after);
+            bus.stats_delta[s] = after - bus.stats_before[s];
+        }
+        const double load_percent = 100.0 * bus.bits / seconds / bitrate;
+        entry["up"] = bus.up;
+        entry["carrier"] = bus.carrier;
+        entry["frames"] = bus.frames;
+        entry["frame_rate"] = bus.frames / seconds;
+        entry["fd_frames"] = bus.fd_frames;
+        entry["extended_frames"] = bus.extended_frames;
+        entry["load_percent"] = load_percent;
+        entry["distinct_ids"] = bus.ids.size();
+        entry["errors"] = {
+            {"frames", bus.errors.frames},
+            {"bus_off", bus.errors.bus_off},
+            {"error_passive", bus.errors.error_passive},
+            {"error_warning", bus.errors.error_warning},
+            {"bus_errors", bus.errors.bus_errors},
+            {"no_ack", bus.errors.no_ack},
+            {"overflow", bus.errors.overflow},
+            {"restarted", bus.errors.restarted}
+        };
+        nlohmann::json statistics;
+        for (size_t s = 0; s < STAT_COUNT; ++s) statistics[STAT_NAMES[s]] = bus.stats_delta[s];
+        entry["statistics_delta"] = statistics;
+
+        std::vector<std::pair<canid_t, uint64_t>> ranked(bus.ids.begin(), bus.ids.end());
+        std::sort(ranked.begin(), ranked.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+        if (ranked.size() > top_ids) ranked.resize(top_ids);
+        nlohmann::json ids = nlohmann::json::array();
+        for (const auto& [id, count] : ranked) {
+            ids.push_back({{"id", format_id(id)}, {"count", count}, {"rate_hz", count / seconds}});
+        }
+        entry["top_ids"] = ids;
+
+        std::vector<std::string> problems;
+        if (!bus.up) {
+            raise("error");
+            problems.push_back("接口未启用");
+        } else if (!bus.carrier || bus.errors.bus_off > 0) {
+            raise("error");
+            problems.push_back("bus-off");
+        } else if (!socket_error.empty()) {
+            raise("error");
+            problems.push_back(socket_error);
+        } else {
+            char text[96];
+            snprintf(text, sizeof(text), " %.0f 帧/s, %zu 个 ID, 负载 %.1f%%", bus.frames / seconds,
+                     bus.ids.size(), load_percent);
+            message << text;
+            if (bus.frames == 0) problems.push_back("采样窗口内无报文");
+            if (load_percent > load_warn_percent) problems.push_back("总线负载过高");
+            if (bus.errors.error_passive > 0) problems.push_back("错误被动");
+            else if (bus.errors.error_warning > 0) problems.push_back("错误警告");
+            if (bus.errors.bus_errors > 0) problems.push_back(std::to_string(bus.errors.bus_errors) + " 个总线错误帧");
+            if (bus.errors.no_ack > 0) problems.push_back("发送无应答");
+            if (bus.errors.overflow > 0 || bus.stats_delta[2] > 0) problems.push_back("接收溢出/丢弃");
+            if (bus.stats_delta[0] > 0 || bus.stats_delta[1] > 0) problems.push_back("收发错误计数增加");
+            if (!problems.empty()) raise("warning");
+        }
+        if (!problems.empty()) {
+            message << " [";
+            for (size_t p = 0; p < problems.size(); ++p) message << (p ? ", " : "") << problems[p];
+            message << "]";
+        }
+        list.push_back(std::move(entry));
+    }
+
+    nlohmann::json details = {{"window_seconds", elapsed_ms / 1000.0}, {"bitrate", bitrate}, {"interfaces", list}};
+    return {status, message.str(), details.dump()};
+}
@@ -0,0 +1,29 @@
+#ifndef CAN_MONITOR_H
+#define CAN_MONITOR_H
+
+#include "../types/common_types.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// CAN 总线检测：用一个绑定到全部 CAN 接口的 SocketCAN 原始套接字（同时接收错误帧）
+// 在采样窗口内以 recvmmsg 批量接收，按接口统计帧率、各 ID 的频率与估算的总线负载，
+// 并按类别统计错误帧（bus-off、错误被动/警告、总线错误、无应答、控制器溢出）；
+// 接口的启用状态、载波（bus-off 时内核关闭载波）与 /sys/class/net/<if>/statistics
+// 中收发错误、丢弃计数的窗口增量一并用于判断链路健康。原始套接字只获得帧的副本，
+// 不影响 ESC/云台通信进程；vcan 虚拟接口同样适用
+class CanMonitor {
+public:
+    // CAN 总线检测
+    static SystemCheckResult check();
+
+    // 配置的 CAN 接口（system.can_interfaces），未配置时返回 /sys/class/net 下全部 CAN 类型接口
+    static std::vector<std::string> interfaces();
+
+    // 一帧在总线上占用的位数（含最坏情况的位填充与帧间隔）；CAN FD 帧按仲裁段速率估算，
+    // 忽略数据段的速率切换，结果偏保守
+    static uint32_t frame_bits(bool extended, bool remote, size_t length, bool fd);
+};
+
+#endif // CAN_MONITOR_H
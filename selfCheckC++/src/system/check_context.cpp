@@ -0,0 +1,19 @@
+#include "check_context.h"
+
+thread_local CheckContext::CancelToken CheckContext::current_token;
+
+bool CheckContext::cancelled() {
+    return current_token && current_token->load(std::memory_order_relaxed);
+}
+
+CheckContext::CancelToken CheckContext::token() {
+    return current_token;
+}
+
+CheckContext::Scope::Scope(CancelToken token) : previous(std::move(current_token)) {
+    current_token = std::move(token);
+}
+
+CheckContext::Scope::~Scope() {
+    current_token = std::move(previous);
+}
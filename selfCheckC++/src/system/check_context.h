@@ -0,0 +1,36 @@
+#ifndef CHECK_CONTEXT_H
+#define CHECK_CONTEXT_H
+
+#include <atomic>
+#include <memory>
+
+// 检测执行上下文：调度器在工作线程上设置取消标志，
+// 检测函数在循环或耗时操作之间调用 cancelled() 协作退出
+class CheckContext {
+public:
+    using CancelToken = std::shared_ptr<std::atomic<bool>>;
+
+    // 当前线程上的检测是否已被调度器取消
+    static bool cancelled();
+
+    // 当前线程绑定的取消标志；检测内部启动的线程用 Scope 绑定它以响应取消
+    static CancelToken token();
+
+    // 在作用域内把取消标志绑定到当前线程
+    class Scope {
+    public:
+        explicit Scope(CancelToken token);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        CancelToken previous;
+    };
+
+private:
+    static thread_local CancelToken current_token;
+};
+
+#endif // CHECK_CONTEXT_H
@@ -0,0 +1,97 @@
+#ifndef CHECK_PLUGIN_H
+#define CHECK_PLUGIN_H
+
+/*
+ * 检测插件 C ABI
+ *
+ * 插件是导出 selfcheck_plugin_descriptor() 的共享库（.so），
+ * 服务器启动时从 system.plugin_directory 加载，并自动注册路由
+ * /api/v1/check/{name}，同时可参与 /api/v1/check/all 批量检测。
+ *
+ * 该头文件只使用 C 类型，插件可以用 C 或 C++ 编写；
+ * 结构体只允许在末尾追加字段，破坏性修改必须提升 ABI 版本号。
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SELFCHECK_PLUGIN_ABI_VERSION 1u
+
+/* 检测结果状态，对应 "success" / "warning" / "error" */
+enum selfcheck_status {
+    SELFCHECK_STATUS_SUCCESS = 0,
+    SELFCHECK_STATUS_WARNING = 1,
+    SELFCHECK_STATUS_ERROR = 2
+};
+
+/* 开销等级，对应调度器的 CostClass */
+enum selfcheck_cost_class {
+    SELFCHECK_COST_CHEAP = 0,
+    SELFCHECK_COST_IO = 1,
+    SELFCHECK_COST_HEAVY = 2
+};
+
+/* 插件标志位 */
+enum selfcheck_plugin_flags {
+    /* run() 不可重入，服务器会串行调用 */
+    SELFCHECK_FLAG_NOT_THREAD_SAFE = 1u << 0
+};
+
+/* 日志级别，对应 Logger::LogLevel */
+enum selfcheck_log_level {
+    SELFCHECK_LOG_DEBUG = 0,
+    SELFCHECK_LOG_INFO = 1,
+    SELFCHECK_LOG_WARNING = 2,
+    SELFCHECK_LOG_ERROR = 3
+};
+
+/* 服务器提供给插件的回调 */
+typedef struct selfcheck_host_api {
+    uint32_t abi_version;
+    /* 写入服务器日志 */
+    void (*log)(int level, const char* message);
+    /* 当前检测是否已被调度器取消（仅在 run() 内调用有意义） */
+    int (*is_cancelled)(void);
+} selfcheck_host_api;
+
+/* run() 的输出；payload 由插件分配，release() 释放 */
+typedef struct selfcheck_run_result {
+    int status;      /* enum selfcheck_status */
+    void* payload;
+} selfcheck_run_result;
+
+typedef struct selfcheck_check_descriptor {
+    uint32_t abi_version;          /* 必须为 SELFCHECK_PLUGIN_ABI_VERSION */
+    const char* name;              /* 路由名，仅允许 [a-z0-9_-] */
+    const char* description;
+    int timeout_ms;                /* 批量检测的默认超时，<= 0 时使用 2000 */
+    int cost_class;                /* enum selfcheck_cost_class */
+    uint32_t flags;                /* enum selfcheck_plugin_flags 按位或 */
+    const char* const* depends_on; /* 以 NULL 结尾的依赖检测名，可为 NULL */
+
+    /* 加载时调用一次；返回 0 表示成功，*state 为插件私有状态 */
+    int (*init)(const selfcheck_host_api* host, void** state);
+    /* 卸载时调用，可为 NULL */
+    void (*shutdown)(void* state);
+    /* 执行检测，返回 0 表示成功填写 result */
+    int (*run)(void* state, selfcheck_run_result* result);
+    /* 把结果序列化为提示信息（UTF-8），语义同 snprintf：返回所需长度（不含结尾 0） */
+    size_t (*serialize)(void* state, const selfcheck_run_result* result, char* buffer, size_t capacity);
+    /* 释放 result->payload，可为 NULL */
+    void (*release)(void* state, selfcheck_run_result* result);
+} selfcheck_check_descriptor;
+
+/* 插件必须导出的入口函数名 */
+#define SELFCHECK_PLUGIN_ENTRY "selfcheck_plugin_descriptor"
+
+typedef const selfcheck_check_descriptor* (*selfcheck_plugin_entry_fn)(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CHECK_PLUGIN_H */
@@ -0,0 +1,226 @@
+#include "check_registry.h"
+#include "check_context.h"
+#include "check_plugin.h"
+#include "../utils/logger.h"
+#include <algorithm>
+#include <dlfcn.h>
+#include <filesystem>
+#include <mutex>
+
+namespace fs = std::filesystem;
+
+// 已加载插件：入口描述符与私有状态在加载时解析一次，调用路径上不再 dlsym
+struct LoadedPlugin {
+    std::string path;
+    void* handle = nullptr;
+    const selfcheck_check_descriptor* descriptor = nullptr;
+    void* state = nullptr;
+    std::mutex run_mutex;  // 仅用于 SELFCHECK_FLAG_NOT_THREAD_SAFE 插件
+};
+
+// 静态成员初始化
+std::vector<CheckDefinition> CheckRegistry::definitions;
+std::unordered_map<std::string, size_t> CheckRegistry::name_index;
+std::vector<std::unique_ptr<LoadedPlugin>> CheckRegistry::plugins;
+
+namespace {
+
+void host_log(int level, const char* message) {
+    std::string text = std::string("[插件] ") + (message ? message : "");
+    switch (level) {
+        case SELFCHECK_LOG_DEBUG: Logger::debug(text); break;
+        case SELFCHECK_LOG_WARNING: Logger::warning(text); break;
+        case SELFCHECK_LOG_ERROR: Logger::error(text); break;
+        default: Logger::info(text); break;
+    }
+}
+
+int host_is_cancelled() {
+    return CheckContext::cancelled() ? 1 : 0;
+}
+
+const selfcheck_host_api HOST_API = {
+    SELFCHECK_PLUGIN_ABI_VERSION,
+    &host_log,
+    &host_is_cancelled
+};
+
+bool is_valid_name(const char* name) {
+    if (!name || !*name) return false;
+    for (const char* p = name; *p; ++p) {
+        const char c = *p;
+        if (!((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_' || c == '-')) {
+            return false;
+        }
+    }
+    return true;
+}
+
+const char* status_to_string(int status) {
+    switch (status) {
+        case SELFCHECK_STATUS_SUCCESS: return "success";
+        case SELFCHECK_STATUS_WARNING: return "warning";
+        default: return "error";
+    }
+}
+
+CostClass to_cost_class(int cost) {
+    switch (cost) {
+        case SELFCHECK_COST_IO: return CostClass::IO;
+        case SELFCHECK_COST_HEAVY: return CostClass::HEAVY;
+        default: return CostClass::CHEAP;
+    }
+}
+
+SystemCheckResult invoke_plugin(LoadedPlugin& plugin) {
+    const selfcheck_check_descriptor* d = plugin.descriptor;
+
+    std::unique_lock<std::mutex> lock(plugin.run_mutex, std::defer_lock);
+    if (d->flags & SELFCHECK_FLAG_NOT_THREAD_SAFE) {
+        lock.lock();
+    }
+
+    selfcheck_run_result result = {SELFCHECK_STATUS_ERROR, nullptr};
+    int rc = d->run(plugin.state, &result);
+    if (rc != 0) {
+        if (d->release) d->release(plugin.state, &result);
+        return {"error", std::string("插件执行失败: ") + d->name + " (返回码 " + std::to_string(rc) + ")"};
+    }
+
+    // 常见的短消息直接写入栈缓冲区，超长时再按需分配
+    char buffer[512];
+    size_t needed = d->serialize(plugin.state, &result, buffer, sizeof(buffer));
+    std::string message;
+    if (needed < sizeof(buffer)) {
+        message.assign(buffer, needed);
+    } else {
+        message.resize(needed + 1);
+        needed = d->serialize(plugin.state, &result, message.data(), message.size());
+        message.resize(std::min(needed, message.size() - 1));
+    }
+
+    if (d->release) d->release(plugin.state, &result);
+    return {status_to_string(result.status), message};
+}
+
+} // namespace
+
+void CheckRegistry::initialize(const std::string& plugin_directory) {
+    for (const auto& def : SystemCheck::get_check_definitions()) {
+        register_definition(def);
+    }
+
+    std::error_code ec;
+    if (plugin_directory.empty() || !fs::is_directory(plugin_directory, ec)) {
+        Logger::info("插件目录不存在，跳过插件加载: " + plugin_directory);
+        return;
+    }
+
+    // 按文件名排序，保证加载顺序稳定
+    std::vector<std::string> candidates;
+    for (const auto& entry : fs::directory_iterator(plugin_directory, ec)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".so") {
+            candidates.push_back(entry.path().string());
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    for (const auto& path : candidates) {
+        load_plugin(path);
+    }
+    Logger::info("检测项注册完成: 共 " + std::to_string(definitions.size()) + " 项，其中插件 " +
+                 std::to_string(plugins.size()) + " 项");
+}
+
+void CheckRegistry::shutdown() {
+    for (auto& plugin : plugins) {
+        if (plugin->descriptor->shutdown) {
+            plugin->descriptor->shutdown(plugin->state);
+        }
+        dlclose(plugin->handle);
+    }
+    plugins.clear();
+    definitions.erase(std::remove_if(definitions.begin(), definitions.end(),
+                                     [](const CheckDefinition& def) { return def.source != "builtin"; }),
+                      definitions.end());
+    name_index.clear();
+    for (size_t i = 0; i < definitions.size(); ++i) {
+        name_index[definitions[i].name] = i;
+    }
+}
+
+bool CheckRegistry::load_plugin(const std::string& path) {
+    void* handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!handle) {
+        Logger::error("加载插件失败: " + path + " - " + dlerror());
+        return false;
+    }
+
+    auto entry = reinterpret_cast<selfcheck_plugin_entry_fn>(dlsym(handle, SELFCHECK_PLUGIN_ENTRY));
+    const selfcheck_check_descriptor* d = entry ? entry() : nullptr;
+
+    std::string reason;
+    if (!entry) {
+        reason = "缺少入口函数 " SELFCHECK_PLUGIN_ENTRY;
+    } else if (!d) {
+        reason = "入口函数返回空描述符";
+    } else if (d->abi_version != SELFCHECK_PLUGIN_ABI_VERSION) {
+        reason = "ABI版本不匹配: " + std::to_string(d->abi_version);
+    } else if (!is_valid_name(d->name) || std::string(d->name) == "all") {
+        reason = "无效的检测名称";
+    } else if (name_index.count(d->name)) {
+        reason = std::string("检测名称重复: ") + d->name;
+    } else if (!d->run || !d->serialize) {
+        reason = "缺少 run 或 serialize 回调";
+    }
+    if (!reason.empty()) {
+        Logger::error("拒绝加载插件 " + path + ": " + reason);
+        dlclose(handle);
+        return false;
+    }
+
+    auto plugin = std::make_unique<LoadedPlugin>();
+    plugin->path = path;
+    plugin->handle = handle;
+    plugin->descriptor = d;
+    if (d->init && d->init(&HOST_API, &plugin->state) != 0) {
+        Logger::error("插件初始化失败: " + path);
+        dlclose(handle);
+        return false;
+    }
+
+    CheckDefinition definition;
+    definition.name = d->name;
+    LoadedPlugin* raw = plugin.get();
+    definition.run = [raw] { return invoke_plugin(*raw); };
+    definition.timeout_ms = d->timeout_ms > 0 ? d->timeout_ms : 2000;
+    definition.cost = to_cost_class(d->cost_class);
+    if (d->depends_on) {
+        for (const char* const* dep = d->depends_on; *dep; ++dep) {
+            definition.depends_on.emplace_back(*dep);
+        }
+    }
+    definition.source = path;
+
+    plugins.push_back(std::move(plugin));
+    register_definition(std::move(definition));
+    Logger::info(std::string("已加载检测插件: ") + d->name + " (" + path + ") -> /api/v1/check/" + d->name);
+    return true;
+}
+
+const CheckDefinition* CheckRegistry::find(const std::string& name) {
+    auto it = name_index.find(name);
+    if (it == name_index.end()) {
+        return nullptr;
+    }
+    return &definitions[it->second];
+}
+
+const std::vector<CheckDefinition>& CheckRegistry::get_definitions() {
+    return definitions;
+}
+
+void CheckRegistry::register_definition(CheckDefinition definition) {
+    name_index[definition.name] = definitions.size();
+    definitions.push_back(std::move(definition));
+}
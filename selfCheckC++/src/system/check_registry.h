@@ -0,0 +1,39 @@
+#ifndef CHECK_REGISTRY_H
+#define CHECK_REGISTRY_H
+
+#include "system_check.h"
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct LoadedPlugin;
+
+// 检测项注册表：内置检测 + 从插件目录 dlopen 加载的检测
+// 注册只在启动阶段进行，之后只读，查询无需加锁
+class CheckRegistry {
+public:
+    // 注册内置检测并加载插件目录中的所有 .so
+    static void initialize(const std::string& plugin_directory);
+
+    // 调用插件 shutdown 回调并卸载所有插件
+    static void shutdown();
+
+    // 加载单个插件，成功返回 true
+    static bool load_plugin(const std::string& path);
+
+    // 按名称查找检测项，不存在返回 nullptr
+    static const CheckDefinition* find(const std::string& name);
+
+    // 所有已注册的检测项（按注册顺序）
+    static const std::vector<CheckDefinition>& get_definitions();
+
+private:
+    static void register_definition(CheckDefinition definition);
+
+    static std::vector<CheckDefinition> definitions;
+    static std::unordered_map<std::string, size_t> name_index;
+    static std::vector<std::unique_ptr<LoadedPlugin>> plugins;
+};
+
+#endif // CHECK_REGISTRY_H
@@ -0,0 +1,368 @@
+#include "check_scheduler.h"
+#include "check_context.h"
+#include "check_registry.h"
+#include "thread_placement.h"
+#include "../utils/logger.h"
+#include "../utils/thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::unique_ptr<ThreadPool> check_pool;
+std::once_flag pool_once;
+
+// 重型检测槽位在全部批次间共享，由工作线程在检测函数真正返回后释放：
+// 超时被放弃的检测仍占用槽位，避免与下一个重型检测同时运行
+std::mutex heavy_mutex;
+int heavy_running = 0;
+
+// 槽位被占用时，等待中的批次按此间隔重新尝试
+constexpr auto HEAVY_RETRY = std::chrono::milliseconds(50);
+
+bool acquire_heavy(int limit) {
+    std::lock_guard<std::mutex> lock(heavy_mutex);
+    if (heavy_running >= limit) return false;
+    ++heavy_running;
+    return true;
+}
+
+void release_heavy() {
+    std::lock_guard<std::mutex> lock(heavy_mutex);
+    --heavy_running;
+}
+
+ThreadPool& get_pool() {
+    // 未显式初始化时使用默认线程数
+    std::call_once(pool_once, [] {
+        if (!check_pool) {
+            check_pool = std::make_unique<ThreadPool>(4);
+        }
+    });
+    return *check_pool;
+}
+
+long to_ms(Clock::duration duration) {
+    return static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(duration).count());
+}
+
+int status_rank(const std::string& status) {
+    if (status == "error") return 2;
+    if (status == "warning") return 1;
+    return 0;
+}
+
+enum class NodePhase { WAITING, RUNNING, FINISHED };
+
+// 依赖图中的节点，仅由调度线程访问
+struct Node {
+    std::string name;
+    const CheckDefinition* def = nullptr;  // 为空表示未知检测项
+    std::vector<size_t> dependents;
+    size_t pending_deps = 0;
+    NodePhase phase = NodePhase::WAITING;
+    Clock::time_point dispatched;
+    Clock::time_point deadline;          // 运行中为执行截止时间，等待重型槽位时为排队截止时间
+    bool slot_waiting = false;
+    bool cancel_requested = false;
+    CheckContext::CancelToken token;
+};
+
+// 与工作线程共享的批次状态；节点被放弃后工作线程可能仍持有它，因此使用 shared_ptr
+struct BatchState {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<CheckOutcome> outcomes;
+    std::vector<bool> reported;   // 工作线程已提交结果
+    std::vector<bool> abandoned;  // 调度器已放弃，工作线程应丢弃结果
+    std::vector<size_t> ready;    // 已提交但尚未被调度器处理的节点
+};
+
+} // namespace
+
+void CheckScheduler::initialize(size_t worker_count) {
+    std::call_once(pool_once, [worker_count] {
+        check_pool = std::make_unique<ThreadPool>(worker_count, [] {
+            ThreadPlacement::apply(ThreadRole::CHECK_WORKER);
+        });
+    });
+    Logger::info("检测线程池已启动，工作线程数: " + std::to_string(get_pool().size()));
+}
+
+std::vector<CheckOutcome> CheckScheduler::run_batch(const std::vector<std::string>& names,
+                                                    int timeout_override_ms,
+                                                    const ResultCallback& on_result) {
+    const Clock::time_point batch_start = Clock::now();
+
+    // 构建依赖图：从请求的检测项出发补全传递依赖
+    std::vector<Node> nodes;
+    std::unordered_map<std::string, size_t> index_of;
+    auto add_node = [&](const std::string& name) {
+        auto found = index_of.find(name);
+        if (found != index_of.end()) {
+            return found->second;
+        }
+        Node node;
+        node.name = name;
+        node.def = CheckRegistry::find(name);
+        nodes.push_back(std::move(node));
+        index_of[name] = nodes.size() - 1;
+        return nodes.size() - 1;
+    };
+    for (const auto& name : names) {
+        add_node(name);
+    }
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        if (!nodes[i].def) continue;
+        for (const auto& dep_name : nodes[i].def->depends_on) {
+            size_t dep = add_node(dep_name);
+            nodes[dep].dependents.push_back(i);
+            nodes[i].pending_deps++;
+        }
+    }
+
+    auto state = std::make_shared<BatchState>();
+    state->outcomes.resize(nodes.size());
+    state->reported.assign(nodes.size(), false);
+    state->abandoned.assign(nodes.size(), false);
+
+    std::vector<CheckOutcome> outcomes(nodes.size());
+    std::vector<size_t> ready_queue;
+    size_t finished_count = 0;
+
+    // 节点结束：记录结果、回调，并推进（或跳过）下游节点
+    std::function<void(size_t, CheckOutcome)> finish = [&](size_t i, CheckOutcome outcome) {
+        outcome.name = nodes[i].name;
+        nodes[i].phase = NodePhase::FINISHED;
+        outcomes[i] = outcome;
+        ++finished_count;
+        if (on_result) {
+            on_result(outcome);
+        }
+
+        const bool failed = outcome.result.status == "error";
+        for (size_t d : nodes[i].dependents) {
+            if (nodes[d].phase != NodePhase::WAITING) continue;
+            if (failed) {
+                CheckOutcome skipped;
+                skipped.result = {"error", "已跳过: 依赖项 " + nodes[i].name + " 未通过"};
+                skipped.state = CheckState::SKIPPED;
+                finish(d, skipped);
+            } else if (--nodes[d].pending_deps == 0) {
+                ready_queue.push_back(d);
+            }
+        }
+    };
+
+    // 未知检测项直接失败；无依赖的节点进入就绪队列
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        if (nodes[i].phase != NodePhase::WAITING) continue;
+        if (!nodes[i].def) {
+            CheckOutcome unknown;
+            unknown.result = {"error", "未知检测项: " + nodes[i].name};
+            finish(i, unknown);
+        } else if (nodes[i].pending_deps == 0) {
+            ready_queue.push_back(i);
+        }
+    }
+
+    auto dispatch = [&]() {
+        // 廉价检测优先；重型检测受并发上限约束
+        std::stable_sort(ready_queue.begin(), ready_queue.end(), [&](size_t a, size_t b) {
+            return nodes[a].def->cost < nodes[b].def->cost;
+        });
+
+        bool own_heavy_running = false;
+        for (const auto& node : nodes) {
+            own_heavy_running = own_heavy_running ||
+                                (node.phase == NodePhase::RUNNING && node.def->cost == CostClass::HEAVY);
+        }
+
+        std::vector<size_t> deferred;
+        for (size_t i : ready_queue) {
+            if (nodes[i].phase != NodePhase::WAITING) continue;
+            const CheckDefinition* def = nodes[i].def;
+            const int timeout_ms = timeout_override_ms > 0 ? timeout_override_ms : def->timeout_ms;
+            const bool heavy = def->cost == CostClass::HEAVY;
+            if (heavy && !acquire_heavy(MAX_HEAVY_INFLIGHT)) {
+                // 槽位被其他批次或已放弃的检测占用时，排队同样受超时约束，卡死的检测不会让批次无限等待；
+                // 本批次的重型检测仍在运行时照常排队
+                if (own_heavy_running) {
+                    nodes[i].slot_waiting = false;
+                } else if (!nodes[i].slot_waiting) {
+                    nodes[i].slot_waiting = true;
+                    nodes[i].deadline = Clock::now() + std::chrono::milliseconds(timeout_ms);
+                }
+                deferred.push_back(i);
+                continue;
+            }
+
+            nodes[i].phase = NodePhase::RUNNING;
+            nodes[i].dispatched = Clock::now();
+            nodes[i].deadline = nodes[i].dispatched + std::chrono::milliseconds(timeout_ms);
+            nodes[i].token = std::make_shared<std::atomic<bool>>(false);
+
+            const CheckDefinition* run = def;
+            auto token = nodes[i].token;
+            get_pool().submit([state, i, run, token, batch_start, heavy] {
+                {
+                    // 排队期间已被放弃的节点不再执行
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    if (state->abandoned[i]) {
+                        if (heavy) release_heavy();
+                        return;
+                    }
+                }
+
+                const Clock::time_point begin = Clock::now();
+                SystemCheckResult result;
+                try {
+                    CheckContext::Scope scope(token);
+                    result = run->run();
+                } catch (const std::exception& e) {
+                    result = {"error", std::string("检测异常: ") + e.what()};
+                }
+                if (heavy) release_heavy();
+
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (state->abandoned[i]) return;
+                state->outcomes[i].result = std::move(result);
+                state->outcomes[i].started_ms = to_ms(begin - batch_start);
+                state->outcomes[i].elapsed_ms = to_ms(Clock::now() - begin);
+                state->reported[i] = true;
+                state->ready.push_back(i);
+                state->cv.notify_one();
+            });
+        }
+        ready_queue.swap(deferred);
+    };
+
+    dispatch();
+    while (finished_count < nodes.size()) {
+        Clock::time_point earliest = Clock::time_point::max();
+        for (const auto& node : nodes) {
+            if (node.phase == NodePhase::RUNNING) {
+                earliest = std::min(earliest, node.deadline);
+            }
+        }
+        if (earliest == Clock::time_point::max() && ready_queue.empty()) {
+            break;  // 防御：没有可推进的节点
+        }
+        if (!ready_queue.empty()) {
+            // 等待重型槽位的节点：槽位可能由其他批次或被放弃的检测释放，不会通知本批次
+            earliest = std::min(earliest, Clock::now() + HEAVY_RETRY);
+        }
+
+        std::vector<std::pair<size_t, CheckOutcome>> completed;
+        {
+            std::unique_lock<std::mutex> lock(state->mutex);
+            if (state->ready.empty()) {
+                state->cv.wait_until(lock, earliest, [&] { return !state->ready.empty(); });
+            }
+            for (size_t i : state->ready) {
+                completed.emplace_back(i, state->outcomes[i]);
+            }
+            state->ready.clear();
+        }
+
+        for (auto& [i, outcome] : completed) {
+            if (nodes[i].phase != NodePhase::RUNNING) continue;
+            if (nodes[i].cancel_requested) {
+                // 宽限期内返回：保留部分结果，但至少标记为警告
+                outcome.state = CheckState::CANCELLED;
+                outcome.result.message = "（超时取消，部分结果）" + outcome.result.message;
+                if (outcome.result.status == "success") {
+                    outcome.result.status = "warning";
+                }
+            }
+            finish(i, outcome);
+        }
+
+        const Clock::time_point now = Clock::now();
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            if (nodes[i].phase != NodePhase::RUNNING || now < nodes[i].deadline) continue;
+
+            if (!nodes[i].cancel_requested) {
+                // 首次超时：发出取消信号，给检测一个返回部分结果的宽限期
+                nodes[i].cancel_requested = true;
+                nodes[i].token->store(true, std::memory_order_relaxed);
+                nodes[i].deadline = now + std::chrono::milliseconds(CANCEL_GRACE_MS);
+                Logger::warning("检测项超时，已请求取消: " + nodes[i].name);
+                continue;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (state->reported[i]) continue;  // 结果已到达，下一轮处理
+                state->abandoned[i] = true;
+            }
+            // 槽位仍由工作线程持有，检测函数返回后才释放
+
+            CheckOutcome timeout;
+            timeout.result = {"error", "检测超时"};
+            timeout.state = CheckState::TIMEOUT;
+            timeout.started_ms = to_ms(nodes[i].dispatched - batch_start);
+            timeout.elapsed_ms = to_ms(now - nodes[i].dispatched);
+            finish(i, timeout);
+        }
+
+        // 等待重型槽位超时的节点
+        std::vector<size_t> expired;
+        for (size_t i : ready_queue) {
+            if (nodes[i].phase == NodePhase::WAITING && nodes[i].slot_waiting && now >= nodes[i].deadline) {
+                expired.push_back(i);
+            }
+        }
+        if (!expired.empty()) {
+            ready_queue.erase(std::remove_if(ready_queue.begin(), ready_queue.end(), [&](size_t i) {
+                return std::find(expired.begin(), expired.end(), i) != expired.end();
+            }), ready_queue.end());
+            for (size_t i : expired) {
+                CheckOutcome timeout;
+                timeout.result = {"error", "检测超时: 等待重型检测槽位（上一个重型检测仍在运行）"};
+                timeout.state = CheckState::TIMEOUT;
+                finish(i, timeout);
+            }
+        }
+
+        dispatch();
+    }
+
+    // 依赖成环的节点永远无法就绪
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        if (nodes[i].phase == NodePhase::WAITING) {
+            CheckOutcome cyclic;
+            cyclic.result = {"error", "依赖关系存在环: " + nodes[i].name};
+            cyclic.state = CheckState::SKIPPED;
+            finish(i, cyclic);
+        }
+    }
+
+    return outcomes;
+}
+
+std::string CheckScheduler::overall_status(const std::vector<CheckOutcome>& outcomes) {
+    int worst = 0;
+    for (const auto& outcome : outcomes) {
+        worst = std::max(worst, status_rank(outcome.result.status));
+    }
+    if (worst == 2) return "error";
+    if (worst == 1) return "warning";
+    return "success";
+}
+
+const char* CheckScheduler::state_to_string(CheckState state) {
+    switch (state) {
+        case CheckState::DONE: return "done";
+        case CheckState::SKIPPED: return "skipped";
+        case CheckState::CANCELLED: return "cancelled";
+        case CheckState::TIMEOUT: return "timeout";
+        default: return "unknown";
+    }
+}
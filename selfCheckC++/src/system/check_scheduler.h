@@ -0,0 +1,57 @@
+#ifndef CHECK_SCHEDULER_H
+#define CHECK_SCHEDULER_H
+
+#include "../types/common_types.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+// 检测节点的最终状态
+enum class CheckState {
+    DONE,       // 正常完成
+    SKIPPED,    // 上游依赖失败，未执行
+    CANCELLED,  // 超时后被取消，但在宽限期内返回了部分结果
+    TIMEOUT     // 超时且未返回任何结果
+};
+
+// 单个检测节点的执行结果
+struct CheckOutcome {
+    std::string name;
+    SystemCheckResult result;
+    CheckState state = CheckState::DONE;
+    long started_ms = -1;   // 相对批次开始的启动时间，未执行时为 -1
+    long elapsed_ms = 0;    // 节点自身的执行耗时
+};
+
+// 检测依赖图调度器：
+// 无依赖关系的检测并行执行，依赖失败的下游检测被跳过，
+// 超过截止时间的检测会收到取消信号
+class CheckScheduler {
+public:
+    using ResultCallback = std::function<void(const CheckOutcome&)>;
+
+    // 初始化检测工作线程池
+    static void initialize(size_t worker_count);
+
+    // 执行一组检测项（自动补全其传递依赖）
+    // timeout_override_ms > 0 时覆盖各检测项的默认超时时间；
+    // on_result 在调用线程中按完成顺序回调，可用于流式输出
+    static std::vector<CheckOutcome> run_batch(const std::vector<std::string>& names,
+                                               int timeout_override_ms = 0,
+                                               const ResultCallback& on_result = nullptr);
+
+    // 汇总多个结果的整体状态（error > warning > success）
+    static std::string overall_status(const std::vector<CheckOutcome>& outcomes);
+
+    // 节点状态的字符串表示
+    static const char* state_to_string(CheckState state);
+
+private:
+    // 同时运行的重型检测数量上限（全进程共享；超时被放弃的检测在返回前仍计入）
+    static constexpr int MAX_HEAVY_INFLIGHT = 1;
+
+    // 超时后等待检测返回部分结果的宽限时间
+    static constexpr int CANCEL_GRACE_MS = 100;
+};
+
+#endif // CHECK_SCHEDULER_H
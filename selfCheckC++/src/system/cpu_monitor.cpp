@@ -0,0 +1,336 @@
+#include "cpu_monitor.h"
+#include "metric_sampler.h"
+#include "process_table.h"
+#include "../config/config_manager.h"
+#include "../utils/file_utils.h"
+#include "../utils/logger.h"
+#include "../utils/proc_parser.h"
+#include <algorithm>
+#include <filesystem>
+#include <map>
+#include <nlohmann/json.hpp>
+#include <sstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+// 静态成员初始化
+std::mutex CpuMonitor::mutex;
+SysfsReader CpuMonitor::stat_reader;
+std::vector<CpuMonitor::Cluster> CpuMonitor::clusters;
+std::vector<CpuMonitor::CoreCounters> CpuMonitor::previous;
+std::vector<CpuMonitor::CoreCounters> CpuMonitor::current;
+CpuSnapshot CpuMonitor::snapshot;
+int CpuMonitor::sample_count = 0;
+int CpuMonitor::saturation_percent = 90;
+int CpuMonitor::low_freq_percent = 50;
+
+namespace {
+
+const std::string CPU_SYSFS = "/sys/devices/system/cpu";
+
+// 预先生成的指标名称，采样路径上不再拼接字符串
+std::vector<std::string> util_series;
+std::vector<std::string> freq_series;
+
+long read_sysfs_long(const std::string& path) {
+    long value = -1;
+    SysfsReader reader({path});
+    reader.read_long(value);
+    return value;
+}
+
+// 从 /proc/cpuinfo 读取每个处理器的 CPU part，用于区分 A76/A55
+std::map<int, std::string> read_core_types() {
+    static const std::map<std::string, std::string> PART_NAMES = {
+        {"0xd03", "A53"}, {"0xd05", "A55"}, {"0xd08", "A72"},
+        {"0xd0b", "A76"}, {"0xd41", "A78"}
+    };
+
+    std::map<int, std::string> types;
+    std::istringstream cpuinfo(FileUtils::read_file("/proc/cpuinfo"));
+    std::string line;
+    int processor = -1;
+    while (std::getline(cpuinfo, line)) {
+        size_t colon = line.find(':');
+        if (colon == std::string::npos) continue;
+        std::string key = line.substr(0, line.find_last_not_of(" \t", colon - 1) + 1);
+        std::string value = line.substr(colon + 1);
+        value.erase(0, value.find_first_not_of(" \t"));
+        if (key == "processor") {
+            processor = std::atoi(value.c_str());
+        } else if (key == "CPU part" && processor >= 0) {
+            auto it = PART_NAMES.find(value);
+            if (it != PART_NAMES.end()) {
+                types[processor] = it->second;
+            }
+        }
+    }
+    return types;
+}
+
+// 读取 governor 这类短字符串属性，去掉结尾换行
+void read_sysfs_word(const SysfsReader& reader, std::string& out) {
+    char buffer[32];
+    ssize_t n = reader.read(buffer, sizeof(buffer));
+    if (n <= 0) return;
+    while (n > 0 && (buffer[n - 1] == '\n' || buffer[n - 1] == ' ')) --n;
+    out.assign(buffer, static_cast<size_t>(n));
+}
+
+} // namespace
+
+void CpuMonitor::discover_clusters() {
+    std::map<int, std::string> core_types = read_core_types();
+
+    // 每个 cpufreq 策略对应一个簇，按首个 CPU 编号排序
+    std::map<int, Cluster> by_first_cpu;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(CPU_SYSFS + "/cpufreq", ec)) {
+        const std::string policy = entry.path().filename().string();
+        if (policy.rfind("policy", 0) != 0) continue;
+
+        std::vector<int> cpus = proc::parse_cpu_list(FileUtils::read_file(entry.path().string() + "/related_cpus"));
+        if (cpus.empty()) continue;
+
+        Cluster cluster;
+        cluster.stats.cpus = cpus;
+        cluster.stats.max_freq_khz = read_sysfs_long(entry.path().string() + "/cpuinfo_max_freq");
+        cluster.cur_freq.open({entry.path().string() + "/scaling_cur_freq"});
+        cluster.limit_freq.open({entry.path().string() + "/scaling_max_freq"});
+        cluster.governor.open({entry.path().string() + "/scaling_governor"});
+        by_first_cpu[cpus.front()] = std::move(cluster);
+    }
+
+    // 没有 cpufreq（虚拟机/开发机）时把所有 CPU 视为一个簇
+    if (by_first_cpu.empty()) {
+        Cluster cluster;
+        for (size_t cpu = 0; cpu < current.size(); ++cpu) {
+            cluster.stats.cpus.push_back(static_cast<int>(cpu));
+        }
+        by_first_cpu[0] = std::move(cluster);
+    }
+
+    // 以 cpu_capacity（缺失时以最高频率）区分大小核
+    std::vector<long> capacities;
+    for (auto& [first_cpu, cluster] : by_first_cpu) {
+        long capacity = read_sysfs_long(CPU_SYSFS + "/cpu" + std::to_string(first_cpu) + "/cpu_capacity");
+        capacities.push_back(capacity > 0 ? capacity : cluster.stats.max_freq_khz);
+    }
+    long max_capacity = capacities.empty() ? 0 : *std::max_element(capacities.begin(), capacities.end());
+    long min_capacity = capacities.empty() ? 0 : *std::min_element(capacities.begin(), capacities.end());
+
+    size_t index = 0;
+    for (auto& [first_cpu, cluster] : by_first_cpu) {
+        cluster.stats.big = max_capacity > min_capacity && capacities[index++] == max_capacity;
+
+        auto type = core_types.find(first_cpu);
+        std::string base = type != core_types.end() ? type->second : (cluster.stats.big ? "big" : "cpu");
+        cluster.stats.name = base + "-" + std::to_string(first_cpu);
+
+        clusters.push_back(std::move(cluster));
+    }
+}
+
+void CpuMonitor::initialize() {
+    YAML::Node config = ConfigManager::get_system_config();
+    saturation_percent = config["cpu_saturation_percent"].as<int>(90);
+    low_freq_percent = config["cpu_low_freq_percent"].as<int>(50);
+    int sample_hz = std::max(1, config["cpu_sample_hz"].as<int>(10));
+
+    if (!stat_reader.open({"/proc/stat"})) {
+        Logger::error("无法打开 /proc/stat，CPU监控不可用");
+        return;
+    }
+
+    int cpu_count = static_cast<int>(std::thread::hardware_concurrency());
+    for (const auto& cpu : proc::parse_cpu_list(FileUtils::read_file(CPU_SYSFS + "/possible"))) {
+        cpu_count = std::max(cpu_count, cpu + 1);
+    }
+    current.assign(static_cast<size_t>(std::max(cpu_count, 1)), CoreCounters());
+    previous = current;
+    snapshot.core_utilization.assign(current.size(), -1.0);
+
+    discover_clusters();
+    for (const auto& cluster : clusters) {
+        snapshot.clusters.push_back(cluster.stats);
+        util_series.push_back("cpu." + cluster.stats.name + ".util");
+        freq_series.push_back("cpu." + cluster.stats.name + ".freq_mhz");
+
+        std::ostringstream oss;
+        oss << "CPU簇 " << cluster.stats.name << (cluster.stats.big ? " (大核)" : "") << ": CPU";
+        for (int cpu : cluster.stats.cpus) oss << " " << cpu;
+        if (cluster.stats.max_freq_khz > 0) oss << "，最高 " << cluster.stats.max_freq_khz / 1000 << " MHz";
+        Logger::info(oss.str());
+    }
+
+    MetricSampler::register_task("cpu", std::chrono::milliseconds(1000 / sample_hz), &CpuMonitor::sample);
+}
+
+void CpuMonitor::sample() {
+    if (!stat_reader.is_open()) return;
+
+    // CPU 行位于 /proc/stat 开头，固定缓冲区足够容纳
+    proc::FileBuffer<8192> buffer;
+    if (!buffer.load(stat_reader)) return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& counters : current) {
+        counters = CoreCounters();
+    }
+
+    proc::LineScanner lines(buffer.view());
+    std::string_view line;
+    while (lines.next(line)) {
+        if (line.size() < 4 || line.compare(0, 3, "cpu") != 0) break;
+        if (line[3] == ' ') continue;  // 汇总行
+
+        proc::TokenScanner tokens(line);
+        std::string_view name;
+        tokens.next(name);
+        uint64_t cpu = 0;
+        if (!proc::parse_u64(name.substr(3), cpu) || cpu >= current.size()) continue;
+
+        // user nice system idle iowait irq softirq steal
+        uint64_t fields[8] = {0};
+        for (auto& field : fields) {
+            if (!tokens.next_u64(field)) break;
+        }
+        uint64_t total = 0;
+        for (uint64_t field : fields) total += field;
+        const uint64_t idle = fields[3] + fields[4];
+        current[cpu] = {total - idle, total};
+    }
+
+    const bool have_previous = sample_count > 0;
+    for (size_t cpu = 0; cpu < current.size(); ++cpu) {
+        double utilization = -1.0;
+        if (have_previous && current[cpu].total > previous[cpu].total) {
+            uint64_t total_delta = current[cpu].total - previous[cpu].total;
+            uint64_t busy_delta = current[cpu].busy >= previous[cpu].busy ? current[cpu].busy - previous[cpu].busy : 0;
+            utilization = 100.0 * static_cast<double>(busy_delta) / static_cast<double>(total_delta);
+        }
+        snapshot.core_utilization[cpu] = utilization;
+    }
+    previous.swap(current);
+    ++sample_count;
+    snapshot.valid = sample_count >= 2;
+
+    for (size_t i = 0; i < clusters.size(); ++i) {
+        CpuClusterStats& stats = snapshot.clusters[i];
+        double sum = 0.0;
+        int online = 0;
+        for (int cpu : stats.cpus) {
+            if (cpu >= 0 && static_cast<size_t>(cpu) < snapshot.core_utilization.size() &&
+                snapshot.core_utilization[cpu] >= 0) {
+                sum += snapshot.core_utilization[cpu];
+                ++online;
+            }
+        }
+        stats.utilization = online > 0 ? sum / online : 0.0;
+        clusters[i].cur_freq.read_long(stats.cur_freq_khz);
+        clusters[i].limit_freq.read_long(stats.limit_freq_khz);
+        read_sysfs_word(clusters[i].governor, stats.governor);
+
+        if (snapshot.valid) {
+            MetricSampler::record(util_series[i], stats.utilization);
+            if (stats.cur_freq_khz > 0) {
+                MetricSampler::record(freq_series[i], stats.cur_freq_khz / 1000.0);
+            }
+        }
+    }
+}
+
+CpuSnapshot CpuMonitor::get_snapshot() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return snapshot;
+}
+
+SystemCheckResult CpuMonitor::check() {
+    Logger::info("执行CPU检测");
+
+    CpuSnapshot snap = get_snapshot();
+    if (!snap.valid) {
+        // 后台采样尚未就绪时，现场做两次间隔 100 ms 的采样
+        sample();
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        sample();
+        snap = get_snapshot();
+    }
+    if (!snap.valid || snap.clusters.empty()) {
+        return {"error", "无法获取CPU利用率信息"};
+    }
+
+    // 只有大小核可区分时才只关注大核簇，否则所有簇都参与判定
+    const bool has_big = std::any_of(snap.clusters.begin(), snap.clusters.end(),
+                                     [](const CpuClusterStats& c) { return c.big; });
+
+    std::string status = "success";
+    std::ostringstream message;
+    std::vector<std::string> warnings;
+    nlohmann::json clusters_json = nlohmann::json::array();
+
+    for (size_t i = 0; i < snap.clusters.size(); ++i) {
+        const CpuClusterStats& c = snap.clusters[i];
+        if (i > 0) message << "; ";
+        message << c.name << ": 利用率 " << static_cast<int>(c.utilization + 0.5) << "%";
+        if (c.cur_freq_khz > 0) {
+            message << ", " << c.cur_freq_khz / 1000;
+            if (c.max_freq_khz > 0) message << "/" << c.max_freq_khz / 1000;
+            message << " MHz";
+        }
+        if (!c.governor.empty()) message << " (" << c.governor << ")";
+
+        if (!has_big || c.big) {
+            if (c.utilization >= saturation_percent) {
+                warnings.push_back(c.name + " 负载饱和");
+            }
+            if (c.max_freq_khz > 0) {
+                const long low_limit = c.max_freq_khz * low_freq_percent / 100;
+                const bool capped = c.limit_freq_khz > 0 && c.limit_freq_khz < low_limit;
+                const bool stuck_low = c.cur_freq_khz > 0 && c.cur_freq_khz < low_limit && c.utilization >= 50.0;
+                if (capped || stuck_low || c.governor == "powersave") {
+                    warnings.push_back(c.name + " 被限制在低频");
+                }
+            }
+        }
+
+        nlohmann::json cores = nlohmann::json::array();
+        for (int cpu : c.cpus) {
+            double util = (cpu >= 0 && static_cast<size_t>(cpu) < snap.core_utilization.size())
+                              ? snap.core_utilization[cpu] : -1.0;
+            cores.push_back({{"cpu", cpu}, {"utilization", util}});
+        }
+        clusters_json.push_back({
+            {"name", c.name},
+            {"big", c.big},
+            {"utilization", c.utilization},
+            {"cur_freq_khz", c.cur_freq_khz},
+            {"max_freq_khz", c.max_freq_khz},
+            {"limit_freq_khz", c.limit_freq_khz},
+            {"governor", c.governor},
+            {"cores", cores}
+        });
+    }
+
+    nlohmann::json details = {{"clusters", clusters_json}};
+
+    // 负载饱和或限频时列出 CPU 占用最高的进程（占用按后台刷新周期计算）
+    if (!warnings.empty()) {
+        ProcessTable::refresh();
+        nlohmann::json top = nlohmann::json::array();
+        for (const auto& consumer : ProcessTable::top_cpu(ProcessTable::default_count())) {
+            top.push_back({{"pid", consumer.pid}, {"comm", consumer.comm}, {"cpu_percent", consumer.cpu_percent}});
+            message << (top.size() == 1 ? "; 占用最高:" : ",") << " " << consumer.comm
+                    << "(" << consumer.pid << ") " << static_cast<int>(consumer.cpu_percent + 0.5) << "%";
+        }
+        details["top_cpu"] = top;
+
+        status = "warning";
+        message << " [告警:";
+        for (const auto& warning : warnings) message << " " << warning;
+        message << "]";
+    }
+
+    return {status, message.str(), details.dump()};
+}
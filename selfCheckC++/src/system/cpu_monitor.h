@@ -0,0 +1,72 @@
+#ifndef CPU_MONITOR_H
+#define CPU_MONITOR_H
+
+#include "../types/common_types.h"
+#include "../utils/sysfs_reader.h"
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 单个 cpufreq 策略（即一个 CPU 簇）的采样结果
+struct CpuClusterStats {
+    std::string name;            // 如 "A76-0"、"A55"
+    std::vector<int> cpus;
+    bool big = false;            // 是否为大核簇
+    double utilization = 0.0;    // 簇内平均利用率（%）
+    long cur_freq_khz = -1;
+    long max_freq_khz = -1;      // cpuinfo_max_freq
+    long limit_freq_khz = -1;    // scaling_max_freq
+    std::string governor;
+};
+
+// CPU 利用率与频率快照
+struct CpuSnapshot {
+    bool valid = false;                 // 至少完成两次采样后才有利用率
+    std::vector<double> core_utilization;  // 下标为 CPU 编号，-1 表示离线
+    std::vector<CpuClusterStats> clusters;
+};
+
+// 基于 /proc/stat 增量与 cpufreq 策略的 CPU 监控（大小核感知）
+class CpuMonitor {
+public:
+    // 发现 CPU 与 cpufreq 策略并注册后台采样任务
+    static void initialize();
+
+    // 执行一次采样（与上次采样做差），供采样线程以 10 Hz 调用
+    static void sample();
+
+    // 最近一次采样结果
+    static CpuSnapshot get_snapshot();
+
+    // CPU 检测：各簇利用率/频率汇总，大核簇被限频或饱和时告警
+    static SystemCheckResult check();
+
+private:
+    struct Cluster {
+        CpuClusterStats stats;
+        SysfsReader cur_freq;
+        SysfsReader limit_freq;
+        SysfsReader governor;
+    };
+
+    struct CoreCounters {
+        uint64_t busy = 0;
+        uint64_t total = 0;
+    };
+
+    static void discover_clusters();
+
+    static std::mutex mutex;
+    static SysfsReader stat_reader;
+    static std::vector<Cluster> clusters;
+    static std::vector<CoreCounters> previous;
+    static std::vector<CoreCounters> current;
+    static CpuSnapshot snapshot;
+    static int sample_count;
+
+    static int saturation_percent;
+    static int low_freq_percent;
+};
+
+#endif // CPU_MONITOR_H
@@ -0,0 +1,358 @@
+#include "endpoint_probe.h"
+#include "../config/config_manager.h"
+#include "../utils/logger.h"
+#include "../utils/monotonic_clock.h"
+#include "../utils/string_utils.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <netdb.h>
+#include <nlohmann/json.hpp>
+#include <poll.h>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+// 一个端点的探测状态
+struct Attempt {
+    const IpcEndpoint* endpoint = nullptr;
+    int fd = -1;
+    int64_t start_ns = 0;
+    bool finished = false;
+    bool reachable = false;
+    double connect_us = 0.0;
+    std::string error;
+
+    void finish(bool ok, const std::string& reason) {
+        finished = true;
+        reachable = ok;
+        error = reason;
+        connect_us = (monotonic_ns() - start_ns) / 1e3;
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+};
+
+std::string connect_error(int error) {
+    // ECONNREFUSED 表示地址可达但没有进程在监听（ipc 端点则是套接字文件残留）
+    return error == ECONNREFUSED ? "拒绝连接（无进程监听）" : strerror(error);
+}
+
+// 发起非阻塞 connect；立即得到结果时直接结束，否则留待 poll
+void start_connect(Attempt& attempt) {
+    const IpcEndpoint& endpoint = *attempt.endpoint;
+    attempt.start_ns = monotonic_ns();
+
+    sockaddr_storage address{};
+    socklen_t length = 0;
+    int family = AF_UNIX;
+    if (endpoint.transport == "ipc") {
+        struct stat st{};
+        if (::stat(endpoint.target.c_str(), &st) != 0) {
+            attempt.finish(false, "套接字文件不存在");
+            return;
+        }
+        if (!S_ISSOCK(st.st_mode)) {
+            attempt.finish(false, "不是套接字文件");
+            return;
+        }
+        auto* un = reinterpret_cast<sockaddr_un*>(&address);
+        if (endpoint.target.size() >= sizeof(un->sun_path)) {
+            attempt.finish(false, "路径过长");
+            return;
+        }
+        un->sun_family = AF_UNIX;
+        std::memcpy(un->sun_path, endpoint.target.c_str(), endpoint.target.size() + 1);
+        length = sizeof(sockaddr_un);
+    } else {
+        const size_t colon = endpoint.target.rfind(':');
+        std::string host = endpoint.target.substr(0, colon);
+        const std::string port = endpoint.target.substr(colon + 1);
+        if (host.size() >= 2 && host.front() == '[' && host.back() == ']') host = host.substr(1, host.size() - 2);
+        // 只接受数字地址：getaddrinfo 做 DNS 解析时会阻塞，不受建连截止时间约束
+        if (host == "localhost") host = "127.0.0.1";
+
+        addrinfo hints{};
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = AI_NUMERICHOST | AI_NUMERICSERV;
+        addrinfo* result = nullptr;
+        if (colon == std::string::npos || ::getaddrinfo(host.c_str(), port.c_str(), &hints, &result) != 0 || !result) {
+            attempt.finish(false, "无法解析地址（仅支持 IP 地址或 localhost）");
+            return;
+        }
+        family = result->ai_family;
+        length = result->ai_addrlen;
+        std::memcpy(&address, result->ai_addr, result->ai_addrlen);
+        ::freeaddrinfo(result);
+    }
+
+    attempt.fd = ::socket(family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (attempt.fd < 0) {
+        attempt.finish(false, std::string("创建套接字失败: ") + strerror(errno));
+        return;
+    }
+    if (::connect(attempt.fd, reinterpret_cast<sockaddr*>(&address), length) == 0) {
+        attempt.finish(true, "");
+    } else if (errno == EAGAIN && endpoint.transport == "ipc") {
+        // 非阻塞 Unix 套接字 connect 返回 EAGAIN 表示监听队列已满，而不是连接进行中
+        attempt.finish(false, "监听队列已满（对端未在接受连接）");
+    } else if (errno != EINPROGRESS) {
+        attempt.finish(false, connect_error(errno));
+    }
+}
+
+// 在同一截止时间内等待所有未完成的 connect
+void wait_all(std::vector<Attempt>& attempts, int timeout_ms) {
+    const int64_t deadline_ns = monotonic_ns() + static_cast<int64_t>(timeout_ms) * 1000000;
+    std::vector<pollfd> fds;
+    std::vector<Attempt*> pending;
+    while (true) {
+        fds.clear();
+        pending.clear();
+        for (auto& attempt : attempts) {
+            if (attempt.finished) continue;
+            fds.push_back({attempt.fd, POLLOUT, 0});
+            pending.push_back(&attempt);
+        }
+        if (fds.empty()) return;
+
+        const int64_t remaining_ms = (deadline_ns - monotonic_ns()) / 1000000;
+        if (remaining_ms <= 0) break;
+        int ready = ::poll(fds.data(), fds.size(), static_cast<int>(remaining_ms));
+        if (ready < 0 && errno != EINTR) break;
+        for (size_t i = 0; i < fds.size() && ready > 0; ++i) {
+            if (fds[i].revents == 0) continue;
+            int error = 0;
+            socklen_t size = sizeof(error);
+            ::getsockopt(fds[i].fd, SOL_SOCKET, SO_ERROR, &error, &size);
+            if (error == 0 && (fds[i].revents & (POLLHUP | POLLERR))) {
+                // SO_ERROR 为 0 但连接已挂断：对端未接受连接，不能算作可达
+                pending[i]->finish(false, "连接被挂断（对端未接受连接）");
+                continue;
+            }
+            pending[i]->finish(error == 0, error == 0 ? "" : connect_error(error));
+        }
+    }
+    for (auto& attempt : attempts) {
+        if (!attempt.finished) attempt.finish(false, "连接超时");
+    }
+}
+
+struct EchoResult {
+    bool ok = false;
+    std::string error;
+    size_t messages = 0;
+    size_t message_bytes = 0;
+    double seconds = 0.0;
+    double p50_us = 0.0;
+    double p99_us = 0.0;
+    double max_us = 0.0;
+
+    double mbps() const { return seconds > 0 ? messages * message_bytes / 1048576.0 / seconds : 0.0; }
+};
+
+bool transfer_all(int fd, char* buffer, size_t size, bool write) {
+    size_t done = 0;
+    while (done < size) {
+        ssize_t n = write ? ::send(fd, buffer + done, size - done, MSG_NOSIGNAL)
+                          : ::recv(fd, buffer + done, size - done, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        done += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// 本地回显替身：Unix 流套接字对的一端由回显线程原样返回每条消息，
+// 与 ZeroMQ ipc:// 使用同一内核传输路径，测得的是本机 IPC 的往返延迟与吞吐上限
+EchoResult measure_echo(size_t message_bytes, int messages, int max_ms) {
+    EchoResult result;
+    result.message_bytes = message_bytes;
+    int pair[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, pair) != 0) {
+        result.error = std::string("创建套接字对失败: ") + strerror(errno);
+        return result;
+    }
+    // 任一端阻塞超过截止时间即放弃，避免回显线程异常时检测挂起
+    timeval timeout{max_ms / 1000 + 1, 0};
+    for (int fd : pair) {
+        ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    }
+
+    std::thread echo([fd = pair[1], message_bytes] {
+        std::vector<char> buffer(message_bytes);
+        while (transfer_all(fd, buffer.data(), message_bytes, false) &&
+               transfer_all(fd, buffer.data(), message_bytes, true)) {
+        }
+        ::close(fd);
+    });
+
+    std::vector<char> buffer(message_bytes, 'x');
+    std::vector<double> rtts;
+    rtts.reserve(static_cast<size_t>(messages));
+    const int64_t start_ns = monotonic_ns();
+    const int64_t deadline_ns = start_ns + static_cast<int64_t>(max_ms) * 1000000;
+    bool ok = true;
+    for (int i = 0; i < messages && monotonic_ns() < deadline_ns; ++i) {
+        const int64_t sent_ns = monotonic_ns();
+        if (!transfer_all(pair[0], buffer.data(), message_bytes, true) ||
+            !transfer_all(pair[0], buffer.data(), message_bytes, false)) {
+            result.error = std::string("回显失败: ") + strerror(errno);
+            ok = false;
+            break;
+        }
+        rtts.push_back((monotonic_ns() - sent_ns) / 1e3);
+    }
+    result.seconds = (monotonic_ns() - start_ns) / 1e9;
+    ::shutdown(pair[0], SHUT_RDWR);
+    ::close(pair[0]);
+    echo.join();
+
+    result.messages = rtts.size();
+    result.ok = ok && !rtts.empty();
+    if (!rtts.empty()) {
+        std::sort(rtts.begin(), rtts.end());
+        result.p50_us = rtts[rtts.size() / 2];
+        result.p99_us = rtts[std::min(rtts.size() - 1, rtts.size() * 99 / 100)];
+        result.max_us = rtts.back();
+    }
+    return result;
+}
+
+std::string format_us(double us) {
+    char buffer[32];
+    if (us >= 1000) {
+        snprintf(buffer, sizeof(buffer), "%.1f ms", us / 1000);
+    } else {
+        snprintf(buffer, sizeof(buffer), "%.0f us", us);
+    }
+    return buffer;
+}
+
+} // namespace
+
+std::vector<IpcEndpoint> EndpointProbe::collect_endpoints() {
+    std::vector<IpcEndpoint> endpoints;
+    ConfigManager::for_each_config_value([&](const std::string& config, const std::string& key, const std::string& value) {
+        const bool ipc = starts_with(value, "ipc://");
+        if (!ipc && !starts_with(value, "tcp://")) return;
+
+        auto found = std::find_if(endpoints.begin(), endpoints.end(),
+                                  [&value](const IpcEndpoint& endpoint) { return endpoint.address == value; });
+        if (found == endpoints.end()) {
+            IpcEndpoint endpoint;
+            endpoint.address = value;
+            endpoint.transport = ipc ? "ipc" : "tcp";
+            endpoint.target = value.substr(6);
+            // 绑定在通配地址上的端点由本机进程监听，从回环地址探测
+            if (!ipc && (starts_with(endpoint.target, "*:") || starts_with(endpoint.target, "0.0.0.0:"))) {
+                endpoint.target = "127.0.0.1" + endpoint.target.substr(endpoint.target.find(':'));
+            }
+            endpoints.push_back(std::move(endpoint));
+            found = endpoints.end() - 1;
+        }
+        found->sources.push_back(config + ":" + key);
+    });
+    return endpoints;
+}
+
+SystemCheckResult EndpointProbe::check() {
+    Logger::info("执行 IPC 端点检测");
+
+    YAML::Node config = ConfigManager::get_system_config();
+    const int timeout_ms = std::clamp(config["ipc_connect_timeout_ms"].as<int>(500), 10, 5000);
+    const int echo_messages = std::max(0, config["ipc_echo_messages"].as<int>(0));
+    const size_t echo_bytes = static_cast<size_t>(std::clamp(config["ipc_echo_bytes"].as<int>(1048576), 1, 16 << 20));
+    const int echo_max_ms = std::clamp(config["ipc_echo_max_ms"].as<int>(500), 10, 5000);
+
+    const std::vector<IpcEndpoint> endpoints = collect_endpoints();
+    if (endpoints.empty()) {
+        return {"warning", "配置中没有 ipc:// 或 tcp:// 端点"};
+    }
+
+    std::vector<Attempt> attempts(endpoints.size());
+    for (size_t i = 0; i < endpoints.size(); ++i) {
+        attempts[i].endpoint = &endpoints[i];
+        start_connect(attempts[i]);
+    }
+    wait_all(attempts, timeout_ms);
+
+    size_t reachable = 0;
+    double slowest_us = 0.0;
+    std::vector<std::string> failures;
+    nlohmann::json list = nlohmann::json::array();
+    for (const auto& attempt : attempts) {
+        const IpcEndpoint& endpoint = *attempt.endpoint;
+        if (attempt.reachable) {
+            ++reachable;
+            slowest_us = std::max(slowest_us, attempt.connect_us);
+        } else {
+            failures.push_back(endpoint.address + " " + attempt.error);
+        }
+        nlohmann::json item = {
+            {"address", endpoint.address},
+            {"transport", endpoint.transport},
+            {"target", endpoint.target},
+            {"sources", endpoint.sources},
+            {"reachable", attempt.reachable}
+        };
+        if (attempt.reachable) {
+            item["connect_us"] = attempt.connect_us;
+        } else {
+            item["error"] = attempt.error;
+        }
+        list.push_back(std::move(item));
+    }
+
+    std::ostringstream message;
+    message << reachable << "/" << endpoints.size() << " 个端点可连接";
+    if (reachable > 0) message << "，最慢建连 " << format_us(slowest_us);
+
+    nlohmann::json details = {
+        {"timeout_ms", timeout_ms},
+        {"endpoints", list}
+    };
+
+    if (echo_messages > 0) {
+        const EchoResult echo = measure_echo(echo_bytes, echo_messages, echo_max_ms);
+        details["echo"] = {
+            {"ok", echo.ok},
+            {"messages", echo.messages},
+            {"message_bytes", echo.message_bytes},
+            {"seconds", echo.seconds},
+            {"mbps", echo.mbps()},
+            {"rtt_p50_us", echo.p50_us},
+            {"rtt_p99_us", echo.p99_us},
+            {"rtt_max_us", echo.max_us}
+        };
+        if (echo.ok) {
+            char throughput[32];
+            snprintf(throughput, sizeof(throughput), "%.0f MB/s", echo.mbps());
+            message << "; 本地回显 " << echo.message_bytes / 1024 << " KB 消息往返 " << format_us(echo.p50_us)
+                    << " (p99 " << format_us(echo.p99_us) << ")，吞吐 " << throughput;
+        } else {
+            details["echo"]["error"] = echo.error;
+            failures.push_back("本地回显 " + echo.error);
+        }
+    }
+
+    std::string status = "success";
+    if (!failures.empty()) {
+        status = "warning";
+        message << " [不可用:";
+        for (const auto& failure : failures) message << " " << failure << ";";
+        message << "]";
+    }
+    return {status, message.str(), details.dump()};
+}
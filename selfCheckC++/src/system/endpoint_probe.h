@@ -0,0 +1,29 @@
+#ifndef ENDPOINT_PROBE_H
+#define ENDPOINT_PROBE_H
+
+#include "../types/common_types.h"
+#include <string>
+#include <vector>
+
+// 配置文件中声明的一个 ZeroMQ 端点
+struct IpcEndpoint {
+    std::string address;               // 原始地址，如 "ipc:///tmp/sensor_image"、"tcp://*:8848"
+    std::string transport;             // "ipc" 或 "tcp"
+    std::string target;                // ipc 为套接字路径，tcp 为 主机:端口（通配地址替换为 127.0.0.1）
+    std::vector<std::string> sources;  // 引用该地址的配置项，如 "trans:zmq_addr_send_frame"
+};
+
+// 端点连通性检测：从已加载的各配置文件中提取全部 ipc:// 与 tcp:// 地址，
+// 检查 ipc 套接字文件是否存在，并以非阻塞 connect 并行探测所有端点，
+// 在同一截止时间内用 poll 等待结果并记录建连耗时。
+// 可选地在本地 Unix 套接字回显服务上测量消息往返延迟与吞吐，作为 IPC 传输能力的基线
+class EndpointProbe {
+public:
+    // 端点检测
+    static SystemCheckResult check();
+
+    // 遍历已加载的配置，按地址去重后返回全部端点
+    static std::vector<IpcEndpoint> collect_endpoints();
+};
+
+#endif // ENDPOINT_PROBE_H
@@ -0,0 +1,49 @@
+#include "event_bus.h"
+#include "metric_sampler.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace {
+
+std::mutex events_mutex;
+std::condition_variable events_cv;
+std::deque<SystemEvent> events;
+uint64_t next_id = 1;
+
+} // namespace
+
+uint64_t EventBus::publish(const std::string& source, const std::string& status,
+                           const std::string& message, const std::string& details) {
+    uint64_t id = 0;
+    {
+        std::lock_guard<std::mutex> lock(events_mutex);
+        id = next_id++;
+        events.push_back({id, MetricSampler::now_ms(), source, status, message, details});
+        if (events.size() > CAPACITY) {
+            events.pop_front();
+        }
+    }
+    events_cv.notify_all();
+    return id;
+}
+
+std::vector<SystemEvent> EventBus::wait_after(uint64_t after_id, std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(events_mutex);
+    events_cv.wait_for(lock, timeout, [after_id] {
+        return !events.empty() && events.back().id > after_id;
+    });
+
+    std::vector<SystemEvent> result;
+    for (const auto& event : events) {
+        if (event.id > after_id) {
+            result.push_back(event);
+        }
+    }
+    return result;
+}
+
+uint64_t EventBus::latest_id() {
+    std::lock_guard<std::mutex> lock(events_mutex);
+    return next_id - 1;
+}
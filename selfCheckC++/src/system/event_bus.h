@@ -0,0 +1,37 @@
+#ifndef EVENT_BUS_H
+#define EVENT_BUS_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 主动推送的系统事件（如内存压力告警）
+struct SystemEvent {
+    uint64_t id = 0;            // 单调递增，客户端据此续传
+    int64_t timestamp_ms = 0;   // Unix 毫秒时间戳
+    std::string source;         // 事件来源，与检测项名称一致，如 "memory"
+    std::string status;         // success / warning / error
+    std::string message;
+    std::string details;        // 可选的 JSON 附加数据
+};
+
+// 进程内事件总线：监控线程发布事件，/api/v1/events 连接阻塞等待新事件。
+// 只保留最近的 CAPACITY 条事件，慢速客户端会丢失更早的事件
+class EventBus {
+public:
+    // 发布事件并唤醒所有等待者，返回事件编号
+    static uint64_t publish(const std::string& source, const std::string& status,
+                            const std::string& message, const std::string& details = "");
+
+    // 返回编号大于 after_id 的事件；没有时最多等待 timeout，超时返回空
+    static std::vector<SystemEvent> wait_after(uint64_t after_id, std::chrono::milliseconds timeout);
+
+    // 最新事件编号（尚无事件时为 0）
+    static uint64_t latest_id();
+
+private:
+    static constexpr size_t CAPACITY = 256;
+};
+
+#endif // EVENT_BUS_H
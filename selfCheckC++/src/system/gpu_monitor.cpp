@@ -0,0 +1,237 @@
+#include "gpu_monitor.h"
+#include "metric_sampler.h"
+#include "../config/config_manager.h"
+#include "../utils/logger.h"
+#include "../utils/monotonic_clock.h"
+#include <algorithm>
+#include <filesystem>
+#include <numeric>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+// 静态成员初始化
+std::mutex GpuMonitor::mutex;
+SysfsReader GpuMonitor::trans_stat_reader;
+SysfsReader GpuMonitor::load_reader;
+SysfsReader GpuMonitor::cur_freq_reader;
+SysfsReader GpuMonitor::max_freq_reader;
+std::string GpuMonitor::devfreq_path;
+std::vector<size_t> GpuMonitor::order;
+std::vector<long> GpuMonitor::frequencies_hz;
+std::vector<GpuMonitor::Sample> GpuMonitor::ring;
+size_t GpuMonitor::head = 0;
+size_t GpuMonitor::count = 0;
+int GpuMonitor::load_percent = -1;
+long GpuMonitor::cur_freq_hz = -1;
+long GpuMonitor::limit_freq_hz = -1;
+int GpuMonitor::busy_percent = 80;
+int GpuMonitor::top_residency_percent = 50;
+
+namespace {
+
+// 统计窗口（秒），环形缓冲按最长窗口分配
+constexpr int WINDOW_SECONDS[] = {10, 60, 300};
+constexpr int LONGEST_WINDOW = 300;
+// 限频判定使用的窗口下标（60 秒）及其最短有效覆盖时长
+constexpr size_t THROTTLE_WINDOW = 1;
+constexpr double MIN_COVERED_SECONDS = 5.0;
+
+// RK3588 GPU devfreq 目录（与 SystemCheck::GPU_FREQ_PATHS 对应）
+const std::vector<std::string> DEVFREQ_DIRS = {
+    "/sys/class/devfreq/fb000000.gpu",
+    "/sys/devices/platform/fb000000.gpu/devfreq/fb000000.gpu",
+    "/sys/class/misc/mali0/device/devfreq",
+    "/sys/class/devfreq/ff9a0000.gpu"  // 旧版内核路径
+};
+
+// devfreq 不提供 load 时的 Mali 驱动利用率节点
+const std::vector<std::string> MALI_UTILISATION_PATHS = {
+    "/sys/devices/platform/fb000000.gpu/utilisation",
+    "/sys/class/misc/mali0/device/utilisation"
+};
+
+std::string find_devfreq_dir(const std::string& configured) {
+    std::error_code ec;
+    if (!configured.empty()) {
+        return fs::exists(configured + "/cur_freq", ec) ? configured : std::string();
+    }
+    for (const auto& dir : DEVFREQ_DIRS) {
+        if (fs::exists(dir + "/cur_freq", ec)) return dir;
+    }
+    // 其他平台：按名称匹配 devfreq 设备
+    for (const auto& entry : fs::directory_iterator("/sys/class/devfreq", ec)) {
+        const std::string name = entry.path().filename().string();
+        if (name.find("gpu") != std::string::npos || name.find("mali") != std::string::npos) {
+            return entry.path().string();
+        }
+    }
+    return {};
+}
+
+uint64_t delta(uint64_t now, uint64_t before) {
+    // trans_stat 可被写 0 清零，出现回退时按 0 处理
+    return now >= before ? now - before : 0;
+}
+
+} // namespace
+
+void GpuMonitor::initialize() {
+    YAML::Node config = ConfigManager::get_system_config();
+    busy_percent = config["gpu_busy_percent"].as<int>(80);
+    top_residency_percent = config["gpu_top_residency_percent"].as<int>(50);
+    int sample_hz = std::max(1, config["gpu_sample_hz"].as<int>(2));
+
+    devfreq_path = find_devfreq_dir(config["gpu_devfreq_path"].as<std::string>(""));
+    if (devfreq_path.empty()) {
+        Logger::warning("未找到GPU devfreq目录，GPU调频监控不可用");
+        return;
+    }
+
+    cur_freq_reader.open({devfreq_path + "/cur_freq"});
+    max_freq_reader.open({devfreq_path + "/max_freq"});
+    std::vector<std::string> load_paths = {devfreq_path + "/load"};
+    load_paths.insert(load_paths.end(), MALI_UTILISATION_PATHS.begin(), MALI_UTILISATION_PATHS.end());
+    load_reader.open(load_paths);
+
+    proc::FileBuffer<4096> buffer;
+    proc::DevfreqTransStat stat;
+    if (trans_stat_reader.open({devfreq_path + "/trans_stat"}) &&
+        buffer.load(trans_stat_reader) && proc::parse_trans_stat(buffer.view(), stat)) {
+        order.resize(stat.state_count);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&stat](size_t a, size_t b) {
+            return stat.frequency_hz[a] < stat.frequency_hz[b];
+        });
+        for (size_t index : order) {
+            frequencies_hz.push_back(static_cast<long>(stat.frequency_hz[index]));
+        }
+    } else {
+        trans_stat_reader.close();
+        Logger::warning("GPU trans_stat 不可用（内核未开启 devfreq 统计），仅记录频率与负载");
+    }
+
+    ring.assign(static_cast<size_t>(LONGEST_WINDOW * sample_hz + 1), Sample());
+
+    std::ostringstream oss;
+    oss << "GPU devfreq: " << devfreq_path << "，频点数 " << frequencies_hz.size()
+        << "，负载节点: " << (load_reader.is_open() ? load_reader.path() : std::string("无"));
+    Logger::info(oss.str());
+
+    MetricSampler::register_task("gpu", std::chrono::milliseconds(1000 / sample_hz), &GpuMonitor::sample);
+}
+
+void GpuMonitor::sample() {
+    if (devfreq_path.empty()) return;
+
+    proc::FileBuffer<4096> buffer;
+    proc::DevfreqTransStat stat;
+    bool have_stat = trans_stat_reader.is_open() && buffer.load(trans_stat_reader) &&
+                     proc::parse_trans_stat(buffer.view(), stat) && stat.state_count == order.size();
+
+    long load = -1;
+    long freq = -1;
+    long limit = -1;
+    load_reader.read_long(load);  // "45@800000000Hz" 或纯百分比，只取前导数字
+    cur_freq_reader.read_long(freq);
+    max_freq_reader.read_long(limit);
+
+    // 负载积分与窗口选择按单调时钟计时：无 RTC 的板子在 NTP/GPS 校时时墙上时间会跳变
+    const int64_t now = monotonic_ms();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Sample next = count > 0 ? ring[(head + ring.size() - 1) % ring.size()] : Sample();
+        const int64_t elapsed = count > 0 ? now - next.time_ms : 0;
+        next.time_ms = now;
+        if (load >= 0 && elapsed > 0) {
+            next.load_integral += static_cast<uint64_t>(load) * static_cast<uint64_t>(elapsed);
+            next.load_time_ms += static_cast<uint64_t>(elapsed);
+        }
+        if (have_stat) {
+            next.transitions = stat.total_transitions;
+            for (size_t i = 0; i < order.size(); ++i) {
+                next.residency_ms[i] = stat.time_ms[order[i]];
+            }
+        }
+        ring[head] = next;
+        head = (head + 1) % ring.size();
+        count = std::min(count + 1, ring.size());
+
+        load_percent = static_cast<int>(load);
+        cur_freq_hz = freq;
+        limit_freq_hz = limit;
+    }
+
+    if (freq > 0) MetricSampler::record("gpu.freq_mhz", freq / 1e6);
+    if (load >= 0) MetricSampler::record("gpu.load", static_cast<double>(load));
+}
+
+GpuSnapshot GpuMonitor::get_snapshot() {
+    GpuSnapshot snapshot;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (devfreq_path.empty()) return snapshot;
+
+    snapshot.available = true;
+    snapshot.devfreq_path = devfreq_path;
+    snapshot.frequencies_hz = frequencies_hz;
+    snapshot.cur_freq_hz = cur_freq_hz;
+    snapshot.limit_freq_hz = limit_freq_hz;
+    snapshot.load_percent = load_percent;
+    if (count == 0) return snapshot;
+
+    const Sample& latest = ring[(head + ring.size() - 1) % ring.size()];
+    for (int seconds : WINDOW_SECONDS) {
+        // 从最新样本向前找到窗口内最早的样本
+        const Sample* oldest = &latest;
+        for (size_t back = 1; back < count; ++back) {
+            const Sample& candidate = ring[(head + ring.size() - 1 - back) % ring.size()];
+            if (candidate.time_ms < latest.time_ms - seconds * 1000LL) break;
+            oldest = &candidate;
+        }
+
+        GpuResidencyWindow window;
+        window.seconds = seconds;
+        window.covered_seconds = (latest.time_ms - oldest->time_ms) / 1000.0;
+
+        uint64_t total_ms = 0;
+        for (size_t i = 0; i < frequencies_hz.size(); ++i) {
+            total_ms += delta(latest.residency_ms[i], oldest->residency_ms[i]);
+        }
+        for (size_t i = 0; i < frequencies_hz.size(); ++i) {
+            uint64_t state_ms = delta(latest.residency_ms[i], oldest->residency_ms[i]);
+            window.residency_percent.push_back(total_ms > 0 ? 100.0 * state_ms / total_ms : 0.0);
+        }
+        if (window.covered_seconds > 0) {
+            window.transitions_per_second =
+                delta(latest.transitions, oldest->transitions) / window.covered_seconds;
+        }
+        uint64_t load_ms = delta(latest.load_time_ms, oldest->load_time_ms);
+        if (load_ms > 0) {
+            window.average_load = static_cast<double>(delta(latest.load_integral, oldest->load_integral)) / load_ms;
+        }
+        snapshot.windows.push_back(std::move(window));
+    }
+    return snapshot;
+}
+
+std::vector<std::string> GpuMonitor::throttle_warnings(const GpuSnapshot& snapshot) {
+    std::vector<std::string> warnings;
+    if (!snapshot.available || snapshot.frequencies_hz.empty()) return warnings;
+
+    const long top_freq = snapshot.frequencies_hz.back();
+    if (snapshot.limit_freq_hz > 0 && snapshot.limit_freq_hz < top_freq) {
+        warnings.push_back("最高频被限制在 " + std::to_string(snapshot.limit_freq_hz / 1000000) + " MHz");
+    }
+
+    if (snapshot.windows.size() > THROTTLE_WINDOW) {
+        const GpuResidencyWindow& window = snapshot.windows[THROTTLE_WINDOW];
+        if (window.covered_seconds >= MIN_COVERED_SECONDS && window.average_load >= busy_percent &&
+            !window.residency_percent.empty() && window.residency_percent.back() < top_residency_percent) {
+            std::ostringstream oss;
+            oss << "近" << window.seconds << "秒负载 " << static_cast<int>(window.average_load + 0.5)
+                << "% 但最高频驻留仅 " << static_cast<int>(window.residency_percent.back() + 0.5) << "%";
+            warnings.push_back(oss.str());
+        }
+    }
+    return warnings;
+}
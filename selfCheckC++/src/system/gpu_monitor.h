@@ -0,0 +1,80 @@
+#ifndef GPU_MONITOR_H
+#define GPU_MONITOR_H
+
+#include "../utils/proc_parser.h"
+#include "../utils/sysfs_reader.h"
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 一个滑动窗口内的 GPU 调频统计
+struct GpuResidencyWindow {
+    int seconds = 0;                       // 窗口长度
+    double covered_seconds = 0.0;          // 实际覆盖时长（启动初期小于窗口长度）
+    std::vector<double> residency_percent; // 各频点驻留占比，与 GpuSnapshot::frequencies_hz 对应
+    double transitions_per_second = 0.0;
+    double average_load = -1.0;            // 窗口内平均负载（%），无负载节点时为 -1
+};
+
+// GPU DVFS 快照
+struct GpuSnapshot {
+    bool available = false;
+    std::string devfreq_path;
+    std::vector<long> frequencies_hz;      // 可用频点，升序
+    long cur_freq_hz = -1;
+    long limit_freq_hz = -1;               // devfreq max_freq，温控限频时会被下调
+    int load_percent = -1;
+    std::vector<GpuResidencyWindow> windows;
+};
+
+// 基于 devfreq trans_stat / load 的 GPU 调频监控：
+// 周期性记录各频点的累计驻留时间，按滑动窗口做差得到时间占比与切换速率
+class GpuMonitor {
+public:
+    // 发现 GPU devfreq 节点并注册后台采样任务
+    static void initialize();
+
+    // 执行一次采样，供采样线程调用
+    static void sample();
+
+    // 按各滑动窗口计算当前统计
+    static GpuSnapshot get_snapshot();
+
+    // 判断是否疑似被限频，返回告警描述（为空表示正常）
+    static std::vector<std::string> throttle_warnings(const GpuSnapshot& snapshot);
+
+private:
+    // 环形缓冲中的一次累计量记录
+    struct Sample {
+        int64_t time_ms = 0;           // 单调时钟，只用于计算间隔与窗口，不对外展示
+        uint64_t transitions = 0;
+        uint64_t load_integral = 0;    // Σ 负载% × 间隔ms
+        uint64_t load_time_ms = 0;     // 有负载读数的累计时长
+        std::array<uint64_t, proc::DevfreqTransStat::MAX_STATES> residency_ms{};
+    };
+
+    static std::mutex mutex;
+    static SysfsReader trans_stat_reader;
+    static SysfsReader load_reader;
+    static SysfsReader cur_freq_reader;
+    static SysfsReader max_freq_reader;
+    static std::string devfreq_path;
+
+    // order[i] 为第 i 低频点在 trans_stat 中的下标
+    static std::vector<size_t> order;
+    static std::vector<long> frequencies_hz;
+
+    static std::vector<Sample> ring;
+    static size_t head;
+    static size_t count;
+    static int load_percent;
+    static long cur_freq_hz;
+    static long limit_freq_hz;
+
+    static int busy_percent;
+    static int top_residency_percent;
+};
+
+#endif // GPU_MONITOR_H
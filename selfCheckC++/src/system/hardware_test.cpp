@@ -0,0 +1,395 @@
+#include "hardware_test.h"
+#include "check_context.h"
+#include "cpu_monitor.h"
+#include "process_monitor.h"
+#include "../config/config_manager.h"
+#include "../utils/file_utils.h"
+#include "../utils/logger.h"
+#include "../utils/monotonic_clock.h"
+#include "../utils/proc_parser.h"
+#include "../utils/sysfs_reader.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <sched.h>
+#include <sstream>
+#include <thread>
+#include <time.h>
+#include <vector>
+
+namespace {
+
+// 128 位向量：ARM 上编译为 NEON，x86 上为 SSE；单精度乘加在 aarch64 上收缩为 fmla
+using vdouble = double __attribute__((vector_size(16)));
+using vfloat = float __attribute__((vector_size(16)));
+
+constexpr size_t DOUBLES_PER_VECTOR = sizeof(vdouble) / sizeof(double);
+constexpr size_t FLOATS_PER_VECTOR = sizeof(vfloat) / sizeof(float);
+constexpr int FMA_CHAINS = 8;                // 独立累加链数，覆盖 FMA 流水线延迟
+constexpr uint64_t FMA_CHUNK = 1 << 16;      // 每批迭代后检查一次时间
+constexpr size_t MIN_ARRAY_BYTES = 8u << 20;
+constexpr size_t MAX_ARRAY_BYTES = 64u << 20;
+constexpr int MAX_CONFIGURED_ARRAY_MB = 128;  // hardware_test_array_mb 上限，三个数组共 384 MB
+// hardware 检测超时为 12 s：预算上限 8 s，最少两轮的要求最多再用到预算的 1/4，
+// 其余留给分配、初始化数组和最后一轮超出的部分
+constexpr int MAX_BUDGET_MS = 8000;
+constexpr double STREAM_SCALAR = 3.0;
+
+std::mutex run_mutex;   // 同一时刻只允许一次测试
+
+void stream_copy(vdouble* __restrict c, const vdouble* __restrict a, size_t n) {
+    for (size_t i = 0; i < n; ++i) c[i] = a[i];
+}
+
+void stream_scale(vdouble* __restrict b, const vdouble* __restrict c, size_t n) {
+    for (size_t i = 0; i < n; ++i) b[i] = STREAM_SCALAR * c[i];
+}
+
+void stream_add(vdouble* __restrict c, const vdouble* __restrict a, const vdouble* __restrict b, size_t n) {
+    for (size_t i = 0; i < n; ++i) c[i] = a[i] + b[i];
+}
+
+void stream_triad(vdouble* __restrict a, const vdouble* __restrict b, const vdouble* __restrict c, size_t n) {
+    for (size_t i = 0; i < n; ++i) a[i] = b[i] + STREAM_SCALAR * c[i];
+}
+
+// 在 duration_ms 内反复执行 FMA_CHAINS 条互不依赖的向量乘加链，返回 GFLOPS
+double fma_gflops(int duration_ms) {
+    volatile float seed = 1.0f;   // 防止编译期求值
+    const vfloat mul = vfloat{} + 0.999999f * seed;
+    const vfloat add = vfloat{} + 1e-6f * seed;
+    vfloat a0 = vfloat{} + 0.1f * seed, a1 = a0 + 0.1f, a2 = a1 + 0.1f, a3 = a2 + 0.1f;
+    vfloat a4 = a3 + 0.1f, a5 = a4 + 0.1f, a6 = a5 + 0.1f, a7 = a6 + 0.1f;
+
+    const int64_t start = monotonic_ns();
+    const int64_t end = start + static_cast<int64_t>(duration_ms) * 1000000;
+    uint64_t iterations = 0;
+    int64_t now = start;
+    do {
+        for (uint64_t i = 0; i < FMA_CHUNK; ++i) {
+            a0 = a0 * mul + add;
+            a1 = a1 * mul + add;
+            a2 = a2 * mul + add;
+            a3 = a3 * mul + add;
+            a4 = a4 * mul + add;
+            a5 = a5 * mul + add;
+            a6 = a6 * mul + add;
+            a7 = a7 * mul + add;
+        }
+        iterations += FMA_CHUNK;
+        now = monotonic_ns();
+    } while (now < end && !CheckContext::cancelled());
+
+    const vfloat sum = a0 + a1 + a2 + a3 + a4 + a5 + a6 + a7;
+    seed = sum[0] + sum[FLOATS_PER_VECTOR - 1];
+    const double flops = 2.0 * FLOATS_PER_VECTOR * FMA_CHAINS * static_cast<double>(iterations);
+    return flops / static_cast<double>(now - start);
+}
+
+double median(std::vector<double> values) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    const size_t middle = values.size() / 2;
+    return values.size() % 2 ? values[middle] : (values[middle - 1] + values[middle]) / 2.0;
+}
+
+struct Metric {
+    const char* key;
+    double CoreThroughput::*value;
+};
+
+constexpr Metric METRICS[] = {
+    {"copy_mb_s", &CoreThroughput::copy_mb_s},
+    {"scale_mb_s", &CoreThroughput::scale_mb_s},
+    {"add_mb_s", &CoreThroughput::add_mb_s},
+    {"triad_mb_s", &CoreThroughput::triad_mb_s},
+    {"gflops", &CoreThroughput::gflops},
+};
+
+std::string format_value(double value) {
+    std::ostringstream out;
+    out.setf(std::ios::fixed);
+    out.precision(value >= 100.0 ? 0 : 1);
+    out << value;
+    return out.str();
+}
+
+} // namespace
+
+void HardwareTest::measure(CoreThroughput& result, double* a, double* b, double* c, size_t elements,
+                           int budget_ms, int fma_ms, int64_t hard_deadline_ns) {
+    const int64_t deadline = monotonic_ns() + static_cast<int64_t>(budget_ms) * 1000000;
+    result.gflops = fma_gflops(fma_ms);
+
+    auto* va = reinterpret_cast<vdouble*>(a);
+    auto* vb = reinterpret_cast<vdouble*>(b);
+    auto* vc = reinterpret_cast<vdouble*>(c);
+    const size_t n = elements / DOUBLES_PER_VECTOR;
+    const double bytes2 = 2.0 * sizeof(double) * static_cast<double>(n * DOUBLES_PER_VECTOR);
+    const double bytes3 = 3.0 * sizeof(double) * static_cast<double>(n * DOUBLES_PER_VECTOR);
+
+    // 与 STREAM 相同：第一轮用于预热（TLB、频率爬升），之后各内核取最短时间
+    int64_t best[4] = {INT64_MAX, INT64_MAX, INT64_MAX, INT64_MAX};
+    for (int round = 0; (round < 2 || monotonic_ns() < deadline) && monotonic_ns() < hard_deadline_ns &&
+                        !CheckContext::cancelled(); ++round) {
+        int64_t times[4];
+        int64_t t0 = monotonic_ns();
+        stream_copy(vc, va, n);
+        int64_t t1 = monotonic_ns();
+        times[0] = t1 - t0;
+        stream_scale(vb, vc, n);
+        t0 = monotonic_ns();
+        times[1] = t0 - t1;
+        stream_add(vc, va, vb, n);
+        t1 = monotonic_ns();
+        times[2] = t1 - t0;
+        stream_triad(va, vb, vc, n);
+        times[3] = monotonic_ns() - t1;
+        if (round > 0) {
+            for (int k = 0; k < 4; ++k) best[k] = std::min(best[k], std::max<int64_t>(times[k], 1));
+            result.rounds = round;
+        }
+    }
+    if (result.rounds == 0) {
+        result.error = CheckContext::cancelled() ? "已取消" : "超出测试时长，未完成两轮";
+        return;
+    }
+    // 字节/纳秒 * 1000 = MB/s
+    result.copy_mb_s = bytes2 / static_cast<double>(best[0]) * 1000.0;
+    result.scale_mb_s = bytes2 / static_cast<double>(best[1]) * 1000.0;
+    result.add_mb_s = bytes3 / static_cast<double>(best[2]) * 1000.0;
+    result.triad_mb_s = bytes3 / static_cast<double>(best[3]) * 1000.0;
+}
+
+std::string HardwareTest::board_model() {
+    SysfsReader reader({"/proc/device-tree/model", "/sys/firmware/devicetree/base/model",
+                        "/sys/class/dmi/id/product_name"});
+    char buffer[256];
+    const ssize_t length = reader.read(buffer, sizeof(buffer));
+    if (length <= 0) return "";
+    std::string model(buffer, static_cast<size_t>(length));
+    // 设备树属性以 NUL 结尾，DMI 以换行结尾
+    model = model.substr(0, model.find_first_of(std::string("\0\n", 2)));
+    return model;
+}
+
+size_t HardwareTest::last_level_cache_bytes() {
+    size_t largest = 0;
+    int highest_level = 0;
+    for (int index = 0; index < 8; ++index) {
+        const std::string base = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + "/";
+        SysfsReader level_reader({base + "level"});
+        SysfsReader size_reader({base + "size"});
+        long level = 0;
+        if (!level_reader.read_long(level) || !size_reader.is_open()) continue;
+        char buffer[32];
+        const ssize_t length = size_reader.read(buffer, sizeof(buffer) - 1);
+        if (length <= 0) continue;
+        buffer[length] = '\0';
+        char* suffix = nullptr;
+        size_t bytes = std::strtoull(buffer, &suffix, 10);
+        if (*suffix == 'K') bytes <<= 10;
+        else if (*suffix == 'M') bytes <<= 20;
+        if (level > highest_level || (level == highest_level && bytes > largest)) {
+            highest_level = static_cast<int>(level);
+            largest = bytes;
+        }
+    }
+    return largest;
+}
+
+SystemCheckResult HardwareTest::check() {
+    Logger::info("执行硬件自测");
+
+    std::unique_lock<std::mutex> running(run_mutex, std::try_to_lock);
+    if (!running.owns_lock()) {
+        return {"warning", "硬件自测正在进行中"};
+    }
+    // 测试占满内存带宽与各核算力，任务进行中绝不执行
+    YAML::Node config = ConfigManager::get_system_config();
+    std::string reason;
+    if (ProcessMonitor::self_test_blocked(config, "hardware_test_mission_processes", reason)) {
+        return {"warning", reason + "，跳过硬件自测"};
+    }
+
+    const int budget_ms = std::clamp(config["hardware_test_budget_ms"].as<int>(3000), 200, MAX_BUDGET_MS);
+    const int array_mb = std::clamp(config["hardware_test_array_mb"].as<int>(0), 0, MAX_CONFIGURED_ARRAY_MB);
+    const double tolerance = config["hardware_test_tolerance_percent"].as<double>(15.0) / 100.0;
+    const double outlier = config["hardware_test_outlier_percent"].as<double>(20.0) / 100.0;
+
+    std::vector<int> cpus;
+    if (config["hardware_test_cpus"] && config["hardware_test_cpus"].IsSequence() &&
+        config["hardware_test_cpus"].size() > 0) {
+        for (const auto& node : config["hardware_test_cpus"]) cpus.push_back(node.as<int>());
+    } else {
+        cpus = proc::parse_cpu_list(FileUtils::read_file("/sys/devices/system/cpu/online"));
+    }
+    if (cpus.empty()) {
+        return {"error", "无法确定要测试的 CPU"};
+    }
+
+    // STREAM 要求每个数组至少为末级缓存的 4 倍；未配置时据此取值并限制在 8-64 MB
+    const size_t llc_bytes = last_level_cache_bytes();
+    size_t array_bytes = array_mb > 0 ? static_cast<size_t>(array_mb) << 20
+                                      : std::clamp(llc_bytes * 4, MIN_ARRAY_BYTES, MAX_ARRAY_BYTES);
+    array_bytes &= ~static_cast<size_t>(63);
+    const size_t elements = array_bytes / sizeof(double);
+    std::vector<double*> arrays;
+    for (int i = 0; i < 3; ++i) {
+        auto* array = static_cast<double*>(std::aligned_alloc(64, array_bytes));
+        if (array == nullptr) {
+            for (double* allocated : arrays) std::free(allocated);
+            return {"error", "无法分配 " + std::to_string(array_bytes >> 20) + " MB 测试数组"};
+        }
+        arrays.push_back(array);
+    }
+    std::fill(arrays[0], arrays[0] + elements, 1.0);
+    std::fill(arrays[1], arrays[1] + elements, 2.0);
+    std::fill(arrays[2], arrays[2] + elements, 0.0);
+
+    const CpuSnapshot snapshot = CpuMonitor::get_snapshot();
+    std::vector<int> big_cpus;
+    for (const auto& cluster : snapshot.clusters) {
+        if (cluster.big) big_cpus.insert(big_cpus.end(), cluster.cpus.begin(), cluster.cpus.end());
+    }
+    std::vector<CoreThroughput> results(cpus.size());
+    for (size_t i = 0; i < cpus.size(); ++i) {
+        results[i].cpu = cpus[i];
+        results[i].big = big_cpus.empty() || std::find(big_cpus.begin(), big_cpus.end(), cpus[i]) != big_cpus.end();
+    }
+
+    // 在独立线程中逐核绑定测量，不改变检测线程池线程的亲和性与调度策略
+    const int core_ms = std::max(budget_ms / static_cast<int>(cpus.size()), 50);
+    const int fma_ms = std::max(core_ms / 5, 10);
+    const int64_t hard_deadline_ns = monotonic_ns() + static_cast<int64_t>(budget_ms + budget_ms / 4) * 1000000;
+    const CheckContext::CancelToken token = CheckContext::token();
+    std::thread worker([&]() {
+        CheckContext::Scope scope(token);
+        sched_param param{};
+        sched_setscheduler(0, SCHED_OTHER, &param);
+        for (auto& result : results) {
+            if (monotonic_ns() >= hard_deadline_ns) {
+                result.error = "超出测试时长，未测量";
+                continue;
+            }
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(result.cpu, &set);
+            if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+                result.error = std::string("绑定 CPU 失败: ") + strerror(errno);
+                continue;
+            }
+            measure(result, arrays[0], arrays[1], arrays[2], elements, core_ms, fma_ms, hard_deadline_ns);
+            SysfsReader freq({"/sys/devices/system/cpu/cpu" + std::to_string(result.cpu) + "/cpufreq/scaling_cur_freq"});
+            freq.read_long(result.freq_khz);
+        }
+    });
+    worker.join();
+    for (double* array : arrays) std::free(array);
+
+    // 同类核心的中位数：既用于发现离群的单个核心，也可作为同型号板子的基线参考
+    const std::string model = board_model();
+    YAML::Node baseline;
+    std::string baseline_key;
+    if (config["hardware_test_baselines"] && config["hardware_test_baselines"].IsMap()) {
+        for (const auto& entry : config["hardware_test_baselines"]) {
+            const std::string key = entry.first.as<std::string>();
+            if (!key.empty() && model.find(key) != std::string::npos) {
+                baseline = entry.second;
+                baseline_key = key;
+                break;
+            }
+        }
+    }
+
+    std::vector<std::string> problems;
+    nlohmann::json measured_baseline = nlohmann::json::object();
+    std::ostringstream summary;
+    size_t measured = 0;
+    for (const bool big : {true, false}) {
+        const char* group = big ? "big" : "little";
+        std::vector<const CoreThroughput*> members;
+        for (const auto& result : results) {
+            if (result.big == big && result.error.empty()) members.push_back(&result);
+        }
+        if (members.empty()) continue;
+        measured += members.size();
+
+        const YAML::Node group_baseline = baseline.IsMap() ? baseline[group] : YAML::Node();
+        nlohmann::json medians = nlohmann::json::object();
+        for (const Metric& metric : METRICS) {
+            std::vector<double> values;
+            for (const CoreThroughput* member : members) values.push_back(member->*metric.value);
+            const double middle = median(values);
+            medians[metric.key] = middle;
+            for (const CoreThroughput* member : members) {
+                const double value = member->*metric.value;
+                if (members.size() >= 2 && value < middle * (1.0 - outlier)) {
+                    problems.push_back("CPU" + std::to_string(member->cpu) + " " + metric.key + " " +
+                                       format_value(value) + " 低于同簇中位数 " + format_value(middle));
+                }
+            }
+            const YAML::Node expected = group_baseline.IsMap() ? group_baseline[metric.key] : YAML::Node();
+            if (expected.IsScalar()) {
+                const double reference = expected.as<double>();
+                for (const CoreThroughput* member : members) {
+                    const double value = member->*metric.value;
+                    if (value < reference * (1.0 - tolerance)) {
+                        problems.push_back("CPU" + std::to_string(member->cpu) + " " + metric.key + " " +
+                                           format_value(value) + " 低于基线 " + format_value(reference));
+                    }
+                }
+            }
+        }
+        measured_baseline[group] = medians;
+        summary << (summary.tellp() > 0 ? "; " : "") << (big ? "大核" : "小核") << " triad "
+                << format_value(medians["triad_mb_s"].get<double>()) << " MB/s, FMA "
+                << format_value(medians["gflops"].get<double>()) << " GFLOPS";
+    }
+
+    nlohmann::json list = nlohmann::json::array();
+    for (const auto& result : results) {
+        nlohmann::json entry = {{"cpu", result.cpu}, {"big", result.big}};
+        if (!result.error.empty()) {
+            entry["error"] = result.error;
+            problems.push_back("CPU" + std::to_string(result.cpu) + " " + result.error);
+        } else {
+            for (const Metric& metric : METRICS) entry[metric.key] = result.*metric.value;
+            entry["freq_khz"] = result.freq_khz;
+            entry["rounds"] = result.rounds;
+        }
+        list.push_back(std::move(entry));
+    }
+
+    std::string status = problems.empty() ? "success" : "warning";
+    std::ostringstream message;
+    if (measured == 0) {
+        status = "error";
+        message << "硬件自测失败";
+    } else {
+        message << measured << " 个 CPU，数组 3x" << (array_bytes >> 20) << " MB: " << summary.str();
+        if (baseline_key.empty()) message << "（未配置板型基线）";
+    }
+    if (!problems.empty()) {
+        message << " [";
+        for (size_t i = 0; i < problems.size(); ++i) message << (i ? "; " : "") << problems[i];
+        message << "]";
+    }
+
+    nlohmann::json details = {
+        {"board_model", model},
+        {"baseline", baseline_key},
+        {"llc_bytes", llc_bytes},
+        {"array_bytes", array_bytes},
+        {"array_exceeds_llc", array_bytes >= llc_bytes * 4},
+        {"budget_ms", budget_ms},
+        {"tolerance_percent", tolerance * 100.0},
+        {"outlier_percent", outlier * 100.0},
+        {"measured_baseline", measured_baseline},
+        {"cpus", list}
+    };
+    return {status, message.str(), details.dump()};
+}
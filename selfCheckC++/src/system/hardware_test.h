@@ -0,0 +1,47 @@
+#ifndef HARDWARE_TEST_H
+#define HARDWARE_TEST_H
+
+#include "../types/common_types.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// 单个 CPU 上的内存带宽（MB/s，1 MB = 10^6 字节，与 STREAM 一致）与浮点算力
+struct CoreThroughput {
+    int cpu = -1;
+    bool big = false;
+    std::string error;
+    double copy_mb_s = 0.0;
+    double scale_mb_s = 0.0;
+    double add_mb_s = 0.0;
+    double triad_mb_s = 0.0;
+    double gflops = 0.0;         // 单精度 FMA，每次乘加计 2 次浮点运算
+    long freq_khz = -1;          // 测量结束时的 scaling_cur_freq
+    int rounds = 0;              // STREAM 四个内核完整执行的轮数，各取最好一轮
+};
+
+// 硬件自测：把测量线程依次绑定到每个 CPU，先跑一段 SIMD FMA 计算内核，
+// 再以 STREAM 方式循环执行 copy/scale/add/triad（数组不小于末级缓存的 4 倍，
+// 用 GCC 向量扩展显式向量化，ARM 上为 NEON，x86 上为 SSE），各内核取最好一轮。
+// 总时长按配置预算平均分给各 CPU；结果与配置中按板型给出的基线比较，
+// 并与同簇其他核的中位数比较，单个大核或某条 DDR 通道变慢时告警。
+// 测试会占满内存带宽，飞控相关进程运行或系统降载时拒绝执行
+class HardwareTest {
+public:
+    // 硬件自测检测（按需执行）
+    static SystemCheckResult check();
+
+    // 在当前线程（调用者已绑核）上测量，a/b/c 为 64 字节对齐、已触页的 elements 个 double，
+    // fma_ms 用于计算内核，其余时间循环 STREAM 内核直到 budget_ms 用完（至少两轮，
+    // 但不超过 hard_deadline_ns，即 CLOCK_MONOTONIC 纳秒；届时不足两轮则记为错误）
+    static void measure(CoreThroughput& result, double* a, double* b, double* c, size_t elements,
+                        int budget_ms, int fma_ms, int64_t hard_deadline_ns);
+
+    // 板型：设备树 model，x86 上退回 DMI product_name
+    static std::string board_model();
+
+    // 末级缓存大小（字节），未知时返回 0
+    static size_t last_level_cache_bytes();
+};
+
+#endif // HARDWARE_TEST_H
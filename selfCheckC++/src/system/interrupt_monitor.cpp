@@ -0,0 +1,340 @@
+#include "interrupt_monitor.h"
+#include "metric_sampler.h"
+#include "../config/config_manager.h"
+#include "../utils/logger.h"
+#include "../utils/monotonic_clock.h"
+#include "../utils/proc_parser.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <nlohmann/json.hpp>
+#include <sstream>
+
+// 静态成员初始化
+std::mutex InterruptMonitor::mutex;
+InterruptMonitor::CounterMatrix InterruptMonitor::irqs;
+InterruptMonitor::CounterMatrix InterruptMonitor::softirqs;
+int64_t InterruptMonitor::last_sample_ns = 0;
+double InterruptMonitor::last_elapsed_s = 0.0;
+int InterruptMonitor::sample_count = 0;
+double InterruptMonitor::total_rate = 0.0;
+double InterruptMonitor::storm_rate = 20000.0;
+double InterruptMonitor::concentration_percent = 90.0;
+double InterruptMonitor::concentration_min_rate = 5000.0;
+double InterruptMonitor::softirq_rate_warn = 50000.0;
+
+namespace {
+
+// RK3588 的 /proc/interrupts 约 200 行 × 8 列，远小于该缓冲区；放在静态区避免占用采样线程栈
+proc::FileBuffer<65536> text_buffer;
+
+// GCC/Clang 向量扩展：aarch64 上编译为 NEON 的 sub v.4s，x86 上为 SSE2 的 psubd
+typedef uint32_t CountVector __attribute__((vector_size(16)));
+constexpr size_t LANES = sizeof(CountVector) / sizeof(uint32_t);
+
+bool ends_with(std::string_view text, std::string_view suffix) {
+    return text.size() >= suffix.size() && text.substr(text.size() - suffix.size()) == suffix;
+}
+
+// 硬件中断行的描述形如 "GICv3 33 Level rkisp"（x86 为 "IO-APIC 5-edge ACPI:Ged"），
+// 取触发方式之后的部分作为设备名；IPI 等非数字标签直接使用整段描述
+std::string display_name(std::string_view label, std::string_view description, bool interrupts) {
+    if (description.empty()) return std::string(label);
+    if (!interrupts || !proc::is_digits(label)) return std::string(description);
+
+    proc::TokenScanner tokens(description);
+    std::string_view token;
+    std::string_view last;
+    while (tokens.next(token)) {
+        last = token;
+        const bool trigger = token == "Level" || token == "Edge" || ends_with(token, "-edge") ||
+                             ends_with(token, "-level") || ends_with(token, "-fasteoi");
+        if (trigger) {
+            std::string_view rest = tokens.rest();
+            while (!rest.empty() && rest.front() == ' ') rest.remove_prefix(1);
+            if (!rest.empty()) return std::string(rest);
+        }
+    }
+    return std::string(last);
+}
+
+std::string format_rate(double rate) {
+    char buffer[32];
+    if (rate >= 10000) {
+        snprintf(buffer, sizeof(buffer), "%.1fk/s", rate / 1000);
+    } else {
+        snprintf(buffer, sizeof(buffer), "%.0f/s", rate);
+    }
+    return buffer;
+}
+
+} // namespace
+
+void InterruptMonitor::subtract_counts(const uint32_t* current, const uint32_t* previous, uint32_t* delta, size_t size) {
+    // 无符号减法天然按 2^32 回绕，与内核 unsigned int 计数一致
+    for (size_t i = 0; i < size; i += LANES) {
+        CountVector a;
+        CountVector b;
+        std::memcpy(&a, current + i, sizeof(a));
+        std::memcpy(&b, previous + i, sizeof(b));
+        const CountVector d = a - b;
+        std::memcpy(delta + i, &d, sizeof(d));
+    }
+}
+
+void InterruptMonitor::initialize() {
+    YAML::Node config = ConfigManager::get_system_config();
+    storm_rate = config["irq_storm_rate"].as<double>(20000.0);
+    concentration_percent = config["irq_concentration_percent"].as<double>(90.0);
+    concentration_min_rate = config["irq_concentration_min_rate"].as<double>(5000.0);
+    softirq_rate_warn = config["softirq_rate_warn"].as<double>(50000.0);
+    const int sample_hz = std::clamp(config["interrupt_sample_hz"].as<int>(1), 1, 10);
+
+    irqs.path = "/proc/interrupts";
+    softirqs.path = "/proc/softirqs";
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!discover(irqs, true)) {
+            Logger::warning("无法解析 /proc/interrupts，中断监控不可用");
+            return;
+        }
+        if (!discover(softirqs, false)) {
+            Logger::warning("无法解析 /proc/softirqs，软中断监控不可用");
+        }
+        Logger::info("中断矩阵: " + std::to_string(irqs.labels.size()) + " 个中断 × " +
+                     std::to_string(irqs.cpu_ids.size()) + " 个 CPU，" +
+                     std::to_string(softirqs.labels.size()) + " 类软中断");
+    }
+    MetricSampler::register_task("interrupts", std::chrono::milliseconds(1000 / sample_hz), &InterruptMonitor::sample);
+}
+
+bool InterruptMonitor::discover(CounterMatrix& matrix, bool interrupts) {
+    matrix.layout_changed = false;
+    matrix.has_previous = false;
+    matrix.labels.clear();
+    matrix.names.clear();
+    matrix.series.clear();
+    matrix.cpu_ids.clear();
+
+    if (!matrix.reader.is_open() && !matrix.reader.open({matrix.path})) return false;
+    if (!text_buffer.load(matrix.reader)) return false;
+    if (text_buffer.size == sizeof(text_buffer.data)) {
+        Logger::warning(std::string(matrix.path) + " 超过读取缓冲区，末尾的行将被忽略");
+    }
+
+    std::string_view text = text_buffer.view();
+    int cpu_ids[proc::MAX_COUNTER_COLUMNS];
+    const size_t columns = proc::parse_cpu_columns(text.substr(0, text.find('\n')), cpu_ids,
+                                                   proc::MAX_COUNTER_COLUMNS);
+    if (columns == 0) return false;
+    matrix.cpu_ids.assign(cpu_ids, cpu_ids + columns);
+    matrix.stride = (columns + LANES - 1) / LANES * LANES;
+
+    proc::for_each_counter_row(text, columns,
+        [&](std::string_view label, const uint32_t*, size_t, std::string_view description) {
+            matrix.labels.emplace_back(label);
+            matrix.names.push_back(display_name(label, description, interrupts));
+            if (!interrupts) matrix.series.push_back("softirq." + std::string(label) + "_per_s");
+        });
+
+    const size_t rows = matrix.labels.size();
+    matrix.current.assign(rows * matrix.stride, 0);
+    matrix.previous.assign(rows * matrix.stride, 0);
+    matrix.delta.assign(rows * matrix.stride, 0);
+    matrix.rate.assign(rows, 0.0);
+    matrix.peak_share.assign(rows, 0.0);
+    matrix.peak_cpu.assign(rows, -1);
+    return rows > 0;
+}
+
+bool InterruptMonitor::update(CounterMatrix& matrix, double elapsed_s) {
+    if (matrix.layout_changed) {
+        // 驱动加载/卸载导致行变化，重新解析布局（仅此时分配内存）
+        Logger::info(std::string(matrix.path) + " 的行发生变化，重新解析");
+        discover(matrix, &matrix == &irqs);
+        return false;
+    }
+    if (matrix.labels.empty() || !text_buffer.load(matrix.reader)) return false;
+
+    const size_t rows = matrix.labels.size();
+    const size_t columns = matrix.cpu_ids.size();
+    // CPU 上下线会增删列，表头与解析时不一致时按新布局重新解析
+    const std::string_view text = text_buffer.view();
+    int cpu_ids[proc::MAX_COUNTER_COLUMNS];
+    const size_t header_columns = proc::parse_cpu_columns(text.substr(0, text.find('\n')), cpu_ids,
+                                                          proc::MAX_COUNTER_COLUMNS);
+    if (header_columns != columns || !std::equal(cpu_ids, cpu_ids + columns, matrix.cpu_ids.begin())) {
+        matrix.layout_changed = true;
+        return false;
+    }
+
+    size_t position = 0;
+    size_t matched = 0;
+    proc::for_each_counter_row(text, columns,
+        [&](std::string_view label, const uint32_t* counts, size_t count, std::string_view) {
+            // 行顺序通常不变，先按位置比较，不一致时再线性查找
+            size_t row = position;
+            if (row >= rows || matrix.labels[row] != label) {
+                row = 0;
+                while (row < rows && matrix.labels[row] != label) ++row;
+            }
+            ++position;
+            if (row >= rows) {
+                matrix.layout_changed = true;
+                return;
+            }
+            ++matched;
+            uint32_t* target = matrix.current.data() + row * matrix.stride;
+            std::memcpy(target, counts, count * sizeof(uint32_t));
+            std::fill(target + count, target + matrix.stride, 0u);
+        });
+    if (matched < rows) matrix.layout_changed = true;
+    // 行有增减时未匹配的槽位仍是更早的计数，差分会回绕成巨大的速率，本次不计算
+    if (matrix.layout_changed) return false;
+
+    const bool rates = matrix.has_previous && elapsed_s > 0;
+    if (rates) {
+        subtract_counts(matrix.current.data(), matrix.previous.data(), matrix.delta.data(), matrix.current.size());
+        for (size_t row = 0; row < rows; ++row) {
+            const uint32_t* delta = matrix.delta.data() + row * matrix.stride;
+            uint64_t sum = 0;
+            uint32_t peak = 0;
+            size_t peak_column = 0;
+            for (size_t column = 0; column < columns; ++column) {
+                sum += delta[column];
+                if (delta[column] > peak) {
+                    peak = delta[column];
+                    peak_column = column;
+                }
+            }
+            matrix.rate[row] = static_cast<double>(sum) / elapsed_s;
+            matrix.peak_share[row] = sum > 0 ? static_cast<double>(peak) / static_cast<double>(sum) : 0.0;
+            matrix.peak_cpu[row] = sum > 0 ? matrix.cpu_ids[peak_column] : -1;
+        }
+    }
+    matrix.current.swap(matrix.previous);
+    matrix.has_previous = true;
+    return rates;
+}
+
+void InterruptMonitor::sample() {
+    std::lock_guard<std::mutex> lock(mutex);
+    const int64_t now_ns = monotonic_ns();
+    const double elapsed_s = last_sample_ns > 0 ? (now_ns - last_sample_ns) / 1e9 : 0.0;
+    last_sample_ns = now_ns;
+
+    if (update(irqs, elapsed_s)) {
+        total_rate = 0.0;
+        for (double rate : irqs.rate) total_rate += rate;
+        MetricSampler::record("irq.total_per_s", total_rate);
+        last_elapsed_s = elapsed_s;
+    }
+    if (update(softirqs, elapsed_s)) {
+        for (size_t row = 0; row < softirqs.series.size(); ++row) {
+            MetricSampler::record(softirqs.series[row], softirqs.rate[row]);
+        }
+    }
+    ++sample_count;
+}
+
+SystemCheckResult InterruptMonitor::check() {
+    Logger::info("执行中断检测");
+
+    bool ready;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (irqs.labels.empty()) {
+            return {"error", "无法解析 /proc/interrupts"};
+        }
+        ready = irqs.has_previous && last_elapsed_s > 0;
+    }
+    if (!ready) MetricSampler::warm_up(&InterruptMonitor::sample);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<std::string> warnings;
+
+    auto row_json = [](const CounterMatrix& matrix, size_t row, double elapsed_s) {
+        nlohmann::json per_cpu = nlohmann::json::object();
+        const uint32_t* delta = matrix.delta.data() + row * matrix.stride;
+        for (size_t column = 0; column < matrix.cpu_ids.size(); ++column) {
+            per_cpu["cpu" + std::to_string(matrix.cpu_ids[column])] = elapsed_s > 0 ? delta[column] / elapsed_s : 0.0;
+        }
+        return nlohmann::json{
+            {"label", matrix.labels[row]},
+            {"name", matrix.names[row]},
+            {"rate", matrix.rate[row]},
+            {"peak_cpu", matrix.peak_cpu[row]},
+            {"peak_share", matrix.peak_share[row]},
+            {"per_cpu", per_cpu}
+        };
+    };
+
+    // 风暴：总速率过高；集中：速率较高且几乎全部落在一个 CPU 上（单 CPU 系统不判定）
+    auto evaluate = [&](const CounterMatrix& matrix, double limit, const char* kind, std::vector<size_t>& flagged) {
+        for (size_t row = 0; row < matrix.labels.size(); ++row) {
+            const std::string who = std::string(kind) + " " + matrix.labels[row] +
+                                    (matrix.names[row] != matrix.labels[row] ? "(" + matrix.names[row] + ")" : "");
+            if (matrix.rate[row] >= limit) {
+                warnings.push_back(who + " " + format_rate(matrix.rate[row]));
+                flagged.push_back(row);
+            } else if (matrix.cpu_ids.size() > 1 && matrix.rate[row] >= concentration_min_rate &&
+                       matrix.peak_share[row] * 100 >= concentration_percent) {
+                warnings.push_back(who + " 集中在 CPU" + std::to_string(matrix.peak_cpu[row]) + " " +
+                                   std::to_string(static_cast<int>(matrix.peak_share[row] * 100)) + "%");
+                flagged.push_back(row);
+            }
+        }
+    };
+    std::vector<size_t> flagged_irqs;
+    std::vector<size_t> flagged_softirqs;
+    evaluate(irqs, storm_rate, "IRQ", flagged_irqs);
+    evaluate(softirqs, softirq_rate_warn, "软中断", flagged_softirqs);
+
+    // 速率最高的 5 个硬件中断
+    std::vector<size_t> order(irqs.labels.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    const size_t top = std::min<size_t>(5, order.size());
+    std::partial_sort(order.begin(), order.begin() + top, order.end(),
+                      [](size_t a, size_t b) { return irqs.rate[a] > irqs.rate[b]; });
+
+    std::ostringstream message;
+    message << "中断 " << format_rate(total_rate) << " (" << irqs.labels.size() << " 个, "
+            << irqs.cpu_ids.size() << " CPU)";
+    nlohmann::json top_json = nlohmann::json::array();
+    for (size_t i = 0; i < top && irqs.rate[order[i]] > 0; ++i) {
+        const size_t row = order[i];
+        message << (i == 0 ? "; 最高: " : ", ") << irqs.names[row] << " " << format_rate(irqs.rate[row]);
+        top_json.push_back(row_json(irqs, row, last_elapsed_s));
+    }
+
+    nlohmann::json softirq_json = nlohmann::json::array();
+    bool first_softirq = true;
+    for (size_t row = 0; row < softirqs.labels.size(); ++row) {
+        softirq_json.push_back(row_json(softirqs, row, last_elapsed_s));
+        if (softirqs.rate[row] >= 1.0) {
+            message << (first_softirq ? "; 软中断: " : ", ") << softirqs.labels[row] << " " << format_rate(softirqs.rate[row]);
+            first_softirq = false;
+        }
+    }
+
+    nlohmann::json flagged_json = nlohmann::json::array();
+    for (size_t row : flagged_irqs) flagged_json.push_back(row_json(irqs, row, last_elapsed_s));
+    for (size_t row : flagged_softirqs) flagged_json.push_back(row_json(softirqs, row, last_elapsed_s));
+
+    std::string status = "success";
+    if (!warnings.empty()) {
+        status = "warning";
+        message << " [告警:";
+        for (const auto& warning : warnings) message << " " << warning;
+        message << "]";
+    }
+
+    nlohmann::json details = {
+        {"total_rate", total_rate},
+        {"window_s", last_elapsed_s},
+        {"top_irqs", top_json},
+        {"softirqs", softirq_json},
+        {"flagged", flagged_json}
+    };
+    return {status, message.str(), details.dump()};
+}
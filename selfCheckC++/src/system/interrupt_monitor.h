@@ -0,0 +1,64 @@
+#ifndef INTERRUPT_MONITOR_H
+#define INTERRUPT_MONITOR_H
+
+#include "../types/common_types.h"
+#include "../utils/sysfs_reader.h"
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 中断监控：把 /proc/interrupts 与 /proc/softirqs 解析为 行 × CPU 的计数矩阵，
+// 相邻两次采样整体做向量化减法得到速率，标记速率过高（中断风暴）
+// 或集中在单个 CPU 上的中断。稳态采样不做堆分配
+class InterruptMonitor {
+public:
+    // 解析矩阵布局并注册后台采样任务
+    static void initialize();
+
+    // 采样一次并计算速率，供采样线程以 1 Hz 调用
+    static void sample();
+
+    // 中断检测：报告速率最高的中断与软中断，风暴或单核集中时告警
+    static SystemCheckResult check();
+
+    // 对两个计数矩阵做按 2^32 回绕的逐元素减法（size 须为 4 的倍数，供基准测试使用）
+    static void subtract_counts(const uint32_t* current, const uint32_t* previous, uint32_t* delta, size_t size);
+
+private:
+    struct CounterMatrix {
+        const char* path = nullptr;
+        SysfsReader reader;
+        std::vector<int> cpu_ids;          // 列对应的 CPU 编号
+        std::vector<std::string> labels;   // 行标签，如 "45"、"IPI0"、"NET_RX"
+        std::vector<std::string> names;    // 展示名称，如 "eth0"、"Rescheduling interrupts"
+        std::vector<std::string> series;   // 预先生成的指标名称（仅软中断）
+        size_t stride = 0;                 // 每行的列数，向上取整到 4 的倍数
+        std::vector<uint32_t> current;     // 行主序，rows × stride
+        std::vector<uint32_t> previous;
+        std::vector<uint32_t> delta;
+        std::vector<double> rate;          // 每行合计速率（次/秒）
+        std::vector<double> peak_share;    // 速率最高的 CPU 占该行的比例
+        std::vector<int> peak_cpu;
+        bool has_previous = false;
+        bool layout_changed = false;       // 出现未知的行，下次采样前重新解析布局
+    };
+
+    static bool discover(CounterMatrix& matrix, bool interrupts);
+    static bool update(CounterMatrix& matrix, double elapsed_s);
+
+    static std::mutex mutex;
+    static CounterMatrix irqs;
+    static CounterMatrix softirqs;
+    static int64_t last_sample_ns;
+    static double last_elapsed_s;      // 最近一次速率计算的窗口
+    static int sample_count;
+    static double total_rate;
+
+    static double storm_rate;
+    static double concentration_percent;
+    static double concentration_min_rate;
+    static double softirq_rate_warn;
+};
+
+#endif // INTERRUPT_MONITOR_H
@@ -0,0 +1,409 @@
+#include "kernel_log_monitor.h"
+#include "event_bus.h"
+#include "../config/config_manager.h"
+#include "../utils/aho_corasick.h"
+#include "../utils/logger.h"
+#include "../utils/monotonic_clock.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <poll.h>
+#include <sstream>
+#include <string>
+#include <sys/eventfd.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+// /dev/kmsg 单条记录上限约 1 KB 正文加设备信息，缓冲区不足时 read 返回 EINVAL
+constexpr size_t RECORD_BYTES = 8192;
+// 同一模式组推送事件的最小间隔，避免驱动报错刷屏时淹没事件流
+constexpr int64_t EVENT_INTERVAL_US = 10 * 1000000LL;
+// 序号写入状态文件的最小间隔
+constexpr int64_t SAVE_INTERVAL_US = 1000000;
+
+struct PatternGroup {
+    std::string name;
+    std::string level;                 // 命中时的检测状态：warning 或 error
+    std::vector<std::string> patterns;
+    uint64_t count = 0;
+    uint64_t last_sequence = 0;
+    int64_t last_us = -1;              // 最近一次命中的内核时间戳（启动后微秒，与 CLOCK_MONOTONIC 近似）
+    int64_t last_event_us = -1;
+};
+
+struct Hit {
+    uint64_t sequence = 0;
+    int64_t timestamp_us = 0;
+    int level = 0;
+    uint64_t groups = 0;
+    std::string text;
+};
+
+struct DefaultGroup {
+    const char* name;
+    const char* level;
+    std::vector<std::string> patterns;
+};
+
+const std::vector<DefaultGroup> DEFAULT_GROUPS = {
+    {"usb_reset", "warning", {"reset high-speed usb device", "reset superspeed usb device", "reset full-speed usb device"}},
+    {"usb_disconnect", "warning", {"usb disconnect"}},
+    {"uart_overrun", "warning", {"input overrun"}},
+    {"thermal", "error", {"critical temperature", "temperature above threshold", "clock throttled"}},
+    {"oom", "error", {"out of memory", "oom-kill"}},
+    {"io_error", "error", {"i/o error", "blk_update_request", "ext4-fs error"}},
+    {"hung_task", "warning", {"blocked for more than"}},
+    {"segfault", "warning", {" segfault at "}},
+};
+
+std::mutex state_mutex;
+std::vector<PatternGroup> groups;
+std::vector<Hit> hits;                 // 最近命中的环形缓冲
+size_t hit_next = 0;
+uint64_t hit_total = 0;
+uint64_t records = 0;
+uint64_t missed = 0;
+uint64_t last_sequence = 0;
+uint64_t resume_sequence = 0;          // 大于 0 时跳过序号不超过它的记录
+bool resumed = false;
+bool overrun = false;                  // 读取线程遇到 EPIPE，下一条记录按序号间隙累计丢失数
+std::string read_error;
+
+AhoCorasick automaton;
+std::string boot_id;
+std::string state_file = "kmsg_state";
+int64_t started_us = 0;
+int64_t last_save_us = 0;
+uint64_t saved_sequence = 0;
+
+int kmsg_fd = -1;
+int wakeup_fd = -1;
+std::thread reader_thread;
+std::atomic<bool> running{false};
+
+std::string read_boot_id() {
+    std::ifstream input("/proc/sys/kernel/random/boot_id");
+    std::string id;
+    std::getline(input, id);
+    return id;
+}
+
+std::string group_names(uint64_t mask) {
+    std::string names;
+    for (size_t i = 0; i < groups.size(); ++i) {
+        if (!(mask >> i & 1)) continue;
+        if (!names.empty()) names += ",";
+        names += groups[i].name;
+    }
+    return names;
+}
+
+} // namespace
+
+bool KernelLogMonitor::parse_record(const char* record, size_t length, int& level, uint64_t& sequence,
+                                    int64_t& timestamp_us, const char*& message, size_t& message_length) {
+    const char* end = record + length;
+    const char* semicolon = static_cast<const char*>(std::memchr(record, ';', length));
+    if (!semicolon) return false;
+    char* cursor = nullptr;
+    const unsigned long priority = std::strtoul(record, &cursor, 10);
+    if (cursor >= semicolon || *cursor != ',') return false;
+    sequence = std::strtoull(cursor + 1, &cursor, 10);
+    if (cursor >= semicolon || *cursor != ',') return false;
+    timestamp_us = std::strtoll(cursor + 1, &cursor, 10);
+    if (cursor > semicolon) return false;
+    level = static_cast<int>(priority & 7);
+    message = semicolon + 1;
+    const char* newline = static_cast<const char*>(std::memchr(message, '\n', static_cast<size_t>(end - message)));
+    message_length = static_cast<size_t>((newline ? newline : end) - message);
+    return true;
+}
+
+void KernelLogMonitor::initialize() {
+    YAML::Node config = ConfigManager::get_system_config();
+    const size_t hit_capacity = static_cast<size_t>(std::clamp(config["kernel_log_recent_hits"].as<int>(32), 1, 1024));
+    state_file = config["kernel_log_state_file"].as<std::string>("kmsg_state");
+
+    std::vector<PatternGroup> configured;
+    if (config["kernel_log_patterns"] && config["kernel_log_patterns"].IsSequence()) {
+        for (const auto& node : config["kernel_log_patterns"]) {
+            PatternGroup group;
+            group.name = node["name"].as<std::string>("");
+            group.level = node["level"].as<std::string>("warning") == "error" ? "error" : "warning";
+            if (node["patterns"] && node["patterns"].IsSequence()) {
+                for (const auto& pattern : node["patterns"]) group.patterns.push_back(pattern.as<std::string>());
+            } else if (node["pattern"]) {
+                group.patterns.push_back(node["pattern"].as<std::string>());
+            }
+            if (group.name.empty() || group.patterns.empty()) {
+                Logger::warning("忽略无效的 kernel_log_patterns 项（缺少 name 或 patterns）");
+                continue;
+            }
+            configured.push_back(std::move(group));
+        }
+    } else {
+        for (const auto& preset : DEFAULT_GROUPS) {
+            PatternGroup group;
+            group.name = preset.name;
+            group.level = preset.level;
+            group.patterns = preset.patterns;
+            configured.push_back(std::move(group));
+        }
+    }
+    if (configured.size() > AhoCorasick::MAX_GROUPS) {
+        Logger::warning("内核日志模式组超过 " + std::to_string(AhoCorasick::MAX_GROUPS) + " 个，多余的被忽略");
+        configured.resize(AhoCorasick::MAX_GROUPS);
+    }
+    for (size_t i = 0; i < configured.size(); ++i) {
+        for (const auto& pattern : configured[i].patterns) automaton.add(pattern, i);
+    }
+    automaton.build();
+
+    boot_id = read_boot_id();
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        groups = std::move(configured);
+        hits.assign(hit_capacity, Hit{});
+        // 同一次启动内从保存的序号继续；重启后序号从头编号，需要重新扫描本次启动的全部日志
+        std::ifstream input(state_file);
+        std::string saved_boot;
+        uint64_t saved = 0;
+        if (input >> saved_boot >> saved && saved_boot == boot_id) {
+            resume_sequence = saved;
+            last_sequence = saved;
+            saved_sequence = saved;
+            resumed = true;
+        }
+    }
+
+    kmsg_fd = ::open("/dev/kmsg", O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (kmsg_fd < 0) {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        read_error = std::string("无法打开 /dev/kmsg: ") + strerror(errno);
+        Logger::warning(read_error);
+        return;
+    }
+    Logger::info("内核日志监视已启动: " + std::to_string(groups.size()) + " 个模式组, 自动机 " +
+                 std::to_string(automaton.state_count()) + " 个状态" +
+                 (resumed ? "，从序号 " + std::to_string(resume_sequence) + " 继续" : ""));
+    started_us = monotonic_us();
+    wakeup_fd = ::eventfd(0, EFD_CLOEXEC);
+    running = true;
+    reader_thread = std::thread(&KernelLogMonitor::read_loop);
+}
+
+void KernelLogMonitor::shutdown() {
+    if (!running.exchange(false)) return;
+    uint64_t one = 1;
+    if (::write(wakeup_fd, &one, sizeof(one)) < 0) {
+        Logger::error("唤醒内核日志线程失败: " + std::string(strerror(errno)));
+    }
+    if (reader_thread.joinable()) {
+        reader_thread.join();
+    }
+    save_state();
+    ::close(wakeup_fd);
+    ::close(kmsg_fd);
+    wakeup_fd = -1;
+    kmsg_fd = -1;
+}
+
+void KernelLogMonitor::read_loop() {
+    char record[RECORD_BYTES];
+    while (running) {
+        pollfd fds[2] = {{kmsg_fd, POLLIN, 0}, {wakeup_fd, POLLIN, 0}};
+        if (::poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            Logger::error("内核日志 poll 失败: " + std::string(strerror(errno)));
+            break;
+        }
+        if (fds[1].revents & POLLIN) break;
+
+        // 每次 read 返回一条完整记录；读完积压的记录后再回到 poll
+        for (;;) {
+            const ssize_t n = ::read(kmsg_fd, record, sizeof(record));
+            if (n > 0) {
+                process(record, static_cast<size_t>(n));
+                continue;
+            }
+            if (n < 0 && errno == EPIPE) {
+                // 未读的记录已被内核环形缓冲覆盖，下一次 read 从最旧的可用记录继续；
+                // 一次 EPIPE 可能对应任意多条记录，丢失数在读到下一条记录时按序号计算
+                overrun = true;
+                continue;
+            }
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && errno != EAGAIN) {
+                std::lock_guard<std::mutex> lock(state_mutex);
+                read_error = std::string("读取 /dev/kmsg 失败: ") + strerror(errno);
+                Logger::error(read_error);
+                running = false;
+            }
+            break;
+        }
+        if (monotonic_us() - last_save_us >= SAVE_INTERVAL_US) save_state();
+    }
+}
+
+void KernelLogMonitor::process(const char* record, size_t length) {
+    int level = 0;
+    uint64_t sequence = 0;
+    int64_t timestamp_us = 0;
+    const char* message = nullptr;
+    size_t message_length = 0;
+    if (!parse_record(record, length, level, sequence, timestamp_us, message, message_length)) return;
+
+    if (resume_sequence > 0) {
+        if (sequence <= resume_sequence) return;
+        // 服务停止期间内核缓冲已覆盖的记录
+        std::lock_guard<std::mutex> lock(state_mutex);
+        missed += sequence - resume_sequence - 1;
+        resume_sequence = 0;
+        overrun = false;
+    }
+    if (overrun) {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        if (last_sequence > 0 && sequence > last_sequence + 1) missed += sequence - last_sequence - 1;
+        overrun = false;
+    }
+
+    // 自动机只在本线程使用，匹配在锁外完成
+    const uint64_t matched = automaton.scan(message, message_length);
+    std::vector<std::pair<std::string, std::string>> events;
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        ++records;
+        last_sequence = sequence;
+        if (matched == 0) return;
+
+        for (size_t i = 0; i < groups.size(); ++i) {
+            if (!(matched >> i & 1)) continue;
+            PatternGroup& group = groups[i];
+            ++group.count;
+            group.last_sequence = sequence;
+            group.last_us = timestamp_us;
+            // 启动时补扫的历史记录只计数，不推送事件
+            if (timestamp_us >= started_us &&
+                (group.last_event_us < 0 || timestamp_us - group.last_event_us >= EVENT_INTERVAL_US)) {
+                group.last_event_us = timestamp_us;
+                events.emplace_back(group.level, "内核日志 [" + group.name + "]: " + std::string(message, message_length));
+            }
+        }
+        Hit& hit = hits[hit_next];
+        hit.sequence = sequence;
+        hit.timestamp_us = timestamp_us;
+        hit.level = level;
+        hit.groups = matched;
+        hit.text.assign(message, message_length);
+        hit_next = (hit_next + 1) % hits.size();
+        ++hit_total;
+    }
+    for (const auto& [status, text] : events) {
+        Logger::warning(text);
+        EventBus::publish("kernel", status, text);
+    }
+}
+
+void KernelLogMonitor::save_state() {
+    uint64_t sequence;
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        sequence = last_sequence;
+    }
+    last_save_us = monotonic_us();
+    if (sequence == saved_sequence || boot_id.empty()) return;
+
+    // 先写临时文件再改名，掉电时不会留下半截的状态文件
+    const std::string temp = state_file + ".tmp";
+    FILE* output = std::fopen(temp.c_str(), "w");
+    if (!output) return;
+    std::fprintf(output, "%s %llu\n", boot_id.c_str(), static_cast<unsigned long long>(sequence));
+    const bool ok = std::fclose(output) == 0 && std::rename(temp.c_str(), state_file.c_str()) == 0;
+    if (ok) saved_sequence = sequence;
+}
+
+SystemCheckResult KernelLogMonitor::check() {
+    Logger::info("执行内核日志检测");
+
+    YAML::Node config = ConfigManager::get_system_config();
+    const int64_t recent_us = static_cast<int64_t>(config["kernel_log_recent_s"].as<int>(600)) * 1000000;
+    const int64_t now_us = monotonic_us();
+
+    std::lock_guard<std::mutex> lock(state_mutex);
+    if (!running && !read_error.empty()) {
+        return {"error", read_error};
+    }
+
+    std::string status = "success";
+    std::vector<std::string> recent_problems;
+    nlohmann::json group_list = nlohmann::json::array();
+    for (const auto& group : groups) {
+        const bool recent = group.last_us >= 0 && now_us - group.last_us <= recent_us;
+        nlohmann::json entry = {
+            {"name", group.name},
+            {"level", group.level},
+            {"patterns", group.patterns},
+            {"count", group.count},
+            {"recent", recent}
+        };
+        if (group.last_us >= 0) {
+            entry["last_sequence"] = group.last_sequence;
+            entry["last_seconds_ago"] = (now_us - group.last_us) / 1e6;
+        }
+        group_list.push_back(std::move(entry));
+        if (!recent) continue;
+        if (group.level == "error") {
+            status = "error";
+        } else if (status == "success") {
+            status = "warning";
+        }
+        recent_problems.push_back(group.name + " " + std::to_string(static_cast<int64_t>((now_us - group.last_us) / 1000000)) +
+                                  " 秒前 (累计 " + std::to_string(group.count) + ")");
+    }
+
+    // 最近命中按时间由旧到新排列
+    nlohmann::json hit_list = nlohmann::json::array();
+    const size_t stored = static_cast<size_t>(std::min<uint64_t>(hit_total, hits.size()));
+    for (size_t i = 0; i < stored; ++i) {
+        const Hit& hit = hits[(hit_next + hits.size() - stored + i) % hits.size()];
+        hit_list.push_back({
+            {"sequence", hit.sequence},
+            {"seconds_ago", (now_us - hit.timestamp_us) / 1e6},
+            {"level", hit.level},
+            {"groups", group_names(hit.groups)},
+            {"text", hit.text}
+        });
+    }
+
+    std::ostringstream message;
+    message << "已扫描 " << records << " 条内核日志";
+    if (missed > 0) message << "（" << missed << " 条未读到即被覆盖）";
+    if (recent_problems.empty()) {
+        message << "，最近 " << recent_us / 1000000 << " 秒内无匹配";
+    } else {
+        message << "，最近命中:";
+        for (const auto& problem : recent_problems) message << " " << problem << ";";
+    }
+
+    nlohmann::json details = {
+        {"records", records},
+        {"missed", missed},
+        {"last_sequence", last_sequence},
+        {"resumed", resumed},
+        {"hits", hit_total},
+        {"groups", group_list},
+        {"recent_hits", hit_list}
+    };
+    return {status, message.str(), details.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace)};
+}
@@ -0,0 +1,35 @@
+#ifndef KERNEL_LOG_MONITOR_H
+#define KERNEL_LOG_MONITOR_H
+
+#include "../types/common_types.h"
+#include <cstddef>
+#include <cstdint>
+
+// 内核日志监视：后台线程以非阻塞方式持续读取 /dev/kmsg，每条记录用 Aho-Corasick
+// 自动机一遍匹配全部配置的模式组（USB 复位、串口溢出、温控降频、OOM、IO 错误等），
+// 维护各组命中计数与最近 N 条命中记录；检测接口只读取这些计数，不重新扫描日志。
+// 已处理的序号连同 boot_id 定期写入状态文件，服务重启后从上次的位置继续，
+// 记录被环形缓冲覆盖（EPIPE）或重启期间丢失的条数计入 missed
+class KernelLogMonitor {
+public:
+    // 读取模式配置、构建自动机并启动读取线程
+    static void initialize();
+
+    // 停止读取线程并保存序号
+    static void shutdown();
+
+    // 内核日志检测：报告各模式组的命中情况与最近命中的日志
+    static SystemCheckResult check();
+
+    // 解析一条 /dev/kmsg 记录（"级别,序号,时间戳,标志;消息\n..."），
+    // 成功时 message 指向消息正文（不含换行）
+    static bool parse_record(const char* record, size_t length, int& level, uint64_t& sequence,
+                             int64_t& timestamp_us, const char*& message, size_t& message_length);
+
+private:
+    static void read_loop();
+    static void process(const char* record, size_t length);
+    static void save_state();
+};
+
+#endif // KERNEL_LOG_MONITOR_H
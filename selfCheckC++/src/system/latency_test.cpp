@@ -0,0 +1,208 @@
+#include "latency_test.h"
+#include "check_context.h"
+#include "cpu_monitor.h"
+#include "process_monitor.h"
+#include "../config/config_manager.h"
+#include "../utils/file_utils.h"
+#include "../utils/logger.h"
+#include "../utils/monotonic_clock.h"
+#include "../utils/proc_parser.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <sched.h>
+#include <sstream>
+#include <thread>
+#include <time.h>
+#include <vector>
+
+namespace {
+
+// 各测量线程在同一时刻开始，留出线程创建与设置调度策略的时间
+constexpr int64_t START_DELAY_NS = 50 * 1000000LL;
+
+std::mutex run_mutex;   // 同一时刻只允许一次测量
+
+// monotonic_ns() 与 clock_nanosleep(CLOCK_MONOTONIC) 使用同一时钟
+timespec from_ns(int64_t ns) {
+    timespec ts;
+    ts.tv_sec = static_cast<time_t>(ns / 1000000000LL);
+    ts.tv_nsec = static_cast<long>(ns % 1000000000LL);
+    return ts;
+}
+
+} // namespace
+
+void LatencyTest::measure(CoreLatency& result, int64_t start_ns, int interval_us, int duration_ms, int priority) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(result.cpu, &set);
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+        result.error = std::string("绑定 CPU 失败: ") + strerror(errno);
+        return;
+    }
+    // 测量线程从检测线程继承 SCHED_IDLE 等策略，必须显式设置
+    sched_param param{};
+    param.sched_priority = priority;
+    if (priority > 0 && sched_setscheduler(0, SCHED_FIFO, &param) == 0) {
+        result.policy = "SCHED_FIFO/" + std::to_string(priority);
+    } else {
+        param.sched_priority = 0;
+        result.policy = sched_setscheduler(0, SCHED_OTHER, &param) == 0 ? "SCHED_OTHER" : "inherited";
+    }
+
+    const int64_t interval_ns = static_cast<int64_t>(interval_us) * 1000;
+    const int64_t end_ns = start_ns + static_cast<int64_t>(duration_ms) * 1000000;
+    timespec start = from_ns(start_ns);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &start, nullptr) == EINTR) {
+    }
+
+    for (int64_t deadline = start_ns + interval_ns; deadline < end_ns && !CheckContext::cancelled();
+         deadline += interval_ns) {
+        const timespec target = from_ns(deadline);
+        if (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &target, nullptr) == EINTR) {
+            deadline -= interval_ns;
+            continue;
+        }
+        const int64_t woke = monotonic_ns();
+        result.histogram.record(static_cast<uint64_t>(std::max<int64_t>(0, woke - deadline)) / 1000);
+        // 醒来时已错过后续周期：跳过这些周期，下一个截止时间仍在周期网格上
+        if (woke - deadline >= interval_ns) {
+            const int64_t skipped = (woke - deadline) / interval_ns;
+            result.overruns += static_cast<uint64_t>(skipped);
+            deadline += skipped * interval_ns;
+        }
+    }
+}
+
+SystemCheckResult LatencyTest::check() {
+    Logger::info("执行调度延迟检测");
+
+    std::unique_lock<std::mutex> running(run_mutex, std::try_to_lock);
+    if (!running.owns_lock()) {
+        return {"warning", "调度延迟测量正在进行中"};
+    }
+    YAML::Node config = ConfigManager::get_system_config();
+    std::string reason;
+    if (ProcessMonitor::self_test_blocked(config, "latency_mission_processes", reason)) {
+        return {"warning", reason + "，跳过调度延迟测量"};
+    }
+
+    const int duration_ms = std::clamp(config["latency_duration_ms"].as<int>(2000), 100, 10000);
+    const int interval_us = std::clamp(config["latency_interval_us"].as<int>(1000), 100, 100000);
+    // 默认取最低的实时优先级，不抢占任何实时优先级的飞控线程
+    const int priority = std::clamp(config["latency_priority"].as<int>(1), 0, 99);
+    const double big_max_us = config["latency_big_core_max_us"].as<double>(200.0);
+
+    std::vector<int> cpus;
+    if (config["latency_cpus"] && config["latency_cpus"].IsSequence() && config["latency_cpus"].size() > 0) {
+        for (const auto& node : config["latency_cpus"]) cpus.push_back(node.as<int>());
+    } else {
+        cpus = proc::parse_cpu_list(FileUtils::read_file("/sys/devices/system/cpu/online"));
+    }
+    if (cpus.empty()) {
+        return {"error", "无法确定要测量的 CPU"};
+    }
+
+    // 大核按 CPU 监控识别的簇判断；没有大小核之分时上限适用于全部 CPU
+    const CpuSnapshot snapshot = CpuMonitor::get_snapshot();
+    std::vector<int> big_cpus;
+    for (const auto& cluster : snapshot.clusters) {
+        if (cluster.big) big_cpus.insert(big_cpus.end(), cluster.cpus.begin(), cluster.cpus.end());
+    }
+
+    std::vector<std::unique_ptr<CoreLatency>> results;
+    for (int cpu : cpus) {
+        auto result = std::make_unique<CoreLatency>();
+        result->cpu = cpu;
+        result->big = big_cpus.empty() || std::find(big_cpus.begin(), big_cpus.end(), cpu) != big_cpus.end();
+        results.push_back(std::move(result));
+    }
+    const int64_t start_ns = monotonic_ns() + START_DELAY_NS;
+    const CheckContext::CancelToken token = CheckContext::token();
+    std::vector<std::thread> threads;
+    for (auto& result : results) {
+        CoreLatency& core = *result;
+        threads.emplace_back([&core, token, start_ns, interval_us, duration_ms, priority] {
+            CheckContext::Scope scope(token);
+            measure(core, start_ns, interval_us, duration_ms, priority);
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    std::string status = "success";
+    std::ostringstream message;
+    std::vector<std::string> problems;
+    nlohmann::json list = nlohmann::json::array();
+    uint64_t worst_max = 0;
+    int worst_cpu = -1;
+    size_t measured = 0;
+    std::string policy;
+    for (const auto& result : results) {
+        const HdrHistogram& histogram = result->histogram;
+        nlohmann::json entry = {{"cpu", result->cpu}, {"big", result->big}, {"policy", result->policy}};
+        if (!result->error.empty() || histogram.count() == 0) {
+            const std::string error = result->error.empty() ? "未采集到样本" : result->error;
+            entry["error"] = error;
+            problems.push_back("CPU" + std::to_string(result->cpu) + " " + error);
+            list.push_back(std::move(entry));
+            continue;
+        }
+        ++measured;
+        if (policy.empty()) policy = result->policy;
+        entry["samples"] = histogram.count();
+        entry["overruns"] = result->overruns;
+        entry["min_us"] = histogram.min();
+        entry["mean_us"] = histogram.mean();
+        entry["p50_us"] = histogram.percentile(50);
+        entry["p99_us"] = histogram.percentile(99);
+        entry["p999_us"] = histogram.percentile(99.9);
+        entry["max_us"] = histogram.max();
+        list.push_back(std::move(entry));
+
+        if (histogram.max() > worst_max) {
+            worst_max = histogram.max();
+            worst_cpu = result->cpu;
+        }
+        if (result->big && histogram.max() > big_max_us) {
+            problems.push_back("CPU" + std::to_string(result->cpu) + " 最大延迟 " + std::to_string(histogram.max()) +
+                               " us 超过 " + std::to_string(static_cast<int>(big_max_us)) + " us");
+        }
+    }
+
+    if (measured == 0) {
+        status = "error";
+        message << "调度延迟测量失败";
+    } else {
+        message << measured << " 个 CPU 测量 " << duration_ms / 1000.0 << " 秒（周期 " << interval_us << " us, "
+                << policy << "）: ";
+        bool first = true;
+        for (const auto& result : results) {
+            if (result->histogram.count() == 0) continue;
+            message << (first ? "" : ", ") << "CPU" << result->cpu << " " << result->histogram.percentile(50) << "/"
+                    << result->histogram.percentile(99) << "/" << result->histogram.max();
+            first = false;
+        }
+        message << " us (p50/p99/max)";
+        if (!problems.empty()) status = "warning";
+    }
+    if (!problems.empty()) {
+        message << " [";
+        for (size_t i = 0; i < problems.size(); ++i) message << (i ? "; " : "") << problems[i];
+        message << "]";
+    }
+
+    nlohmann::json details = {
+        {"duration_ms", duration_ms},
+        {"interval_us", interval_us},
+        {"priority", priority},
+        {"big_core_max_us", big_max_us},
+        {"worst_cpu", worst_cpu},
+        {"worst_max_us", worst_max},
+        {"cpus", list}
+    };
+    return {status, message.str(), details.dump()};
+}
@@ -0,0 +1,33 @@
+#ifndef LATENCY_TEST_H
+#define LATENCY_TEST_H
+
+#include "../types/common_types.h"
+#include "../utils/hdr_histogram.h"
+#include <cstdint>
+#include <string>
+
+// 单个 CPU 上的唤醒延迟测量结果（微秒）
+struct CoreLatency {
+    int cpu = -1;
+    bool big = false;
+    std::string policy;          // 实际生效的调度策略，如 "SCHED_FIFO/1"
+    std::string error;
+    uint64_t overruns = 0;       // 唤醒晚于下一个周期、跳过的周期数
+    HdrHistogram histogram{10000000, 3};   // 1 us - 10 s，3 位有效数字；构造时计数数组已清零触页
+};
+
+// 调度延迟自测（cyclictest 方式）：在选定的每个 CPU 上各启动一个绑核的测量线程，
+// 以 SCHED_FIFO（无权限时退回 SCHED_OTHER）按固定间隔在 clock_nanosleep 绝对截止时间上睡眠，
+// 醒来时刻与截止时间之差记入 HDR 直方图，测量时长有界。报告每个 CPU 的 p50/p99/最大值，
+// 大核（A76）的最大延迟超过配置上限时告警。测量线程默认使用最低的实时优先级，
+// 飞控进程运行或系统降载时拒绝执行
+class LatencyTest {
+public:
+    // 调度延迟检测（按需执行）
+    static SystemCheckResult check();
+
+    // 在 cpu 上以 interval_us 为周期测量 duration_ms，start_ns 为所有线程共同的起始时刻（CLOCK_MONOTONIC）
+    static void measure(CoreLatency& result, int64_t start_ns, int interval_us, int duration_ms, int priority);
+};
+
+#endif // LATENCY_TEST_H
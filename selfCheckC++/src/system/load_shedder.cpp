@@ -0,0 +1,307 @@
+#include "load_shedder.h"
+#include "check_registry.h"
+#include "event_bus.h"
+#include "metric_sampler.h"
+#include "../config/config_manager.h"
+#include "../utils/logger.h"
+#include "../utils/proc_parser.h"
+#include "../utils/psi_trigger.h"
+#include "../utils/sysfs_reader.h"
+#include "../utils/token_bucket.h"
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <poll.h>
+#include <sstream>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <thread>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// ioprio_set 参数（glibc 未提供封装）
+constexpr int IOPRIO_WHO_PROCESS = 1;
+constexpr int IOPRIO_CLASS_SHIFT = 13;
+constexpr int IOPRIO_CLASS_IDLE = 3;
+
+// 降载时图片传输的突发容量
+constexpr double IMAGE_BURST_BYTES = 64 * 1024;
+
+std::mutex state_mutex;
+std::atomic<bool> active{false};
+std::string active_reason;
+std::chrono::steady_clock::time_point active_since;
+std::chrono::steady_clock::time_point last_pressure;  // 最近一次检测到高压的时间
+
+SysfsReader cpu_psi_reader;
+SysfsReader io_psi_reader;
+SysfsReader memory_psi_reader;
+
+std::thread trigger_thread;
+std::atomic<bool> trigger_running{false};
+int trigger_wakeup_fd = -1;
+
+TokenBucket image_bucket;
+
+// 阈值（见 config.yaml 的 system 段）
+double cpu_threshold = 40.0;
+double io_threshold = 30.0;
+double memory_threshold = 10.0;
+double recover_ratio = 0.5;
+int hold_ms = 10000;
+int base_nice = 0;
+int shed_nice = 15;
+double normal_image_rate = 0.0;
+double shed_image_rate = 1024.0 * 1024;
+int retry_after_s = 5;
+
+bool read_psi(const SysfsReader& reader, proc::PsiInfo& info) {
+    proc::FileBuffer<256> buffer;
+    return buffer.load(reader) && proc::parse_psi(buffer.view(), info);
+}
+
+std::string format_percent(double value) {
+    char buffer[16];
+    snprintf(buffer, sizeof(buffer), "%.1f%%", value);
+    return buffer;
+}
+
+} // namespace
+
+void LoadShedder::initialize() {
+    YAML::Node config = ConfigManager::get_system_config();
+    cpu_threshold = config["load_shed_cpu_avg10"].as<double>(40.0);
+    io_threshold = config["load_shed_io_avg10"].as<double>(30.0);
+    memory_threshold = config["load_shed_memory_avg10"].as<double>(10.0);
+    recover_ratio = config["load_shed_recover_ratio"].as<double>(0.5);
+    hold_ms = config["load_shed_hold_ms"].as<int>(10000);
+    shed_nice = config["load_shed_nice"].as<int>(15);
+    shed_image_rate = config["load_shed_image_kbps"].as<double>(1024) * 1024;
+    normal_image_rate = config["image_bandwidth_kbps"].as<double>(0) * 1024;
+    retry_after_s = config["load_shed_retry_after_s"].as<int>(5);
+    const long stall_us = config["load_shed_trigger_stall_us"].as<long>(200000);
+    const long window_us = config["load_shed_trigger_window_us"].as<long>(1000000);
+
+    errno = 0;
+    base_nice = getpriority(PRIO_PROCESS, 0);
+    image_bucket.set_rate(normal_image_rate, IMAGE_BURST_BYTES);
+
+    cpu_psi_reader.open({"/proc/pressure/cpu"});
+    io_psi_reader.open({"/proc/pressure/io"});
+    memory_psi_reader.open({"/proc/pressure/memory"});
+    if (!cpu_psi_reader.is_open() && !io_psi_reader.is_open() && !memory_psi_reader.is_open()) {
+        Logger::warning("内核未开启 PSI，自适应降载不可用");
+        return;
+    }
+    MetricSampler::register_task("load_shedder", std::chrono::milliseconds(1000), &LoadShedder::evaluate);
+
+    if (stall_us <= 0) return;
+    std::string cpu_trigger;
+    std::string io_trigger;
+    int cpu_fd = open_psi_trigger("/proc/pressure/cpu", stall_us, window_us, cpu_trigger);
+    if (cpu_fd < 0) {
+        Logger::warning("注册 CPU PSI 触发器失败（" + cpu_trigger + "）: " + std::string(strerror(errno)));
+    }
+    int io_fd = open_psi_trigger("/proc/pressure/io", stall_us, window_us, io_trigger);
+    if (io_fd < 0) {
+        Logger::warning("注册 IO PSI 触发器失败（" + io_trigger + "）: " + std::string(strerror(errno)));
+    }
+    if (cpu_fd < 0 && io_fd < 0) return;
+
+    trigger_wakeup_fd = eventfd(0, EFD_CLOEXEC);
+    trigger_running = true;
+    trigger_thread = std::thread(&LoadShedder::trigger_loop, cpu_fd, io_fd);
+    Logger::info("降载 PSI 触发器已注册: cpu " + (cpu_fd >= 0 ? cpu_trigger : std::string("无")) +
+                 ", io " + (io_fd >= 0 ? io_trigger : std::string("无")));
+}
+
+void LoadShedder::shutdown() {
+    if (!trigger_running.exchange(false)) return;
+    uint64_t one = 1;
+    if (::write(trigger_wakeup_fd, &one, sizeof(one)) < 0) {
+        Logger::error("唤醒降载触发器线程失败: " + std::string(strerror(errno)));
+    }
+    if (trigger_thread.joinable()) {
+        trigger_thread.join();
+    }
+    ::close(trigger_wakeup_fd);
+    trigger_wakeup_fd = -1;
+}
+
+void LoadShedder::trigger_loop(int cpu_fd, int io_fd) {
+    while (trigger_running) {
+        pollfd fds[3] = {{cpu_fd, POLLPRI, 0}, {io_fd, POLLPRI, 0}, {trigger_wakeup_fd, POLLIN, 0}};
+        int ready = ::poll(fds, 3, -1);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            Logger::error("降载触发器 poll 失败: " + std::string(strerror(errno)));
+            break;
+        }
+        if (fds[2].revents & POLLIN) break;
+        if ((fds[0].revents | fds[1].revents) & POLLERR) {
+            Logger::error("降载 PSI 触发器失效，改为仅按采样评估");
+            break;
+        }
+        // 触发后立即降载；之后的维持与退出交给 evaluate() 的滞回判定
+        if (fds[0].revents & POLLPRI) {
+            set_shedding(true, "CPU 压力触发");
+        } else if (fds[1].revents & POLLPRI) {
+            set_shedding(true, "IO 压力触发");
+        }
+    }
+    if (cpu_fd >= 0) ::close(cpu_fd);
+    if (io_fd >= 0) ::close(io_fd);
+}
+
+void LoadShedder::evaluate() {
+    proc::PsiInfo cpu;
+    proc::PsiInfo io;
+    proc::PsiInfo memory;
+    const bool has_cpu = read_psi(cpu_psi_reader, cpu);
+    const bool has_io = read_psi(io_psi_reader, io);
+    const bool has_memory = read_psi(memory_psi_reader, memory);
+    if (has_cpu) MetricSampler::record("psi.cpu_some_avg10", cpu.some.avg10);
+    if (has_io) MetricSampler::record("psi.io_some_avg10", io.some.avg10);
+
+    std::string reason;
+    if (has_cpu && cpu.some.avg10 >= cpu_threshold) {
+        reason = "CPU 压力 " + format_percent(cpu.some.avg10);
+    } else if (has_io && io.some.avg10 >= io_threshold) {
+        reason = "IO 压力 " + format_percent(io.some.avg10);
+    } else if (has_memory && memory.full.avg10 >= memory_threshold) {
+        reason = "内存压力 " + format_percent(memory.full.avg10);
+    }
+    if (!reason.empty()) {
+        set_shedding(true, reason);
+        return;
+    }
+    if (!active) return;
+
+    // 滞回：所有压力都降到阈值的 recover_ratio 以下并保持 hold_ms 后才退出
+    const bool calm = (!has_cpu || cpu.some.avg10 < cpu_threshold * recover_ratio) &&
+                      (!has_io || io.some.avg10 < io_threshold * recover_ratio) &&
+                      (!has_memory || memory.full.avg10 < memory_threshold * recover_ratio);
+    std::chrono::steady_clock::time_point since;
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        since = last_pressure;
+    }
+    if (calm && std::chrono::steady_clock::now() - since >= std::chrono::milliseconds(hold_ms)) {
+        set_shedding(false, "压力恢复");
+    }
+}
+
+bool LoadShedder::shedding() {
+    return active;
+}
+
+void LoadShedder::set_shedding(bool enabled, const std::string& reason) {
+    std::lock_guard<std::mutex> lock(state_mutex);
+    const auto now = std::chrono::steady_clock::now();
+    if (enabled) last_pressure = now;  // 持续高压时延长降载保持时间
+    if (active == enabled) return;
+    active = enabled;
+    active_reason = reason;
+    active_since = now;
+
+    apply_priority(enabled);
+    image_bucket.set_rate(enabled ? shed_image_rate : normal_image_rate, IMAGE_BURST_BYTES);
+
+    std::string message = enabled ? "进入降载: " + reason : "退出降载: " + reason;
+    if (enabled) {
+        Logger::warning(message);
+    } else {
+        Logger::info(message);
+    }
+    EventBus::publish("load", enabled ? "warning" : "success", message);
+}
+
+void LoadShedder::apply_priority(bool lowered) {
+    // Linux 的 nice 与 IO 优先级按线程生效，需要逐个设置 /proc/self/task 下的线程；
+    // 之后新建的连接线程继承主线程的优先级
+    const int nice_value = lowered ? shed_nice : base_nice;
+    const int ioprio = lowered ? (IOPRIO_CLASS_IDLE << IOPRIO_CLASS_SHIFT) : 0;
+    int failures = 0;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator("/proc/self/task", ec)) {
+        const int tid = std::atoi(entry.path().filename().c_str());
+        if (tid <= 0) continue;
+        if (setpriority(PRIO_PROCESS, static_cast<id_t>(tid), nice_value) != 0) ++failures;
+        if (syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, tid, ioprio) != 0) ++failures;
+    }
+    if (failures > 0) {
+        Logger::warning("调整 " + std::to_string(failures) + " 项线程优先级失败（恢复优先级需要 CAP_SYS_NICE）");
+    }
+}
+
+bool LoadShedder::is_critical_request(const std::string& path) {
+    // 按需执行的重型自测（latency、hardware、storage_probe 等）正是降载要拦下的负载
+    const std::string check_prefix = "/api/v1/check/";
+    if (path.compare(0, check_prefix.size(), check_prefix) == 0) {
+        const CheckDefinition* def = CheckRegistry::find(path.substr(check_prefix.size()));
+        return def == nullptr || !def->on_demand;
+    }
+    return path == "/" ||
+           path.compare(0, 13, "/api/v1/check") == 0 ||
+           path.compare(0, 14, "/api/v1/events") == 0 ||
+           path.compare(0, 13, "/api/v1/image") == 0;
+}
+
+int LoadShedder::retry_after_seconds() {
+    return retry_after_s;
+}
+
+void LoadShedder::throttle_image(size_t bytes) {
+    image_bucket.acquire(bytes);
+}
+
+SystemCheckResult LoadShedder::check() {
+    Logger::info("执行负载检测");
+
+    proc::PsiInfo cpu;
+    proc::PsiInfo io;
+    proc::PsiInfo memory;
+    const bool has_cpu = read_psi(cpu_psi_reader, cpu);
+    const bool has_io = read_psi(io_psi_reader, io);
+    const bool has_memory = read_psi(memory_psi_reader, memory);
+    if (!has_cpu && !has_io && !has_memory) {
+        return {"warning", "内核未开启 PSI，无法评估系统压力"};
+    }
+
+    std::ostringstream oss;
+    nlohmann::json details = nlohmann::json::object();
+    if (has_cpu) {
+        oss << "CPU 压力 " << format_percent(cpu.some.avg10);
+        details["cpu_some_avg10"] = cpu.some.avg10;
+    }
+    if (has_io) {
+        oss << (has_cpu ? ", " : "") << "IO 压力 " << format_percent(io.some.avg10);
+        details["io_some_avg10"] = io.some.avg10;
+    }
+    if (has_memory) {
+        oss << ((has_cpu || has_io) ? ", " : "") << "内存压力 " << format_percent(memory.full.avg10);
+        details["memory_full_avg10"] = memory.full.avg10;
+    }
+
+    std::string status = "success";
+    std::lock_guard<std::mutex> lock(state_mutex);
+    details["shedding"] = active.load();
+    if (active) {
+        status = "warning";
+        const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::steady_clock::now() - active_since).count();
+        oss << "; 降载中（" << active_reason << "，已持续 " << seconds << " 秒）";
+        details["reason"] = active_reason;
+        details["image_rate_bytes_per_sec"] = image_bucket.rate();
+    } else {
+        oss << "; 未降载";
+    }
+    return {status, oss.str(), details.dump()};
+}
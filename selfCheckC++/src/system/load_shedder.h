@@ -0,0 +1,46 @@
+#ifndef LOAD_SHEDDER_H
+#define LOAD_SHEDDER_H
+
+#include "../types/common_types.h"
+#include <cstddef>
+#include <string>
+
+// 自适应降载：自检服务与 VO/DMatcher 同板运行，飞控侧出现 CPU/IO/内存压力时
+// 主动让出资源——降低自身线程的 nice 与 IO 优先级、限制图片传输带宽、
+// 以 503 + Retry-After 拒绝非关键请求，检测接口始终正常应答。
+// 进入降载由 PSI 触发器事件驱动（无需等待采样周期），退出由 1 Hz 评估带滞回判定
+class LoadShedder {
+public:
+    // 读取阈值配置，注册 cpu/io PSI 触发器与评估任务
+    static void initialize();
+
+    // 停止 PSI 触发器线程
+    static void shutdown();
+
+    // 按 PSI avg10 评估是否进入/退出降载，供采样线程调用
+    static void evaluate();
+
+    // 当前是否处于降载状态
+    static bool shedding();
+
+    // 进入或退出降载（也用于基准测试手动切换）
+    static void set_shedding(bool enabled, const std::string& reason);
+
+    // 降载时仍需处理的请求：常规检测接口、事件推送与图片（图片改为限速）；按需检测不在其列
+    static bool is_critical_request(const std::string& path);
+
+    // 503 响应中建议的重试间隔（秒）
+    static int retry_after_seconds();
+
+    // 图片发送前按当前带宽限制取令牌，必要时阻塞
+    static void throttle_image(size_t bytes);
+
+    // 负载检测：报告各类 PSI 压力与降载状态
+    static SystemCheckResult check();
+
+private:
+    static void trigger_loop(int cpu_fd, int io_fd);
+    static void apply_priority(bool lowered);
+};
+
+#endif // LOAD_SHEDDER_H
@@ -0,0 +1,305 @@
+#include "memory_monitor.h"
+#include "event_bus.h"
+#include "metric_sampler.h"
+#include "process_table.h"
+#include "../config/config_manager.h"
+#include "../utils/file_utils.h"
+#include "../utils/logger.h"
+#include "../utils/psi_trigger.h"
+#include "../utils/string_utils.h"
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <nlohmann/json.hpp>
+#include <poll.h>
+#include <sstream>
+#include <sys/eventfd.h>
+#include <thread>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const std::string PSI_MEMORY_PATH = "/proc/pressure/memory";
+const std::string DMABUF_SYSFS_PATH = "/sys/kernel/dmabuf/buffers";
+const std::string DMABUF_DEBUGFS_PATH = "/sys/kernel/debug/dma_buf/bufinfo";
+
+SysfsReader meminfo_reader;
+SysfsReader psi_reader;
+
+std::thread psi_thread;
+std::atomic<bool> psi_running{false};
+int psi_wakeup_fd = -1;
+
+// 告警阈值（见 config.yaml 的 system 段）
+int warn_percent = 70;
+int error_percent = 85;
+int cma_warn_free_percent = 10;
+double psi_warn_avg10 = 10.0;
+int psi_event_cooldown_ms = 10000;
+
+std::string format_psi(const proc::PsiInfo& psi) {
+    char buffer[96];
+    if (psi.has_full) {
+        snprintf(buffer, sizeof(buffer), "some %.2f%% / full %.2f%%", psi.some.avg10, psi.full.avg10);
+    } else {
+        snprintf(buffer, sizeof(buffer), "some %.2f%%", psi.some.avg10);
+    }
+    return buffer;
+}
+
+} // namespace
+
+void MemoryMonitor::initialize() {
+    YAML::Node config = ConfigManager::get_system_config();
+    warn_percent = config["memory_warn_percent"].as<int>(70);
+    error_percent = config["memory_error_percent"].as<int>(85);
+    cma_warn_free_percent = config["cma_warn_free_percent"].as<int>(10);
+    psi_warn_avg10 = config["memory_psi_warn_avg10"].as<double>(10.0);
+    psi_event_cooldown_ms = config["memory_psi_event_cooldown_ms"].as<int>(10000);
+    const long stall_us = config["memory_psi_stall_us"].as<long>(150000);
+    const long window_us = config["memory_psi_window_us"].as<long>(1000000);
+
+    if (!meminfo_reader.open({"/proc/meminfo"})) {
+        Logger::error("无法打开 /proc/meminfo，内存监控不可用");
+    }
+    if (!psi_reader.open({PSI_MEMORY_PATH})) {
+        Logger::warning("内核未开启 PSI（/proc/pressure/memory 不存在），内存压力监控不可用");
+    }
+
+    MetricSampler::register_task("memory", std::chrono::milliseconds(1000), &MemoryMonitor::sample);
+
+    if (!psi_reader.is_open() || stall_us <= 0) return;
+
+    // 触发器需要独立的 fd，触发后 poll() 返回 POLLPRI
+    std::string trigger;
+    int fd = open_psi_trigger(PSI_MEMORY_PATH, stall_us, window_us, trigger);
+    if (fd < 0) {
+        Logger::warning("注册 PSI 触发器失败（" + trigger + "）: " + std::string(strerror(errno)));
+        return;
+    }
+
+    psi_wakeup_fd = eventfd(0, EFD_CLOEXEC);
+    psi_running = true;
+    psi_thread = std::thread(&MemoryMonitor::psi_trigger_loop, fd);
+    Logger::info("PSI 内存压力触发器已注册: " + trigger);
+}
+
+void MemoryMonitor::shutdown() {
+    if (!psi_running.exchange(false)) return;
+    uint64_t one = 1;
+    if (::write(psi_wakeup_fd, &one, sizeof(one)) < 0) {
+        Logger::error("唤醒 PSI 线程失败: " + std::string(strerror(errno)));
+    }
+    if (psi_thread.joinable()) {
+        psi_thread.join();
+    }
+    ::close(psi_wakeup_fd);
+    psi_wakeup_fd = -1;
+}
+
+void MemoryMonitor::psi_trigger_loop(int fd) {
+    auto last_event = std::chrono::steady_clock::time_point();
+    while (psi_running) {
+        pollfd fds[2] = {{fd, POLLPRI, 0}, {psi_wakeup_fd, POLLIN, 0}};
+        int ready = ::poll(fds, 2, -1);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            Logger::error("PSI poll 失败: " + std::string(strerror(errno)));
+            break;
+        }
+        if (fds[1].revents & POLLIN) break;
+        if (fds[0].revents & POLLERR) {
+            Logger::error("PSI 触发器失效，停止内存压力推送");
+            break;
+        }
+        if (!(fds[0].revents & POLLPRI)) continue;
+
+        // 持续高压时内核每个窗口都会触发一次，按冷却时间合并推送
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_event < std::chrono::milliseconds(psi_event_cooldown_ms)) continue;
+        last_event = now;
+
+        proc::PsiInfo psi;
+        std::string message = "内存压力触发: 进程因内存不足出现停顿";
+        nlohmann::json details;
+        if (read_psi(psi)) {
+            message += "，avg10 " + format_psi(psi);
+            details = {
+                {"some_avg10", psi.some.avg10},
+                {"full_avg10", psi.full.avg10},
+                {"some_total_us", psi.some.total_us}
+            };
+        }
+        Logger::warning(message);
+        EventBus::publish("memory", "warning", message, details.is_null() ? std::string() : details.dump());
+    }
+    ::close(fd);
+}
+
+bool MemoryMonitor::read_meminfo(proc::MemInfo& info) {
+    proc::FileBuffer<8192> buffer;
+    return buffer.load(meminfo_reader) && proc::parse_meminfo(buffer.view(), info);
+}
+
+bool MemoryMonitor::read_psi(proc::PsiInfo& info) {
+    proc::FileBuffer<256> buffer;
+    return buffer.load(psi_reader) && proc::parse_psi(buffer.view(), info);
+}
+
+void MemoryMonitor::sample() {
+    proc::MemInfo info;
+    if (read_meminfo(info)) {
+        MetricSampler::record("memory.available_mb", info.mem_available / 1024.0);
+        if (info.cma_total > 0) {
+            MetricSampler::record("memory.cma_free_mb", info.cma_free / 1024.0);
+        }
+    }
+    proc::PsiInfo psi;
+    if (read_psi(psi)) {
+        MetricSampler::record("memory.psi_some_avg10", psi.some.avg10);
+        if (psi.has_full) {
+            MetricSampler::record("memory.psi_full_avg10", psi.full.avg10);
+        }
+    }
+}
+
+DmaBufUsage MemoryMonitor::read_dmabuf_usage() {
+    DmaBufUsage usage;
+    std::error_code ec;
+
+    // 5.13+ 内核（CONFIG_DMABUF_SYSFS_STATS）：每个缓冲区一个目录，含 size 与 exporter_name
+    if (fs::is_directory(DMABUF_SYSFS_PATH, ec)) {
+        usage.available = true;
+        usage.source = "sysfs";
+        for (const auto& entry : fs::directory_iterator(DMABUF_SYSFS_PATH, ec)) {
+            long size = 0;
+            SysfsReader size_reader({(entry.path() / "size").string()});
+            if (!size_reader.read_long(size) || size < 0) continue;
+            std::string exporter = trim(FileUtils::read_file((entry.path() / "exporter_name").string()));
+            usage.total_bytes += static_cast<uint64_t>(size);
+            usage.by_exporter[exporter.empty() ? "unknown" : exporter] += static_cast<uint64_t>(size);
+            ++usage.buffer_count;
+        }
+        return usage;
+    }
+
+    // RK3588 BSP 5.10 内核：debugfs 的 bufinfo 末行为 "Total N objects, M bytes"
+    std::istringstream bufinfo(FileUtils::read_file(DMABUF_DEBUGFS_PATH));
+    std::string line;
+    while (std::getline(bufinfo, line)) {
+        unsigned long objects = 0;
+        unsigned long long bytes = 0;
+        if (sscanf(line.c_str(), "Total %lu objects, %llu bytes", &objects, &bytes) == 2) {
+            usage.available = true;
+            usage.source = "debugfs";
+            usage.buffer_count = objects;
+            usage.total_bytes = bytes;
+        }
+    }
+    return usage;
+}
+
+SystemCheckResult MemoryMonitor::check() {
+    Logger::info("执行内存占用检测");
+
+    proc::MemInfo info;
+    if (!meminfo_reader.is_open()) {
+        return {"error", "无法打开/proc/meminfo"};
+    }
+    if (!read_meminfo(info)) {
+        return {"error", "无效的内存信息"};
+    }
+
+    // MemAvailable 计入可回收的 slab 并扣除水位线；3.14 之前的内核没有该字段时退回旧算法
+    long total_ram = static_cast<long>(info.mem_total);
+    long available_ram = info.mem_available > 0
+        ? static_cast<long>(info.mem_available)
+        : static_cast<long>(info.mem_free + info.buffers + info.cached);
+    long used_ram = total_ram - available_ram;
+    int usage_percent = static_cast<int>((used_ram * 100) / total_ram);
+
+    std::string status = "success";
+    std::vector<std::string> warnings;
+    if (usage_percent > error_percent) {
+        status = "error";
+    } else if (usage_percent > warn_percent) {
+        status = "warning";
+    }
+
+    std::ostringstream oss;
+    oss << "总内存: " << total_ram/1024 << "MB, 已用: " << used_ram/1024
+        << "MB, 可用: " << available_ram/1024 << "MB, 使用率: " << usage_percent << "%";
+
+    nlohmann::json details = {
+        {"mem_total_kb", info.mem_total},
+        {"mem_available_kb", info.mem_available},
+        {"mem_free_kb", info.mem_free},
+        {"cached_kb", info.cached},
+        {"shmem_kb", info.shmem},
+        {"swap_total_kb", info.swap_total},
+        {"swap_free_kb", info.swap_free}
+    };
+
+    // 相机/NPU 驱动从 CMA 池分配连续内存，池耗尽时即使总内存充足也会分配失败
+    if (info.cma_total > 0) {
+        int cma_free_percent = static_cast<int>(info.cma_free * 100 / info.cma_total);
+        oss << ", CMA: " << info.cma_free/1024 << "/" << info.cma_total/1024 << "MB 空闲";
+        if (cma_free_percent < cma_warn_free_percent) {
+            warnings.push_back("CMA 余量不足 " + std::to_string(cma_free_percent) + "%");
+        }
+        details["cma_total_kb"] = info.cma_total;
+        details["cma_free_kb"] = info.cma_free;
+    }
+
+    DmaBufUsage dmabuf = read_dmabuf_usage();
+    if (dmabuf.available) {
+        oss << ", dma-buf: " << dmabuf.total_bytes / (1024 * 1024) << "MB (" << dmabuf.buffer_count << " 个)";
+        details["dmabuf"] = {
+            {"source", dmabuf.source},
+            {"total_bytes", dmabuf.total_bytes},
+            {"buffers", dmabuf.buffer_count},
+            {"by_exporter", dmabuf.by_exporter}
+        };
+    }
+
+    proc::PsiInfo psi;
+    if (read_psi(psi)) {
+        oss << ", 内存压力 " << format_psi(psi);
+        const double stall = psi.has_full ? psi.full.avg10 : psi.some.avg10;
+        if (stall >= psi_warn_avg10) {
+            warnings.push_back("内存压力过高");
+        }
+        details["psi"] = {
+            {"some_avg10", psi.some.avg10},
+            {"some_avg60", psi.some.avg60},
+            {"full_avg10", psi.full.avg10},
+            {"full_avg60", psi.full.avg60}
+        };
+    }
+
+    // 内存告警时附上占用最多的进程；超过错误阈值时写入消息
+    if (status != "success" || !warnings.empty()) {
+        ProcessTable::refresh();
+        nlohmann::json top = nlohmann::json::array();
+        for (const auto& consumer : ProcessTable::top_rss(ProcessTable::default_count())) {
+            top.push_back({{"pid", consumer.pid}, {"comm", consumer.comm}, {"rss_kb", consumer.rss_kb}});
+            if (status == "error") {
+                oss << (top.size() == 1 ? ", 占用最多:" : ",") << " " << consumer.comm
+                    << "(" << consumer.pid << ") " << consumer.rss_kb / 1024 << "MB";
+            }
+        }
+        details["top_rss"] = top;
+    }
+
+    if (!warnings.empty()) {
+        if (status == "success") status = "warning";
+        oss << " [告警:";
+        for (const auto& warning : warnings) oss << " " << warning;
+        oss << "]";
+    }
+
+    return {status, oss.str(), details.dump()};
+}
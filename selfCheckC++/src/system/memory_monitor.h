@@ -0,0 +1,45 @@
+#ifndef MEMORY_MONITOR_H
+#define MEMORY_MONITOR_H
+
+#include "../types/common_types.h"
+#include "../utils/proc_parser.h"
+#include "../utils/sysfs_reader.h"
+#include <cstdint>
+#include <map>
+#include <string>
+
+// dma-buf 占用统计（相机/NPU/RGA 的共享缓冲区）
+struct DmaBufUsage {
+    bool available = false;
+    std::string source;                          // 统计来源：sysfs 或 debugfs
+    uint64_t total_bytes = 0;
+    size_t buffer_count = 0;
+    std::map<std::string, uint64_t> by_exporter; // 按导出者（heap/驱动）汇总，仅 sysfs 提供
+};
+
+// 内存监控：MemAvailable、CMA 池、dma-buf 占用与 PSI 内存压力。
+// PSI 触发器在独立线程中 poll()，出现停顿时立即通过 EventBus 推送告警
+class MemoryMonitor {
+public:
+    // 打开 meminfo/PSI 节点，注册采样任务并启动 PSI 触发器线程
+    static void initialize();
+
+    // 停止 PSI 触发器线程
+    static void shutdown();
+
+    // 记录内存指标，供采样线程调用
+    static void sample();
+
+    // 读取 dma-buf 统计（遍历目录，仅在检测时调用）
+    static DmaBufUsage read_dmabuf_usage();
+
+    // 内存检测：按 MemAvailable 计算使用率，并检查 CMA 余量与内存压力
+    static SystemCheckResult check();
+
+private:
+    static bool read_meminfo(proc::MemInfo& info);
+    static bool read_psi(proc::PsiInfo& info);
+    static void psi_trigger_loop(int fd);
+};
+
+#endif // MEMORY_MONITOR_H
@@ -0,0 +1,168 @@
+#include "metric_sampler.h"
+#include "thread_placement.h"
+#include "../utils/logger.h"
+#include <condition_variable>
+#include <map>
+#include <thread>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct ScheduledTask {
+    std::string name;
+    std::chrono::milliseconds interval;
+    MetricSampler::SampleTask task;
+    Clock::time_point next_run;
+};
+
+std::mutex tasks_mutex;
+std::vector<ScheduledTask> tasks;
+
+std::mutex series_mutex;
+std::map<std::string, std::shared_ptr<TimeSeries>> series_store;
+
+std::thread sampler_thread;
+std::mutex run_mutex;
+std::condition_variable run_cv;
+bool running = false;
+
+} // namespace
+
+TimeSeries::TimeSeries(size_t capacity) : points(capacity) {}
+
+void TimeSeries::push(int64_t timestamp_ms, double value) {
+    std::lock_guard<std::mutex> lock(mutex);
+    points[head] = {timestamp_ms, value};
+    head = (head + 1) % points.size();
+    if (count < points.size()) {
+        ++count;
+    }
+}
+
+std::vector<MetricPoint> TimeSeries::snapshot(int64_t since_ms) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<MetricPoint> result;
+    result.reserve(count);
+    size_t start = (head + points.size() - count) % points.size();
+    for (size_t i = 0; i < count; ++i) {
+        const MetricPoint& point = points[(start + i) % points.size()];
+        if (point.timestamp_ms >= since_ms) {
+            result.push_back(point);
+        }
+    }
+    return result;
+}
+
+bool TimeSeries::latest(MetricPoint& point) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (count == 0) return false;
+    point = points[(head + points.size() - 1) % points.size()];
+    return true;
+}
+
+size_t TimeSeries::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return count;
+}
+
+void MetricSampler::register_task(const std::string& name, std::chrono::milliseconds interval, SampleTask task) {
+    std::lock_guard<std::mutex> lock(tasks_mutex);
+    tasks.push_back({name, interval, std::move(task), Clock::now()});
+    Logger::info("注册采样任务: " + name + "，周期 " + std::to_string(interval.count()) + " ms");
+}
+
+void MetricSampler::start() {
+    std::lock_guard<std::mutex> lock(run_mutex);
+    if (running) return;
+    running = true;
+    sampler_thread = std::thread(&MetricSampler::run_loop);
+}
+
+void MetricSampler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(run_mutex);
+        if (!running) return;
+        running = false;
+    }
+    run_cv.notify_all();
+    if (sampler_thread.joinable()) {
+        sampler_thread.join();
+    }
+}
+
+void MetricSampler::record(const std::string& series, double value) {
+    std::shared_ptr<TimeSeries> target;
+    {
+        std::lock_guard<std::mutex> lock(series_mutex);
+        auto& slot = series_store[series];
+        if (!slot) {
+            slot = std::make_shared<TimeSeries>(SERIES_CAPACITY);
+        }
+        target = slot;
+    }
+    target->push(now_ms(), value);
+}
+
+std::shared_ptr<const TimeSeries> MetricSampler::get_series(const std::string& series) {
+    std::lock_guard<std::mutex> lock(series_mutex);
+    auto it = series_store.find(series);
+    if (it == series_store.end()) {
+        return nullptr;
+    }
+    return it->second;
+}
+
+std::vector<std::string> MetricSampler::series_names() {
+    std::lock_guard<std::mutex> lock(series_mutex);
+    std::vector<std::string> names;
+    names.reserve(series_store.size());
+    for (const auto& [name, series] : series_store) {
+        names.push_back(name);
+    }
+    return names;
+}
+
+int64_t MetricSampler::now_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+void MetricSampler::warm_up(const SampleTask& sample) {
+    sample();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    sample();
+}
+
+void MetricSampler::run_loop() {
+    ThreadPlacement::apply(ThreadRole::SAMPLER);
+    Logger::info("指标采样线程已启动");
+    while (true) {
+        Clock::time_point next_wakeup = Clock::now() + std::chrono::seconds(1);
+        {
+            std::lock_guard<std::mutex> lock(tasks_mutex);
+            const Clock::time_point now = Clock::now();
+            for (auto& task : tasks) {
+                if (now >= task.next_run) {
+                    try {
+                        task.task();
+                    } catch (const std::exception& e) {
+                        Logger::error("采样任务 " + task.name + " 异常: " + e.what());
+                    }
+                    // 按固定节拍推进；落后太多时从当前时间重新对齐
+                    task.next_run += task.interval;
+                    if (task.next_run < now) {
+                        task.next_run = now + task.interval;
+                    }
+                }
+                next_wakeup = std::min(next_wakeup, task.next_run);
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(run_mutex);
+        if (run_cv.wait_until(lock, next_wakeup, [] { return !running; })) {
+            break;
+        }
+    }
+    Logger::info("指标采样线程已退出");
+}
@@ -0,0 +1,73 @@
+#ifndef METRIC_SAMPLER_H
+#define METRIC_SAMPLER_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 时间序列中的一个采样点
+struct MetricPoint {
+    int64_t timestamp_ms;  // Unix 毫秒时间戳
+    double value;
+};
+
+// 固定容量的环形时间序列，写满后覆盖最旧的点
+class TimeSeries {
+public:
+    explicit TimeSeries(size_t capacity);
+
+    void push(int64_t timestamp_ms, double value);
+
+    // 按时间顺序返回不早于 since_ms 的点
+    std::vector<MetricPoint> snapshot(int64_t since_ms = 0) const;
+
+    bool latest(MetricPoint& point) const;
+    size_t size() const;
+
+private:
+    mutable std::mutex mutex;
+    std::vector<MetricPoint> points;
+    size_t head = 0;   // 下一个写入位置
+    size_t count = 0;
+};
+
+// 后台指标采样器：单线程按各任务的周期调度采样函数，
+// 采样函数通过 record() 把结果写入命名时间序列
+class MetricSampler {
+public:
+    using SampleTask = std::function<void()>;
+
+    // 注册周期采样任务（启动前后均可调用）
+    static void register_task(const std::string& name, std::chrono::milliseconds interval, SampleTask task);
+
+    // 启动/停止后台采样线程
+    static void start();
+    static void stop();
+
+    // 写入一个采样点；序列在首次写入时创建
+    static void record(const std::string& series, double value);
+
+    // 查询序列，不存在返回 nullptr
+    static std::shared_ptr<const TimeSeries> get_series(const std::string& series);
+
+    // 所有序列名称
+    static std::vector<std::string> series_names();
+
+    // 当前 Unix 毫秒时间戳
+    static int64_t now_ms();
+
+    // 后台采样尚未形成速率窗口时，由检测线程现场做两次间隔 200 ms 的采样
+    static void warm_up(const SampleTask& sample);
+
+private:
+    // 每个序列保留的点数（10 Hz 下约 60 秒）
+    static constexpr size_t SERIES_CAPACITY = 600;
+
+    static void run_loop();
+};
+
+#endif // METRIC_SAMPLER_H
@@ -0,0 +1,295 @@
+#include "model_verifier.h"
+#include "check_context.h"
+#include "../config/config_manager.h"
+#include "../utils/logger.h"
+#include "../utils/sha256.h"
+#include "../utils/string_utils.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <nlohmann/json.hpp>
+#include <sstream>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+// 静态成员初始化
+std::mutex ModelVerifier::cache_mutex;
+std::unordered_map<std::string, ModelVerifier::CacheEntry> ModelVerifier::cache;
+
+namespace {
+
+// 每次 pread 读入并计算的块；用固定缓冲区而不是 mmap，文件在计算中被截断时
+// 只会读到短块并报错，不会因访问越过文件末尾的映射页收到 SIGBUS
+constexpr size_t HASH_BLOCK = 1 << 20;
+
+const std::vector<std::string> DEFAULT_EXTENSIONS = {
+    ".rknn", ".onnx", ".bin", ".engine", ".trt", ".tflite", ".param", ".pt", ".pth", ".weights"
+};
+
+std::string lowercase(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return std::tolower(c); });
+    return text;
+}
+
+// 形如文件路径且扩展名在列表中的值；目录、URL 与设备/虚拟文件系统路径不参与校验
+bool looks_like_model(const std::string& value, const std::vector<std::string>& extensions) {
+    if (value.find('/') == std::string::npos || value.back() == '/' || value.find("://") != std::string::npos) {
+        return false;
+    }
+    if (starts_with(value, "/dev/") || starts_with(value, "/sys/") || starts_with(value, "/proc/")) return false;
+    const size_t slash = value.rfind('/');
+    const size_t dot = value.rfind('.');
+    if (dot == std::string::npos || dot < slash) return false;
+    const std::string extension = lowercase(value.substr(dot));
+    return std::find(extensions.begin(), extensions.end(), extension) != extensions.end();
+}
+
+std::string format_size(uint64_t bytes) {
+    char buffer[32];
+    if (bytes >= (1ULL << 30)) {
+        snprintf(buffer, sizeof(buffer), "%.2f GB", bytes / 1073741824.0);
+    } else if (bytes >= (1ULL << 20)) {
+        snprintf(buffer, sizeof(buffer), "%.1f MB", bytes / 1048576.0);
+    } else {
+        snprintf(buffer, sizeof(buffer), "%.1f KB", bytes / 1024.0);
+    }
+    return buffer;
+}
+
+} // namespace
+
+std::vector<std::pair<std::string, std::vector<std::string>>> ModelVerifier::collect_files() {
+    YAML::Node config = ConfigManager::get_system_config();
+    std::vector<std::string> extensions;
+    if (config["model_extensions"] && config["model_extensions"].IsSequence()) {
+        for (const auto& node : config["model_extensions"]) {
+            std::string extension = lowercase(node.as<std::string>());
+            if (!extension.empty() && extension.front() != '.') extension.insert(0, ".");
+            extensions.push_back(extension);
+        }
+    } else {
+        extensions = DEFAULT_EXTENSIONS;
+    }
+
+    std::vector<std::pair<std::string, std::vector<std::string>>> files;
+    auto add = [&files](const std::string& path, const std::string& source) {
+        auto found = std::find_if(files.begin(), files.end(),
+                                  [&path](const auto& file) { return file.first == path; });
+        if (found == files.end()) {
+            files.push_back({path, {}});
+            found = files.end() - 1;
+        }
+        found->second.push_back(source);
+    };
+
+    ConfigManager::for_each_config_value([&](const std::string& name, const std::string& key, const std::string& value) {
+        if (looks_like_model(value, extensions)) add(value, name + ":" + key);
+    });
+    if (config["model_files"] && config["model_files"].IsSequence()) {
+        for (const auto& node : config["model_files"]) {
+            add(node.as<std::string>(), "main:system.model_files");
+        }
+    }
+    return files;
+}
+
+bool ModelVerifier::hash_file(const std::string& path, std::string& digest, std::string& error) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        error = std::string("无法打开: ") + strerror(errno);
+        return false;
+    }
+    struct stat st{};
+    if (::fstat(fd, &st) != 0) {
+        error = std::string("无法获取文件信息: ") + strerror(errno);
+        ::close(fd);
+        return false;
+    }
+    // 提示内核按顺序大块预读，冷缓存时从 eMMC/NVMe 读取的速度接近顺序读上限
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    Sha256 sha;
+    std::vector<unsigned char> buffer(HASH_BLOCK);
+    const uint64_t size = static_cast<uint64_t>(st.st_size);
+    uint64_t offset = 0;
+    while (offset < size) {
+        if (CheckContext::cancelled()) {
+            error = "已取消";
+            ::close(fd);
+            return false;
+        }
+        const size_t length = static_cast<size_t>(std::min<uint64_t>(HASH_BLOCK, size - offset));
+        const ssize_t n = ::pread(fd, buffer.data(), length, static_cast<off_t>(offset));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            error = std::string("读取失败: ") + strerror(errno);
+            ::close(fd);
+            return false;
+        }
+        if (n == 0) {
+            error = "读取过程中文件被截断";
+            ::close(fd);
+            return false;
+        }
+        sha.update(buffer.data(), static_cast<size_t>(n));
+        offset += static_cast<uint64_t>(n);
+    }
+    ::close(fd);
+    digest = Sha256::to_hex(sha.finish());
+    return true;
+}
+
+SystemCheckResult ModelVerifier::check() {
+    Logger::info("执行模型文件检测");
+
+    YAML::Node config = ConfigManager::get_system_config();
+    const int max_threads = std::max(1, config["model_hash_threads"].as<int>(4));
+    std::unordered_map<std::string, std::string> expected;
+    if (config["model_digests"] && config["model_digests"].IsMap()) {
+        for (const auto& item : config["model_digests"]) {
+            expected[item.first.as<std::string>()] = lowercase(item.second.as<std::string>());
+        }
+    }
+
+    const auto files = collect_files();
+    if (files.empty()) {
+        return {"warning", "配置中没有需要校验的模型文件"};
+    }
+
+    struct Item {
+        std::string path;
+        bool exists = false;
+        bool cached = false;
+        FileKey key;
+        std::string digest;
+        std::string error;
+    };
+    std::vector<Item> items(files.size());
+    std::vector<size_t> pending;
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        for (size_t i = 0; i < files.size(); ++i) {
+            Item& item = items[i];
+            item.path = files[i].first;
+            struct stat st{};
+            if (::stat(item.path.c_str(), &st) != 0) {
+                item.error = errno == ENOENT ? "文件不存在" : std::string("无法访问: ") + strerror(errno);
+                continue;
+            }
+            if (!S_ISREG(st.st_mode)) {
+                item.error = "不是普通文件";
+                continue;
+            }
+            item.exists = true;
+            item.key = {static_cast<uint64_t>(st.st_dev), static_cast<uint64_t>(st.st_ino),
+                        static_cast<uint64_t>(st.st_size),
+                        static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec};
+            auto found = cache.find(item.path);
+            if (found != cache.end() && found->second.key == item.key) {
+                item.digest = found->second.digest;
+                item.cached = true;
+            } else {
+                pending.push_back(i);
+            }
+        }
+    }
+
+    // 未命中缓存的文件由工作线程并行计算（单个文件的 SHA-256 只能顺序计算）
+    uint64_t hashed_bytes = 0;
+    double hash_seconds = 0.0;
+    if (!pending.empty()) {
+        const auto start = std::chrono::steady_clock::now();
+        std::atomic<size_t> next{0};
+        const CheckContext::CancelToken token = CheckContext::token();
+        auto worker = [&] {
+            CheckContext::Scope scope(token);
+            for (size_t n = next++; n < pending.size(); n = next++) {
+                Item& item = items[pending[n]];
+                std::string error;
+                if (!hash_file(item.path, item.digest, error)) item.error = error;
+            }
+        };
+        const size_t thread_count = std::min(pending.size(), static_cast<size_t>(max_threads));
+        std::vector<std::thread> threads;
+        for (size_t t = 1; t < thread_count; ++t) threads.emplace_back(worker);
+        worker();
+        for (auto& thread : threads) thread.join();
+        hash_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        for (size_t index : pending) {
+            const Item& item = items[index];
+            if (!item.error.empty()) continue;
+            hashed_bytes += item.key.size;
+            cache[item.path] = {item.key, item.digest};
+        }
+    }
+
+    std::string status = "success";
+    std::vector<std::string> problems;
+    size_t verified = 0;
+    size_t cached = 0;
+    nlohmann::json list = nlohmann::json::array();
+    for (size_t i = 0; i < items.size(); ++i) {
+        const Item& item = items[i];
+        nlohmann::json entry = {
+            {"path", item.path},
+            {"sources", files[i].second},
+            {"exists", item.exists}
+        };
+        if (item.exists) entry["size"] = item.key.size;
+        if (!item.error.empty()) {
+            status = "error";
+            problems.push_back(item.path + " " + item.error);
+            entry["error"] = item.error;
+            list.push_back(std::move(entry));
+            continue;
+        }
+
+        entry["sha256"] = item.digest;
+        entry["cached"] = item.cached;
+        if (item.cached) ++cached;
+        auto want = expected.find(item.path);
+        if (want != expected.end()) {
+            const bool match = want->second == item.digest;
+            entry["expected"] = want->second;
+            entry["match"] = match;
+            if (!match) {
+                status = "error";
+                problems.push_back(item.path + " 摘要不一致");
+            } else {
+                ++verified;
+            }
+        }
+        list.push_back(std::move(entry));
+    }
+
+    std::ostringstream message;
+    message << items.size() << " 个模型文件";
+    if (!expected.empty()) message << "，" << verified << " 个与期望摘要一致";
+    message << "（缓存命中 " << cached;
+    if (hashed_bytes > 0) {
+        char rate[32];
+        snprintf(rate, sizeof(rate), "%.2f", hash_seconds > 0 ? hashed_bytes / 1e9 / hash_seconds : 0.0);
+        message << "，新计算 " << format_size(hashed_bytes) << " " << rate << " GB/s";
+    }
+    message << "）";
+    if (!problems.empty()) {
+        message << " [异常:";
+        for (const auto& problem : problems) message << " " << problem << ";";
+        message << "]";
+    }
+
+    nlohmann::json details = {
+        {"implementation", Sha256::implementation()},
+        {"hashed_bytes", hashed_bytes},
+        {"hash_seconds", hash_seconds},
+        {"files", list}
+    };
+    return {status, message.str(), details.dump()};
+}
@@ -0,0 +1,47 @@
+#ifndef MODEL_VERIFIER_H
+#define MODEL_VERIFIER_H
+
+#include "../types/common_types.h"
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 模型文件校验：从已加载的配置中收集模型等文件路径（按扩展名筛选，另可在
+// system.model_files 中补充），确认文件存在，并以 pread 分块读取计算 SHA-256，
+// 多个文件由工作线程并行计算。摘要按 (dev, inode, size, mtime) 缓存，
+// 文件未变化时重复检测只需一次 stat；配置了期望摘要（system.model_digests）的文件比对是否一致
+class ModelVerifier {
+public:
+    // 模型文件检测
+    static SystemCheckResult check();
+
+    // 收集需要校验的文件路径及引用它的配置项
+    static std::vector<std::pair<std::string, std::vector<std::string>>> collect_files();
+
+    // 分块 pread 读取并计算整个文件的 SHA-256，失败时返回 false 并填写 error
+    static bool hash_file(const std::string& path, std::string& digest, std::string& error);
+
+private:
+    struct FileKey {
+        uint64_t dev = 0;
+        uint64_t ino = 0;
+        uint64_t size = 0;
+        int64_t mtime_ns = 0;
+
+        bool operator==(const FileKey& other) const {
+            return dev == other.dev && ino == other.ino && size == other.size && mtime_ns == other.mtime_ns;
+        }
+    };
+
+    struct CacheEntry {
+        FileKey key;
+        std::string digest;
+    };
+
+    static std::mutex cache_mutex;
+    static std::unordered_map<std::string, CacheEntry> cache;   // 按路径索引
+};
+
+#endif // MODEL_VERIFIER_H
@@ -0,0 +1,334 @@
+#include "network_monitor.h"
+#include "event_bus.h"
+#include "metric_sampler.h"
+#include "../config/config_manager.h"
+#include "../utils/logger.h"
+#include "../utils/monotonic_clock.h"
+#include "../utils/string_utils.h"
+#include <algorithm>
+#include <chrono>
+#include <nlohmann/json.hpp>
+#include <sstream>
+#include <utility>
+
+// 静态成员初始化
+std::mutex NetworkMonitor::mutex;
+std::vector<NetworkMonitor::Interface> NetworkMonitor::interfaces;
+SysfsReader NetworkMonitor::net_dev;
+std::vector<std::string> NetworkMonitor::configured;
+std::string NetworkMonitor::uplink;
+int64_t NetworkMonitor::last_sample_ns = 0;
+double NetworkMonitor::last_elapsed_s = 0.0;
+bool NetworkMonitor::layout_changed = false;
+double NetworkMonitor::util_warn_percent = 80.0;
+double NetworkMonitor::drop_rate_warn = 10.0;
+double NetworkMonitor::error_rate_warn = 1.0;
+
+namespace {
+
+// 接口较多（容器 veth、CAN、隧道）时 /proc/net/dev 每行约 130 字节
+proc::FileBuffer<16384> net_dev_buffer;
+
+std::string format_mbps(double mbps) {
+    char buffer[32];
+    if (mbps >= 100) {
+        snprintf(buffer, sizeof(buffer), "%.0f Mbps", mbps);
+    } else if (mbps >= 1) {
+        snprintf(buffer, sizeof(buffer), "%.1f Mbps", mbps);
+    } else {
+        snprintf(buffer, sizeof(buffer), "%.0f kbps", mbps * 1000);
+    }
+    return buffer;
+}
+
+} // namespace
+
+void NetworkMonitor::initialize() {
+    YAML::Node config = ConfigManager::get_system_config();
+    util_warn_percent = config["network_util_warn_percent"].as<double>(80.0);
+    drop_rate_warn = config["network_drop_rate_warn"].as<double>(10.0);
+    error_rate_warn = config["network_error_rate_warn"].as<double>(1.0);
+    uplink = config["network_uplink"].as<std::string>("");
+    configured.clear();
+    if (config["network_interfaces"] && config["network_interfaces"].IsSequence()) {
+        for (const auto& node : config["network_interfaces"]) {
+            configured.push_back(node.as<std::string>());
+        }
+    }
+    if (!uplink.empty() && !wanted(uplink)) configured.push_back(uplink);
+    const int sample_hz = std::clamp(config["network_sample_hz"].as<int>(1), 1, 10);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!net_dev.open({"/proc/net/dev"}) || !discover()) {
+            Logger::warning("无法解析 /proc/net/dev，网络监控不可用");
+            return;
+        }
+        std::string names;
+        for (const auto& iface : interfaces) {
+            names += (names.empty() ? "" : ", ") + iface.name;
+        }
+        Logger::info("网络接口: " + (names.empty() ? std::string("无") : names) +
+                     (uplink.empty() ? "" : "，上行接口 " + uplink));
+    }
+    MetricSampler::register_task("network", std::chrono::milliseconds(1000 / sample_hz), &NetworkMonitor::sample);
+}
+
+bool NetworkMonitor::wanted(const std::string& name) {
+    if (configured.empty()) return name != "lo";
+    return std::find(configured.begin(), configured.end(), name) != configured.end();
+}
+
+NetworkMonitor::Interface NetworkMonitor::make_interface(const std::string& name) {
+    Interface iface;
+    iface.name = name;
+    const std::string base = "/sys/class/net/" + name + "/";
+    iface.operstate.open({base + "operstate"});
+    iface.carrier.open({base + "carrier"});
+    iface.speed.open({base + "speed"});
+    iface.rx_series = "net." + name + ".rx_mbps";
+    iface.tx_series = "net." + name + ".tx_mbps";
+    iface.drop_series = "net." + name + ".drop_per_s";
+    return iface;
+}
+
+bool NetworkMonitor::discover() {
+    layout_changed = false;
+    if (!net_dev_buffer.load(net_dev)) return false;
+
+    // 已有接口沿用常驻 fd、计数基线与指标名称
+    std::vector<Interface> previous;
+    previous.swap(interfaces);
+    proc::LineScanner lines(net_dev_buffer.view());
+    std::string_view line;
+    while (lines.next(line)) {
+        std::string_view name;
+        proc::NetDevStats stats;
+        if (!proc::parse_netdev_line(line, name, stats)) continue;
+        const std::string key(name);
+        if (!wanted(key)) continue;
+
+        auto found = std::find_if(previous.begin(), previous.end(),
+                                  [&key](const Interface& iface) { return iface.name == key; });
+        if (found != previous.end()) {
+            interfaces.push_back(std::move(*found));
+            continue;
+        }
+        interfaces.push_back(make_interface(key));
+    }
+    // 配置中列出但当前不存在的接口（如尚未插入的 USB 网卡）保留为缺失状态，其余已消失的接口丢弃
+    for (const auto& name : configured) {
+        auto present = std::find_if(interfaces.begin(), interfaces.end(),
+                                    [&name](const Interface& iface) { return iface.name == name; });
+        if (present != interfaces.end()) continue;
+        auto found = std::find_if(previous.begin(), previous.end(),
+                                  [&name](const Interface& iface) { return iface.name == name; });
+        Interface iface = found != previous.end() ? std::move(*found) : make_interface(name);
+        iface.present = false;
+        iface.has_last = false;
+        iface.link = false;
+        iface.state = "absent";
+        interfaces.push_back(std::move(iface));
+    }
+    return true;
+}
+
+void NetworkMonitor::read_link(Interface& iface) {
+    // 接口被删除后重建（USB 网卡/4G 模块重新枚举）时旧 fd 读取失败，按路径重新打开
+    char text[32];
+    ssize_t n = iface.operstate.read(text, sizeof(text));
+    if (n <= 0) {
+        const std::string base = "/sys/class/net/" + iface.name + "/";
+        iface.operstate.open({base + "operstate"});
+        iface.carrier.open({base + "carrier"});
+        iface.speed.open({base + "speed"});
+        n = iface.operstate.read(text, sizeof(text));
+    }
+    iface.state = n > 0 ? trim(std::string_view(text, static_cast<size_t>(n))) : "unknown";
+
+    long value = 0;
+    iface.link = iface.carrier.read_long(value) && value == 1;
+    iface.speed_mbps = iface.link && iface.speed.read_long(value) && value > 0 ? value : -1;
+}
+
+void NetworkMonitor::sample() {
+    std::vector<std::pair<std::string, std::string>> events;   // (状态, 消息)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!net_dev.is_open()) return;
+        if (layout_changed && !discover()) return;
+        if (!net_dev_buffer.load(net_dev)) return;
+
+        const int64_t now_ns = monotonic_ns();
+        const double elapsed_s = last_sample_ns > 0 ? (now_ns - last_sample_ns) / 1e9 : 0.0;
+        last_sample_ns = now_ns;
+
+        for (auto& iface : interfaces) iface.present = false;
+        proc::LineScanner lines(net_dev_buffer.view());
+        std::string_view line;
+        while (lines.next(line)) {
+            std::string_view name;
+            proc::NetDevStats stats;
+            if (!proc::parse_netdev_line(line, name, stats)) continue;
+
+            // 接口数量通常不超过 10 个，线性查找即可
+            Interface* iface = nullptr;
+            for (auto& candidate : interfaces) {
+                if (candidate.name == name) {
+                    iface = &candidate;
+                    break;
+                }
+            }
+            if (!iface) {
+                // 新出现的接口在下次采样前重新发现
+                if (wanted(std::string(name))) layout_changed = true;
+                continue;
+            }
+            iface->present = true;
+
+            if (iface->has_last && elapsed_s > 0) {
+                // 内核计数为 64 位，无符号差分可处理驱动重置计数以外的情况
+                const auto& last = iface->last;
+                auto rate = [elapsed_s](uint64_t current, uint64_t previous) {
+                    return current >= previous ? static_cast<double>(current - previous) / elapsed_s : 0.0;
+                };
+                iface->rx_mbps = rate(stats.rx_bytes, last.rx_bytes) * 8 / 1e6;
+                iface->tx_mbps = rate(stats.tx_bytes, last.tx_bytes) * 8 / 1e6;
+                iface->rx_pps = rate(stats.rx_packets, last.rx_packets);
+                iface->tx_pps = rate(stats.tx_packets, last.tx_packets);
+                iface->drop_rate = rate(stats.rx_dropped, last.rx_dropped) + rate(stats.tx_dropped, last.tx_dropped);
+                iface->error_rate = rate(stats.rx_errors, last.rx_errors) + rate(stats.tx_errors, last.tx_errors);
+                MetricSampler::record(iface->rx_series, iface->rx_mbps);
+                MetricSampler::record(iface->tx_series, iface->tx_mbps);
+                MetricSampler::record(iface->drop_series, iface->drop_rate);
+            }
+            iface->last = stats;
+            iface->has_last = true;
+        }
+
+        for (auto& iface : interfaces) {
+            const bool had_link = iface.link;
+            const bool was_present = iface.state != "absent";
+            if (iface.present) {
+                read_link(iface);
+            } else {
+                // 接口消失后保留的速率已失效，清零以免检测和 JSON 中继续报告
+                iface.has_last = false;
+                iface.link = false;
+                iface.state = "absent";
+                iface.rx_mbps = iface.tx_mbps = 0.0;
+                iface.rx_pps = iface.tx_pps = 0.0;
+                iface.drop_rate = iface.error_rate = 0.0;
+            }
+            // 首次采样只建立基线，之后载波变化通过事件推送
+            if (elapsed_s > 0 && had_link != iface.link) {
+                const bool is_uplink = iface.name == uplink;
+                if (iface.link) {
+                    events.emplace_back("success", "网络接口 " + iface.name + " 链路恢复" +
+                                        (iface.speed_mbps > 0 ? " (" + std::to_string(iface.speed_mbps) + " Mb/s)" : ""));
+                } else {
+                    events.emplace_back(is_uplink ? "error" : "warning",
+                                        "网络接口 " + iface.name + (was_present && iface.present ? " 载波丢失" : " 已移除"));
+                }
+            }
+        }
+        last_elapsed_s = elapsed_s;
+    }
+    for (const auto& [status, message] : events) {
+        if (status == "success") {
+            Logger::info(message);
+        } else {
+            Logger::warning(message);
+        }
+        EventBus::publish("network", status, message);
+    }
+}
+
+SystemCheckResult NetworkMonitor::check() {
+    Logger::info("执行网络检测");
+
+    bool ready;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!net_dev.is_open()) {
+            return {"error", "无法读取 /proc/net/dev"};
+        }
+        ready = last_elapsed_s > 0;
+    }
+    if (!ready) MetricSampler::warm_up(&NetworkMonitor::sample);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (interfaces.empty()) {
+        return {"warning", "未发现需要监视的网络接口"};
+    }
+
+    std::string status = "success";
+    std::vector<std::string> warnings;
+    std::ostringstream message;
+    nlohmann::json list = nlohmann::json::array();
+    for (const auto& iface : interfaces) {
+        const bool is_uplink = iface.name == uplink;
+        const double utilization = iface.present && iface.speed_mbps > 0
+            ? 100.0 * std::max(iface.rx_mbps, iface.tx_mbps) / static_cast<double>(iface.speed_mbps) : 0.0;
+
+        if (!message.str().empty()) message << "; ";
+        message << iface.name << (is_uplink ? "(上行)" : "") << " ";
+        if (!iface.present) {
+            message << "不存在";
+        } else if (!iface.link) {
+            message << "无载波 (" << iface.state << ")";
+        } else {
+            if (iface.speed_mbps > 0) message << iface.speed_mbps << " Mb/s, ";
+            message << "收 " << format_mbps(iface.rx_mbps) << " 发 " << format_mbps(iface.tx_mbps);
+        }
+
+        if (is_uplink && !iface.link) {
+            status = "error";
+            warnings.push_back("上行接口 " + iface.name + (iface.present ? " 无载波" : " 不存在"));
+        }
+        if (iface.present && iface.drop_rate >= drop_rate_warn) {
+            warnings.push_back(iface.name + " 丢包 " + std::to_string(static_cast<long>(iface.drop_rate)) + "/s");
+        }
+        if (iface.present && iface.error_rate >= error_rate_warn) {
+            warnings.push_back(iface.name + " 错误 " + std::to_string(static_cast<long>(iface.error_rate)) + "/s");
+        }
+        if (iface.present && utilization >= util_warn_percent) {
+            warnings.push_back(iface.name + " 链路利用率 " + std::to_string(static_cast<int>(utilization)) + "%");
+        }
+
+        list.push_back({
+            {"name", iface.name},
+            {"uplink", is_uplink},
+            {"present", iface.present},
+            {"operstate", iface.state},
+            {"carrier", iface.link},
+            {"speed_mbps", iface.speed_mbps},
+            {"rx_mbps", iface.rx_mbps},
+            {"tx_mbps", iface.tx_mbps},
+            {"rx_pps", iface.rx_pps},
+            {"tx_pps", iface.tx_pps},
+            {"drop_per_s", iface.drop_rate},
+            {"error_per_s", iface.error_rate},
+            {"utilization_percent", utilization},
+            {"rx_bytes", iface.last.rx_bytes},
+            {"tx_bytes", iface.last.tx_bytes},
+            {"rx_dropped", iface.last.rx_dropped},
+            {"tx_dropped", iface.last.tx_dropped}
+        });
+    }
+
+    std::string text = message.str();
+    if (!warnings.empty()) {
+        if (status == "success") status = "warning";
+        text += " [告警:";
+        for (const auto& warning : warnings) text += " " + warning;
+        text += "]";
+    }
+
+    nlohmann::json details = {
+        {"window_s", last_elapsed_s},
+        {"uplink", uplink},
+        {"interfaces", list}
+    };
+    return {status, text, details.dump()};
+}
@@ -0,0 +1,69 @@
+#ifndef NETWORK_MONITOR_H
+#define NETWORK_MONITOR_H
+
+#include "../types/common_types.h"
+#include "../utils/proc_parser.h"
+#include "../utils/sysfs_reader.h"
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 网络监控：每次采样一次 pread 读取 /proc/net/dev 得到全部接口的收发计数，
+// 并通过常驻 fd 读取 /sys/class/net/<if>/{operstate,carrier,speed}，
+// 计算各接口的收发速率、丢包与错误速率和链路利用率，写入指标采样器，
+// 以便把图片下载变慢与地面站数据链路饱和对应起来
+class NetworkMonitor {
+public:
+    // 发现网络接口并注册后台采样任务
+    static void initialize();
+
+    // 采样一次并计算速率，供采样线程调用
+    static void sample();
+
+    // 网络检测：报告各接口的链路状态与速率，上行接口断开时报错
+    static SystemCheckResult check();
+
+private:
+    struct Interface {
+        std::string name;
+        SysfsReader operstate;
+        SysfsReader carrier;           // 接口 down 时读取返回 EINVAL
+        SysfsReader speed;             // 虚拟接口没有速率，读取失败或为 -1
+        std::string rx_series;         // 预先生成的指标名称
+        std::string tx_series;
+        std::string drop_series;
+        proc::NetDevStats last;
+        bool has_last = false;
+        bool present = false;          // 本次采样在 /proc/net/dev 中出现
+        std::string state = "unknown";
+        bool link = false;             // 有载波
+        long speed_mbps = -1;
+        double rx_mbps = 0.0;          // 速率单位为 Mbit/s，与链路速率一致
+        double tx_mbps = 0.0;
+        double rx_pps = 0.0;
+        double tx_pps = 0.0;
+        double drop_rate = 0.0;        // 收发丢包合计（个/秒）
+        double error_rate = 0.0;
+    };
+
+    static Interface make_interface(const std::string& name);
+    static bool discover();
+    static bool wanted(const std::string& name);
+    static void read_link(Interface& iface);
+
+    static std::mutex mutex;
+    static std::vector<Interface> interfaces;
+    static SysfsReader net_dev;
+    static std::vector<std::string> configured;    // 为空时监视 lo 以外的全部接口
+    static std::string uplink;
+    static int64_t last_sample_ns;
+    static double last_elapsed_s;
+    static bool layout_changed;
+
+    static double util_warn_percent;
+    static double drop_rate_warn;
+    static double error_rate_warn;
+};
+
+#endif // NETWORK_MONITOR_H
@@ -0,0 +1,464 @@
+#include "process_monitor.h"
+#include "event_bus.h"
+#include "load_shedder.h"
+#include "metric_sampler.h"
+#include "../config/config_manager.h"
+#include "../utils/logger.h"
+#include "../utils/monotonic_clock.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <nlohmann/json.hpp>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+
+// 静态成员初始化
+std::mutex ProcessMonitor::mutex;
+std::vector<ProcessMonitor::Watched> ProcessMonitor::watched;
+int64_t ProcessMonitor::next_resolve_ns = 0;
+int64_t ProcessMonitor::last_sample_ns = 0;
+double ProcessMonitor::run_delay_warn_percent = 20.0;
+
+namespace {
+
+// 未运行的进程每秒最多重新查找一次；线程列表每 5 秒刷新一次（线程数变化时立即刷新）
+constexpr int64_t RESOLVE_INTERVAL_NS = 1000000000LL;
+constexpr int64_t TASK_SCAN_INTERVAL_NS = 5000000000LL;
+// 每个进程最多为多少个线程保持 schedstat fd
+constexpr size_t MAX_TASKS = 256;
+// 采样频率最低为 1 Hz，超过该时长没有新采样说明采样任务停滞，任务门控不再信任结果
+constexpr int64_t MISSION_SAMPLE_MAX_AGE_NS = 3000000000LL;
+
+const long PAGE_KB = sysconf(_SC_PAGESIZE) / 1024;
+const long CLOCK_TICKS = sysconf(_SC_CLK_TCK);
+
+// 把目录项名解析为 PID/TID，非数字返回 -1
+int parse_id(const char* name) {
+    uint64_t id = 0;
+    if (!proc::parse_u64(name, id) || id == 0 || id > 0x7fffffff) return -1;
+    for (const char* c = name; *c; ++c) {
+        if (*c < '0' || *c > '9') return -1;
+    }
+    return static_cast<int>(id);
+}
+
+// 读取 /proc 下的小文件（comm、cmdline、pidfile），返回读取的字节数
+ssize_t read_small_file(const char* path, char* buffer, size_t capacity) {
+    int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+    ssize_t n = ::read(fd, buffer, capacity);
+    ::close(fd);
+    return n;
+}
+
+std::string_view trim_newline(const char* data, ssize_t n) {
+    if (n <= 0) return {};
+    size_t size = static_cast<size_t>(n);
+    while (size > 0 && (data[size - 1] == '\n' || data[size - 1] == ' ' || data[size - 1] == '\0')) --size;
+    return std::string_view(data, size);
+}
+
+bool matches(const ProcessWatchSpec& spec, int pid) {
+    char path[64];
+    char buffer[4096];
+    if (!spec.comm.empty()) {
+        snprintf(path, sizeof(path), "/proc/%d/comm", pid);
+        if (trim_newline(buffer, read_small_file(path, buffer, sizeof(buffer))) != spec.comm) return false;
+    }
+    if (!spec.cmdline.empty()) {
+        snprintf(path, sizeof(path), "/proc/%d/cmdline", pid);
+        ssize_t n = read_small_file(path, buffer, sizeof(buffer));
+        if (n <= 0) return false;  // 内核线程没有命令行
+        // 参数以 '\0' 分隔，替换为空格后做子串匹配
+        std::replace(buffer, buffer + n, '\0', ' ');
+        if (std::string_view(buffer, static_cast<size_t>(n)).find(spec.cmdline) == std::string_view::npos) return false;
+    }
+    return !spec.comm.empty() || !spec.cmdline.empty();
+}
+
+int read_pidfile(const std::string& path) {
+    char buffer[32];
+    uint64_t pid = 0;
+    std::string_view text = trim_newline(buffer, read_small_file(path.c_str(), buffer, sizeof(buffer)));
+    if (!proc::parse_u64(text, pid) || pid == 0 || pid > 0x7fffffff) return -1;
+    return static_cast<int>(pid);
+}
+
+const char* state_name(char state) {
+    switch (state) {
+        case 'R': return "运行";
+        case 'S': return "睡眠";
+        case 'D': return "不可中断";
+        case 'Z': return "僵尸";
+        case 'T': case 't': return "停止";
+        default: return "未知";
+    }
+}
+
+} // namespace
+
+void ProcessMonitor::initialize() {
+    YAML::Node config = ConfigManager::get_system_config();
+    run_delay_warn_percent = config["process_run_delay_warn_percent"].as<double>(20.0);
+    const int sample_hz = std::clamp(config["process_sample_hz"].as<int>(20), 1, 20);
+
+    for (const auto& node : config["watch_processes"]) {
+        ProcessWatchSpec spec;
+        spec.name = node["name"].as<std::string>("");
+        spec.comm = node["comm"].as<std::string>("");
+        spec.cmdline = node["cmdline"].as<std::string>("");
+        spec.pidfile = node["pidfile"].as<std::string>("");
+        spec.config = node["config"].as<std::string>("");
+        spec.required = node["required"].as<bool>(true);
+        if (spec.name.empty() || (spec.comm.empty() && spec.cmdline.empty() && spec.pidfile.empty())) {
+            Logger::warning("忽略无效的监视进程配置（需要 name 以及 comm/cmdline/pidfile 之一）");
+            continue;
+        }
+        watch(spec);
+    }
+
+    if (watched.empty()) {
+        Logger::info("未配置监视进程（system.watch_processes）");
+        return;
+    }
+    sample();
+    MetricSampler::register_task("process", std::chrono::milliseconds(1000 / sample_hz), &ProcessMonitor::sample);
+}
+
+void ProcessMonitor::watch(const ProcessWatchSpec& spec) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Watched entry;
+    entry.stats.spec = spec;
+    entry.cpu_series = "process." + spec.name + ".cpu_percent";
+    entry.rss_series = "process." + spec.name + ".rss_mb";
+    entry.ctx_series = "process." + spec.name + ".ctx_switches_per_s";
+    entry.delay_series = "process." + spec.name + ".run_delay_percent";
+    watched.push_back(std::move(entry));
+    next_resolve_ns = 0;
+}
+
+void ProcessMonitor::resolve(int64_t now_ns) {
+    if (now_ns < next_resolve_ns) return;
+    next_resolve_ns = now_ns + RESOLVE_INTERVAL_NS;
+
+    bool need_scan = false;
+    for (auto& entry : watched) {
+        if (entry.stats.running) continue;
+        const ProcessWatchSpec& spec = entry.stats.spec;
+        if (!spec.pidfile.empty()) {
+            int pid = read_pidfile(spec.pidfile);
+            if (pid > 0 && attach(entry, pid, now_ns)) continue;
+        }
+        if (!spec.comm.empty() || !spec.cmdline.empty()) need_scan = true;
+    }
+    if (!need_scan) return;
+
+    // 一次遍历 /proc 为所有未解析的进程查找匹配项，取 PID 最小（通常最早启动）的一个
+    DIR* dir = opendir("/proc");
+    if (!dir) return;
+    const int self = getpid();
+    std::vector<int> pids;
+    while (dirent* item = readdir(dir)) {
+        int pid = parse_id(item->d_name);
+        if (pid > 0 && pid != self) pids.push_back(pid);
+    }
+    closedir(dir);
+    std::sort(pids.begin(), pids.end());
+
+    for (auto& entry : watched) {
+        const ProcessWatchSpec& spec = entry.stats.spec;
+        if (entry.stats.running || (spec.comm.empty() && spec.cmdline.empty())) continue;
+        for (int pid : pids) {
+            if (matches(spec, pid) && attach(entry, pid, now_ns)) break;
+        }
+    }
+}
+
+bool ProcessMonitor::attach(Watched& entry, int pid, int64_t now_ns) {
+    const std::string base = "/proc/" + std::to_string(pid);
+    SysfsReader stat({base + "/stat"});
+    SysfsReader statm({base + "/statm"});
+    proc::FileBuffer<1024> buffer;
+    proc::PidStat pid_stat;
+    if (!buffer.load(stat) || !proc::parse_pid_stat(buffer.view(), pid_stat) || pid_stat.state == 'Z') {
+        return false;
+    }
+
+    ProcessStats& stats = entry.stats;
+    const bool reappeared = stats.pid > 0;
+    if (reappeared) ++stats.restarts;
+    stats.running = true;
+    stats.pid = pid;
+    stats.state = pid_stat.state;
+    stats.threads = pid_stat.num_threads;
+    stats.rates_valid = false;
+    entry.starttime = pid_stat.starttime;
+    entry.stat = std::move(stat);
+    entry.statm = std::move(statm);
+    entry.tasks.clear();
+    entry.last_cpu_ticks = pid_stat.utime + pid_stat.stime;
+    entry.last_sample_ns = 0;
+    scan_tasks(entry, now_ns);
+
+    std::string message = "监视进程 " + stats.spec.name + " 已" + (reappeared ? "重新" : "") +
+                          "运行，PID " + std::to_string(pid) + "，线程 " + std::to_string(stats.threads);
+    Logger::info(message);
+    if (reappeared) EventBus::publish("process", "success", message);
+    return true;
+}
+
+void ProcessMonitor::detach(Watched& entry) {
+    ProcessStats& stats = entry.stats;
+    const std::string message = "监视进程 " + stats.spec.name + " (PID " + std::to_string(stats.pid) + ") 已退出";
+    Logger::warning(message);
+    EventBus::publish("process", stats.spec.required ? "error" : "warning", message);
+
+    stats.running = false;
+    stats.rates_valid = false;
+    stats.state = '?';
+    stats.threads = 0;
+    stats.rss_kb = 0;
+    stats.cpu_percent = 0.0;
+    stats.ctx_switches_per_s = 0.0;
+    stats.run_delay_percent = 0.0;
+    entry.stat.close();
+    entry.statm.close();
+    entry.tasks.clear();
+    // 退出后尽快重新查找，以便捕捉守护脚本拉起的新进程
+    next_resolve_ns = 0;
+}
+
+void ProcessMonitor::scan_tasks(Watched& entry, int64_t now_ns) {
+    entry.next_task_scan_ns = now_ns + TASK_SCAN_INTERVAL_NS;
+    const std::string task_dir = "/proc/" + std::to_string(entry.stats.pid) + "/task";
+    DIR* dir = opendir(task_dir.c_str());
+    if (!dir) return;
+
+    std::vector<Task> tasks;
+    while (dirent* item = readdir(dir)) {
+        int tid = parse_id(item->d_name);
+        if (tid < 0) continue;
+        if (tasks.size() >= MAX_TASKS) break;
+
+        // 已有的线程沿用 fd 与上次计数，新线程以当前计数为基线
+        auto existing = std::find_if(entry.tasks.begin(), entry.tasks.end(),
+                                     [tid](const Task& task) { return task.tid == tid; });
+        if (existing != entry.tasks.end()) {
+            tasks.push_back(std::move(*existing));
+            continue;
+        }
+        Task task;
+        task.tid = tid;
+        if (!task.schedstat.open({task_dir + "/" + item->d_name + "/schedstat"})) continue;
+        proc::FileBuffer<128> buffer;
+        if (buffer.load(task.schedstat)) proc::parse_schedstat(buffer.view(), task.last);
+        tasks.push_back(std::move(task));
+    }
+    closedir(dir);
+    entry.tasks = std::move(tasks);
+}
+
+void ProcessMonitor::sample_one(Watched& entry, int64_t now_ns) {
+    ProcessStats& stats = entry.stats;
+
+    // 进程退出后常驻 fd 的 pread 返回 ESRCH；starttime 变化说明 PID 已被复用
+    proc::FileBuffer<1024> buffer;
+    proc::PidStat pid_stat;
+    if (!buffer.load(entry.stat) || !proc::parse_pid_stat(buffer.view(), pid_stat) ||
+        pid_stat.starttime != entry.starttime) {
+        detach(entry);
+        return;
+    }
+    stats.state = pid_stat.state;
+    if (stats.state == 'Z') {
+        detach(entry);
+        return;
+    }
+
+    proc::FileBuffer<128> statm_buffer;
+    proc::PidStatm statm;
+    if (statm_buffer.load(entry.statm) && proc::parse_pid_statm(statm_buffer.view(), statm)) {
+        stats.rss_kb = statm.resident * static_cast<uint64_t>(PAGE_KB);
+    }
+
+    if (pid_stat.num_threads != stats.threads || now_ns >= entry.next_task_scan_ns) {
+        stats.threads = pid_stat.num_threads;
+        scan_tasks(entry, now_ns);
+    }
+
+    uint64_t cpu_ns = 0;
+    uint64_t delay_ns = 0;
+    uint64_t switches = 0;
+    for (auto& task : entry.tasks) {
+        proc::FileBuffer<128> task_buffer;
+        proc::SchedStat current;
+        if (!task_buffer.load(task.schedstat) || !proc::parse_schedstat(task_buffer.view(), current)) continue;
+        if (current.cpu_ns >= task.last.cpu_ns) cpu_ns += current.cpu_ns - task.last.cpu_ns;
+        if (current.run_delay_ns >= task.last.run_delay_ns) delay_ns += current.run_delay_ns - task.last.run_delay_ns;
+        if (current.timeslices >= task.last.timeslices) switches += current.timeslices - task.last.timeslices;
+        task.last = current;
+    }
+    const uint64_t cpu_ticks = pid_stat.utime + pid_stat.stime;
+
+    if (entry.last_sample_ns > 0 && now_ns > entry.last_sample_ns) {
+        const double elapsed_ns = static_cast<double>(now_ns - entry.last_sample_ns);
+        if (entry.tasks.empty()) {
+            // 内核未提供 schedstat：按时钟滴答估算 CPU，排队与切换不可用
+            const uint64_t ticks = cpu_ticks >= entry.last_cpu_ticks ? cpu_ticks - entry.last_cpu_ticks : 0;
+            stats.cpu_percent = 100.0 * static_cast<double>(ticks) * 1e9 / CLOCK_TICKS / elapsed_ns;
+        } else {
+            stats.cpu_percent = 100.0 * static_cast<double>(cpu_ns) / elapsed_ns;
+            stats.run_delay_percent = 100.0 * static_cast<double>(delay_ns) / elapsed_ns;
+            stats.ctx_switches_per_s = static_cast<double>(switches) * 1e9 / elapsed_ns;
+            MetricSampler::record(entry.ctx_series, stats.ctx_switches_per_s);
+            MetricSampler::record(entry.delay_series, stats.run_delay_percent);
+        }
+        stats.rates_valid = true;
+        stats.has_schedstat = !entry.tasks.empty();
+        MetricSampler::record(entry.cpu_series, stats.cpu_percent);
+    }
+    MetricSampler::record(entry.rss_series, stats.rss_kb / 1024.0);
+    entry.last_cpu_ticks = cpu_ticks;
+    entry.last_sample_ns = now_ns;
+}
+
+void ProcessMonitor::sample() {
+    std::lock_guard<std::mutex> lock(mutex);
+    const int64_t now_ns = monotonic_ns();
+    resolve(now_ns);
+    for (auto& entry : watched) {
+        if (entry.stats.running) sample_one(entry, now_ns);
+    }
+    last_sample_ns = now_ns;
+}
+
+std::vector<ProcessStats> ProcessMonitor::get_processes() {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<ProcessStats> result;
+    result.reserve(watched.size());
+    for (const auto& entry : watched) {
+        result.push_back(entry.stats);
+    }
+    return result;
+}
+
+bool ProcessMonitor::mission_active(const std::vector<std::string>& names, std::string& reason) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (names.empty()) return false;
+    if (last_sample_ns == 0 || monotonic_ns() - last_sample_ns > MISSION_SAMPLE_MAX_AGE_NS) {
+        reason = "进程监视尚无有效采样，无法确认飞控进程未运行";
+        return true;
+    }
+    for (const auto& name : names) {
+        auto entry = std::find_if(watched.begin(), watched.end(),
+                                  [&](const Watched& candidate) { return candidate.stats.spec.name == name; });
+        if (entry == watched.end()) {
+            reason = "飞控进程 " + name + " 不在 watch_processes 中，无法确认其未运行";
+            return true;
+        }
+        if (entry->stats.running) {
+            reason = "飞控进程 " + name + " 正在运行";
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ProcessMonitor::self_test_blocked(const YAML::Node& config, const char* list_key, std::string& reason) {
+    if (LoadShedder::shedding()) {
+        reason = "系统处于降载状态";
+        return true;
+    }
+    std::vector<std::string> names;
+    if (config[list_key]) {
+        for (const auto& node : config[list_key]) names.push_back(node.as<std::string>());
+    }
+    return mission_active(names, reason);
+}
+
+SystemCheckResult ProcessMonitor::check() {
+    Logger::info("执行进程检测");
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (watched.empty()) {
+            return {"success", "未配置监视进程"};
+        }
+        // 检测时立即重新查找未运行的进程，不等节流间隔
+        next_resolve_ns = 0;
+    }
+    sample();
+    std::vector<ProcessStats> processes = get_processes();
+    if (std::any_of(processes.begin(), processes.end(),
+                    [](const ProcessStats& p) { return p.running && !p.rates_valid; })) {
+        // 刚解析到的进程还没有速率，现场补一次间隔 100 ms 的采样
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        sample();
+        processes = get_processes();
+    }
+
+    std::string status = "success";
+    std::vector<std::string> warnings;
+    std::ostringstream message;
+    nlohmann::json list = nlohmann::json::array();
+
+    for (size_t i = 0; i < processes.size(); ++i) {
+        const ProcessStats& p = processes[i];
+        if (i > 0) message << "; ";
+        message << p.spec.name << ": ";
+
+        if (!p.running) {
+            message << "未运行";
+            if (p.spec.required) {
+                status = "error";
+            } else {
+                warnings.push_back(p.spec.name + " 未运行");
+            }
+        } else {
+            message << "PID " << p.pid << " " << state_name(p.state);
+            if (p.rates_valid) message << ", CPU " << static_cast<int>(p.cpu_percent + 0.5) << "%";
+            message << ", RSS " << p.rss_kb / 1024 << "MB, 线程 " << p.threads;
+            if (p.rates_valid && p.has_schedstat) {
+                char delay[32];
+                snprintf(delay, sizeof(delay), "%.1f", p.run_delay_percent);
+                message << ", 排队 " << delay << "%";
+                if (p.run_delay_percent >= run_delay_warn_percent) {
+                    warnings.push_back(p.spec.name + " 调度排队过长");
+                }
+            }
+            if (p.restarts > 0) {
+                message << ", 重启 " << p.restarts << " 次";
+                warnings.push_back(p.spec.name + " 曾重启");
+            }
+        }
+
+        list.push_back({
+            {"name", p.spec.name},
+            {"config", p.spec.config},
+            {"required", p.spec.required},
+            {"running", p.running},
+            {"pid", p.running ? p.pid : -1},
+            {"state", std::string(1, p.state)},
+            {"threads", p.threads},
+            {"rss_kb", p.rss_kb},
+            {"cpu_percent", p.cpu_percent},
+            {"ctx_switches_per_s", p.ctx_switches_per_s},
+            {"run_delay_percent", p.run_delay_percent},
+            {"restarts", p.restarts}
+        });
+    }
+
+    if (!warnings.empty()) {
+        if (status == "success") status = "warning";
+        message << " [告警:";
+        for (const auto& warning : warnings) message << " " << warning;
+        message << "]";
+    }
+
+    nlohmann::json details = {{"processes", list}};
+    return {status, message.str(), details.dump()};
+}
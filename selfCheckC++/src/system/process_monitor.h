@@ -0,0 +1,102 @@
+#ifndef PROCESS_MONITOR_H
+#define PROCESS_MONITOR_H
+
+#include "../types/common_types.h"
+#include "../utils/proc_parser.h"
+#include "../utils/sysfs_reader.h"
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <yaml-cpp/yaml.h>
+
+// 监视列表中的一项（见 config.yaml 的 system.watch_processes）
+struct ProcessWatchSpec {
+    std::string name;      // 展示名称与指标前缀，如 "vo"
+    std::string comm;      // 按 /proc/<pid>/comm 精确匹配（内核截断为 15 个字符）
+    std::string cmdline;   // 按命令行子串匹配，comm 无法区分时使用
+    std::string pidfile;   // 优先使用 pidfile 中的 PID
+    std::string config;    // 该进程使用的配置文件，仅用于展示
+    bool required = true;  // 未运行时判定为错误，否则仅提示
+};
+
+// 单个被监视进程的采样结果
+struct ProcessStats {
+    ProcessWatchSpec spec;
+    bool running = false;
+    int pid = -1;
+    char state = '?';
+    uint64_t threads = 0;
+    uint64_t rss_kb = 0;
+    bool rates_valid = false;        // 至少完成两次采样后才有速率
+    bool has_schedstat = false;      // 内核提供线程 schedstat 时才有排队时间与切换次数
+    double cpu_percent = 0.0;        // 以单核为 100%
+    double ctx_switches_per_s = 0.0; // 所有线程被调度上 CPU 的次数
+    double run_delay_percent = 0.0;  // 可运行但在就绪队列中等待的时间占比（所有线程合计）
+    uint64_t restarts = 0;           // 启动后观察到的 PID 变化次数
+};
+
+// 飞控进程监视：按名称或 pidfile 解析 VO/DMatcher/传输等进程，
+// 通过常驻的 /proc/<pid>/stat、statm 与各线程 schedstat fd 以 pread 高频采样，
+// 结果写入时间序列；进程退出或重新出现时通过 EventBus 推送事件
+class ProcessMonitor {
+public:
+    // 读取监视列表并注册采样任务
+    static void initialize();
+
+    // 追加一个监视项（initialize 与基准测试使用）
+    static void watch(const ProcessWatchSpec& spec);
+
+    // 采样所有监视进程，未解析的进程按节流间隔重新查找
+    static void sample();
+
+    // 最近一次采样结果
+    static std::vector<ProcessStats> get_processes();
+
+    // 按需测试的任务门控：names 中任一进程在运行、不在监视列表中或监视尚无新近采样时
+    // 返回 true 并填写 reason（无法确认时按任务进行中处理）；names 为空时不限制
+    static bool mission_active(const std::vector<std::string>& names, std::string& reason);
+
+    // 占用硬件的按需自测（硬件、调度延迟、串口回环）共用的门控：系统降载，或 config[list_key]
+    // 列出的飞控进程按 mission_active 判定为任务进行中时返回 true 并填写 reason
+    static bool self_test_blocked(const YAML::Node& config, const char* list_key, std::string& reason);
+
+    // 进程检测：必需进程未运行或为僵尸时报错，调度排队过高时告警
+    static SystemCheckResult check();
+
+private:
+    struct Task {
+        int tid = -1;
+        SysfsReader schedstat;
+        proc::SchedStat last;
+    };
+
+    struct Watched {
+        ProcessStats stats;
+        uint64_t starttime = 0;
+        SysfsReader stat;
+        SysfsReader statm;
+        std::vector<Task> tasks;
+        uint64_t last_cpu_ticks = 0;   // 无 schedstat 时退回 stat 中的 utime+stime
+        int64_t last_sample_ns = 0;
+        int64_t next_task_scan_ns = 0;
+        std::string cpu_series;     // 预先生成的指标名称
+        std::string rss_series;
+        std::string ctx_series;
+        std::string delay_series;
+    };
+
+    static void resolve(int64_t now_ns);
+    static bool attach(Watched& entry, int pid, int64_t now_ns);
+    static void detach(Watched& entry);
+    static void scan_tasks(Watched& entry, int64_t now_ns);
+    static void sample_one(Watched& entry, int64_t now_ns);
+
+    static std::mutex mutex;
+    static std::vector<Watched> watched;
+    static int64_t next_resolve_ns;
+    static int64_t last_sample_ns;     // 最近一次 sample() 的时间，0 表示尚未采样
+    static double run_delay_warn_percent;
+};
+
+#endif // PROCESS_MONITOR_H
@@ -0,0 +1,253 @@
+#include "process_table.h"
+#include "metric_sampler.h"
+#include "../config/config_manager.h"
+#include "../utils/logger.h"
+#include "../utils/monotonic_clock.h"
+#include "../utils/proc_parser.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// 静态成员初始化
+std::mutex ProcessTable::mutex;
+std::vector<ProcessTable::Entry> ProcessTable::entries;
+int ProcessTable::proc_fd = -1;
+size_t ProcessTable::cached_fds = 0;
+size_t ProcessTable::max_cached_fds = 1024;
+size_t ProcessTable::report_count = 5;
+int64_t ProcessTable::last_refresh_ns = 0;
+double ProcessTable::scan_ms = 0.0;
+
+namespace {
+
+// 两次遍历间隔不足该值时不更新 CPU 占用（时钟滴答为 10 ms，窗口太短误差过大）
+constexpr double MIN_CPU_WINDOW_S = 0.5;
+
+const long PAGE_KB = sysconf(_SC_PAGESIZE) / 1024;
+const long CLOCK_TICKS = sysconf(_SC_CLK_TCK);
+
+// getdents64 返回的目录项（glibc 2.30 之前没有提供该结构体）
+struct LinuxDirent64 {
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[1];   // 实际长度由 d_reclen 决定
+};
+
+// 纯数字的目录名即为进程号
+int parse_pid(const char* name) {
+    int pid = 0;
+    for (const char* c = name; *c; ++c) {
+        if (*c < '0' || *c > '9' || pid > 0x7fffffff / 10) return -1;
+        pid = pid * 10 + (*c - '0');
+    }
+    return pid > 0 ? pid : -1;
+}
+
+} // namespace
+
+void ProcessTable::initialize() {
+    YAML::Node config = ConfigManager::get_system_config();
+    report_count = std::max(1, config["top_process_count"].as<int>(5));
+    const int interval_ms = config["top_process_scan_ms"].as<int>(2000);
+
+    // 服务不使用 select()，可把 fd 软上限提高到 4096（不超过硬上限）；
+    // 常驻 fd 不超过软上限的四分之一，给连接与设备节点留出余量
+    rlimit limit{};
+    max_cached_fds = static_cast<size_t>(std::max(0, config["top_process_max_fds"].as<int>(1024)));
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        if (limit.rlim_cur != RLIM_INFINITY && limit.rlim_cur < 4096) {
+            rlimit raised = limit;
+            raised.rlim_cur = limit.rlim_max == RLIM_INFINITY ? 4096 : std::min<rlim_t>(4096, limit.rlim_max);
+            if (setrlimit(RLIMIT_NOFILE, &raised) == 0) limit = raised;
+        }
+        if (limit.rlim_cur != RLIM_INFINITY) {
+            max_cached_fds = std::min(max_cached_fds, static_cast<size_t>(limit.rlim_cur / 4));
+        }
+    }
+
+    proc_fd = ::open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (proc_fd < 0) {
+        Logger::error("无法打开 /proc: " + std::string(strerror(errno)));
+        return;
+    }
+
+    refresh();
+    char scan[32];
+    snprintf(scan, sizeof(scan), "%.2f", last_scan_ms());
+    Logger::info("进程表: " + std::to_string(process_count()) + " 个进程，遍历耗时 " + scan +
+                 " ms，常驻 fd 上限 " + std::to_string(max_cached_fds));
+    if (interval_ms > 0) {
+        MetricSampler::register_task("process_table", std::chrono::milliseconds(interval_ms), &ProcessTable::refresh);
+    }
+}
+
+bool ProcessTable::list_pids(std::vector<int>& pids) {
+    if (::lseek(proc_fd, 0, SEEK_SET) < 0) return false;
+
+    alignas(LinuxDirent64) char buffer[16384];
+    while (true) {
+        long n = ::syscall(SYS_getdents64, proc_fd, buffer, sizeof(buffer));
+        if (n < 0) return false;
+        if (n == 0) break;
+        for (long offset = 0; offset < n;) {
+            const auto* entry = reinterpret_cast<const LinuxDirent64*>(buffer + offset);
+            offset += entry->d_reclen;
+            if (entry->d_type != DT_DIR) continue;
+            int pid = parse_pid(entry->d_name);
+            if (pid > 0) pids.push_back(pid);
+        }
+    }
+    // procfs 按 PID 升序列出进程，保险起见仍做检查
+    if (!std::is_sorted(pids.begin(), pids.end())) {
+        std::sort(pids.begin(), pids.end());
+    }
+    return true;
+}
+
+bool ProcessTable::read_entry(Entry& entry, bool first, double elapsed_s) {
+    proc::FileBuffer<1024> buffer;
+    if (entry.stat.is_open()) {
+        // 进程退出后常驻 fd 的 pread 返回 ESRCH
+        if (!buffer.load(entry.stat)) return false;
+    } else {
+        SysfsReader reader({"/proc/" + std::to_string(entry.pid) + "/stat"});
+        if (!buffer.load(reader)) return false;
+        if (first && cached_fds < max_cached_fds) {
+            entry.stat = std::move(reader);
+            ++cached_fds;
+        }
+    }
+
+    proc::PidStat stat;
+    if (!proc::parse_pid_stat(buffer.view(), stat)) return false;
+    const uint64_t ticks = stat.utime + stat.stime;
+    if (first) {
+        entry.starttime = stat.starttime;
+        entry.comm.assign(stat.comm.data(), stat.comm.size());
+        entry.last_ticks = ticks;
+    } else if (stat.starttime != entry.starttime) {
+        // PID 已被复用，丢弃后在下次遍历时作为新进程加入
+        return false;
+    } else if (elapsed_s >= MIN_CPU_WINDOW_S) {
+        const uint64_t delta = ticks >= entry.last_ticks ? ticks - entry.last_ticks : 0;
+        entry.cpu_percent = 100.0 * static_cast<double>(delta) / CLOCK_TICKS / elapsed_s;
+        entry.last_ticks = ticks;
+    }
+    entry.rss_kb = stat.rss * static_cast<uint64_t>(PAGE_KB);
+    return true;
+}
+
+void ProcessTable::refresh() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (proc_fd < 0) return;
+
+    const int64_t start_ns = monotonic_ns();
+    std::vector<int> pids;
+    pids.reserve(entries.size() + 64);
+    if (!list_pids(pids)) {
+        Logger::error("遍历 /proc 失败: " + std::string(strerror(errno)));
+        return;
+    }
+
+    const double elapsed_s = last_refresh_ns > 0 ? (start_ns - last_refresh_ns) / 1e9 : 0.0;
+    const bool update_cpu = elapsed_s >= MIN_CPU_WINDOW_S;
+
+    // 新旧两个列表都按 PID 升序，一次归并即可区分存活、新增与退出的进程
+    std::vector<Entry> merged;
+    merged.reserve(pids.size());
+    auto drop = [](Entry& entry) {
+        if (entry.stat.is_open()) --cached_fds;
+    };
+    size_t old = 0;
+    for (int pid : pids) {
+        while (old < entries.size() && entries[old].pid < pid) {
+            drop(entries[old++]);
+        }
+        if (old < entries.size() && entries[old].pid == pid) {
+            Entry& entry = entries[old++];
+            if (read_entry(entry, false, elapsed_s)) {
+                merged.push_back(std::move(entry));
+            } else {
+                drop(entry);
+            }
+            continue;
+        }
+        Entry entry;
+        entry.pid = pid;
+        if (read_entry(entry, true, elapsed_s)) {
+            merged.push_back(std::move(entry));
+        } else {
+            drop(entry);
+        }
+    }
+    while (old < entries.size()) {
+        drop(entries[old++]);
+    }
+    entries.swap(merged);
+
+    if (update_cpu || last_refresh_ns == 0) {
+        last_refresh_ns = start_ns;
+    }
+    scan_ms = (monotonic_ns() - start_ns) / 1e6;
+}
+
+std::vector<ProcessConsumer> ProcessTable::top_by(size_t n, bool by_cpu) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto key = [by_cpu](const Entry& entry) {
+        return by_cpu ? entry.cpu_percent : static_cast<double>(entry.rss_kb);
+    };
+    // 以 greater 为比较器的堆即最小堆，堆顶是当前入选者中占用最小的
+    auto greater = [&key](const Entry* a, const Entry* b) { return key(*a) > key(*b); };
+
+    std::vector<const Entry*> heap;
+    heap.reserve(n);
+    for (const auto& entry : entries) {
+        if (n == 0 || key(entry) <= 0.0) continue;
+        if (heap.size() < n) {
+            heap.push_back(&entry);
+            std::push_heap(heap.begin(), heap.end(), greater);
+        } else if (key(entry) > key(*heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), greater);
+            heap.back() = &entry;
+            std::push_heap(heap.begin(), heap.end(), greater);
+        }
+    }
+    std::sort_heap(heap.begin(), heap.end(), greater);
+
+    std::vector<ProcessConsumer> result;
+    result.reserve(heap.size());
+    for (const Entry* entry : heap) {
+        result.push_back({entry->pid, entry->comm, entry->cpu_percent, entry->rss_kb});
+    }
+    return result;
+}
+
+std::vector<ProcessConsumer> ProcessTable::top_cpu(size_t n) {
+    return top_by(n, true);
+}
+
+std::vector<ProcessConsumer> ProcessTable::top_rss(size_t n) {
+    return top_by(n, false);
+}
+
+size_t ProcessTable::default_count() {
+    return report_count;
+}
+
+size_t ProcessTable::process_count() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+double ProcessTable::last_scan_ms() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return scan_ms;
+}
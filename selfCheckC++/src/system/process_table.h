@@ -0,0 +1,65 @@
+#ifndef PROCESS_TABLE_H
+#define PROCESS_TABLE_H
+
+#include "../utils/sysfs_reader.h"
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 全系统进程中的一个资源占用者
+struct ProcessConsumer {
+    int pid = -1;
+    std::string comm;
+    double cpu_percent = 0.0;   // 以单核为 100%，首次出现的进程为 0
+    uint64_t rss_kb = 0;
+};
+
+// 全系统进程表：用 getdents64 遍历 /proc，并与上次遍历的结果按 PID 有序归并，
+// 只为新出现的进程打开 /proc/<pid>/stat，已有进程复用常驻 fd 做一次 pread；
+// 通过大小为 N 的最小堆选出 CPU/RSS 占用最高的进程，不对全部进程排序
+class ProcessTable {
+public:
+    // 读取配置，必要时注册后台刷新任务（用于计算 CPU 占用）
+    static void initialize();
+
+    // 遍历一次 /proc 并更新所有进程的 CPU 与 RSS
+    static void refresh();
+
+    // CPU/RSS 占用最高的 n 个进程（降序）
+    static std::vector<ProcessConsumer> top_cpu(size_t n);
+    static std::vector<ProcessConsumer> top_rss(size_t n);
+
+    // 报告中默认列出的进程数（system.top_process_count）
+    static size_t default_count();
+
+    // 最近一次遍历的进程数与耗时
+    static size_t process_count();
+    static double last_scan_ms();
+
+private:
+    struct Entry {
+        int pid = -1;
+        uint64_t starttime = 0;
+        SysfsReader stat;          // 超出 fd 上限的进程不缓存，每次遍历临时打开
+        std::string comm;
+        uint64_t last_ticks = 0;
+        double cpu_percent = 0.0;
+        uint64_t rss_kb = 0;
+    };
+
+    static bool list_pids(std::vector<int>& pids);
+    static bool read_entry(Entry& entry, bool first, double elapsed_s);
+    static std::vector<ProcessConsumer> top_by(size_t n, bool by_cpu);
+
+    static std::mutex mutex;
+    static std::vector<Entry> entries;   // 按 PID 升序
+    static int proc_fd;
+    static size_t cached_fds;
+    static size_t max_cached_fds;
+    static size_t report_count;
+    static int64_t last_refresh_ns;
+    static double scan_ms;
+};
+
+#endif // PROCESS_TABLE_H
@@ -0,0 +1,316 @@
+#include "serial_loopback.h"
+#include "check_context.h"
+#include "process_monitor.h"
+#include "../config/config_manager.h"
+#include "../utils/logger.h"
+#include "../utils/monotonic_clock.h"
+#include "../utils/serial_port.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <poll.h>
+#include <sstream>
+#include <termios.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+// 吞吐测试中未被回显的字节上限，避免超过内核 tty 接收缓冲（4 KiB）造成溢出丢字节
+constexpr size_t MAX_IN_FLIGHT = 1024;
+// serial_loopback 的检测超时为 8 s，测试时长上限留出打开、配置与恢复串口的余量
+constexpr int MAX_TEST_MS = 6000;
+
+// 同一时刻只允许一次测试：find_user 不把本进程算作占用者，并发请求会同时打开同一串口
+std::mutex run_mutex;
+
+// 测试图案：按位置生成的伪随机字节，覆盖全部 256 个取值
+inline uint8_t pattern_byte(size_t index) {
+    return static_cast<uint8_t>((static_cast<uint32_t>(index) * 2654435761u) >> 24);
+}
+
+// 伪终端对：测试端使用从端，回显线程在主端原样返回收到的字节
+class PtyEcho {
+public:
+    bool open(std::string& slave_path, std::string& error) {
+        master = ::posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+        if (master < 0 || ::grantpt(master) != 0 || ::unlockpt(master) != 0 || ::pipe2(stop_pipe, O_CLOEXEC) != 0) {
+            error = std::string("创建伪终端失败: ") + strerror(errno);
+            return false;
+        }
+        const char* name = ::ptsname(master);
+        if (!name) {
+            error = std::string("获取伪终端从端失败: ") + strerror(errno);
+            return false;
+        }
+        slave_path = name;
+        thread = std::thread([this] { echo_loop(); });
+        return true;
+    }
+
+    ~PtyEcho() {
+        if (thread.joinable()) {
+            const char stop = 1;
+            (void)!::write(stop_pipe[1], &stop, 1);
+            thread.join();
+        }
+        for (int fd : {master, stop_pipe[0], stop_pipe[1]}) {
+            if (fd >= 0) ::close(fd);
+        }
+    }
+
+private:
+    void echo_loop() {
+        char buffer[4096];
+        pollfd fds[2] = {{master, POLLIN, 0}, {stop_pipe[0], POLLIN, 0}};
+        while (::poll(fds, 2, -1) >= 0 || errno == EINTR) {
+            if (fds[1].revents) return;
+            if (!(fds[0].revents & POLLIN)) {
+                // 从端尚未打开或已关闭时主端报告 POLLHUP，稍后重试
+                if (fds[0].revents & POLLHUP) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+            const ssize_t n = ::read(master, buffer, sizeof(buffer));
+            for (ssize_t done = 0; n > 0 && done < n;) {
+                const ssize_t written = ::write(master, buffer + done, static_cast<size_t>(n - done));
+                if (written <= 0) break;
+                done += written;
+            }
+        }
+    }
+
+    int master = -1;
+    int stop_pipe[2] = {-1, -1};
+    std::thread thread;
+};
+
+std::string format_us(double us) {
+    char buffer[32];
+    if (us >= 1000) {
+        snprintf(buffer, sizeof(buffer), "%.2f ms", us / 1000);
+    } else {
+        snprintf(buffer, sizeof(buffer), "%.0f us", us);
+    }
+    return buffer;
+}
+
+} // namespace
+
+SerialTestResult SerialLoopback::run(int fd, int baud, size_t bytes, int rtt_frames, int max_ms, double min_match) {
+    SerialTestResult result;
+    result.line_bytes_per_second = baud / 10.0;
+    const int64_t deadline_ns = monotonic_ns() + static_cast<int64_t>(max_ms) * 1000000;
+    // 单字节在线路上的时间；等待回显的超时按帧长放宽，至少 50 ms
+    const double byte_ns = 1e9 / result.line_bytes_per_second;
+
+    // 往返延迟：逐帧发送并等待完整回显，测试时间的三分之一用于这一阶段
+    const int64_t rtt_deadline_ns = monotonic_ns() + static_cast<int64_t>(max_ms) * 1000000 / 3;
+    const int64_t frame_timeout_ns = std::max<int64_t>(50000000, static_cast<int64_t>(byte_ns * RTT_FRAME_BYTES * 4));
+    std::vector<double> rtts;
+    uint8_t frame[RTT_FRAME_BYTES];
+    uint8_t echo[RTT_FRAME_BYTES];
+    for (int i = 0; i < rtt_frames && monotonic_ns() < rtt_deadline_ns && !CheckContext::cancelled(); ++i) {
+        for (size_t b = 0; b < RTT_FRAME_BYTES; ++b) frame[b] = pattern_byte(i * RTT_FRAME_BYTES + b);
+        const int64_t start_ns = monotonic_ns();
+        if (::write(fd, frame, sizeof(frame)) != static_cast<ssize_t>(sizeof(frame))) {
+            result.error = std::string("写串口失败: ") + strerror(errno);
+            return result;
+        }
+        size_t got = 0;
+        while (got < sizeof(echo)) {
+            const int64_t remaining_ns = start_ns + frame_timeout_ns - monotonic_ns();
+            if (remaining_ns <= 0) break;
+            pollfd pfd{fd, POLLIN, 0};
+            if (::poll(&pfd, 1, static_cast<int>(remaining_ns / 1000000) + 1) <= 0) continue;
+            const ssize_t n = ::read(fd, echo + got, sizeof(echo) - got);
+            if (n > 0) got += static_cast<size_t>(n);
+        }
+        ++result.rtt_frames;
+        if (got == sizeof(echo) && std::memcmp(frame, echo, sizeof(frame)) == 0) {
+            rtts.push_back((monotonic_ns() - start_ns) / 1e3);
+        } else {
+            ++result.rtt_lost;
+            ::tcflush(fd, TCIFLUSH);   // 丢弃残留字节，避免错位影响后续帧
+        }
+    }
+    if (!rtts.empty()) {
+        std::sort(rtts.begin(), rtts.end());
+        result.rtt_p50_us = rtts[rtts.size() / 2];
+        result.rtt_p99_us = rtts[std::min(rtts.size() - 1, rtts.size() * 99 / 100)];
+        result.rtt_max_us = rtts.back();
+    }
+
+    // 吞吐：边发边收，未回显字节不超过 MAX_IN_FLIGHT；连续一段时间收不到数据视为回环中断
+    const int64_t idle_timeout_ns = std::max<int64_t>(100000000, static_cast<int64_t>(byte_ns * MAX_IN_FLIGHT * 2));
+    uint8_t tx[256];
+    uint8_t rx[4096];
+    const int64_t start_ns = monotonic_ns();
+    int64_t last_rx_ns = start_ns;
+    int64_t end_ns = start_ns;
+    while (result.received_bytes < bytes) {
+        const int64_t now_ns = monotonic_ns();
+        if (now_ns >= deadline_ns || now_ns - last_rx_ns >= idle_timeout_ns || CheckContext::cancelled()) break;
+
+        const bool can_send = result.sent_bytes < bytes && result.sent_bytes - result.received_bytes < MAX_IN_FLIGHT;
+        pollfd pfd{fd, static_cast<short>(POLLIN | (can_send ? POLLOUT : 0)), 0};
+        const int64_t wait_ns = std::min(deadline_ns, last_rx_ns + idle_timeout_ns) - now_ns;
+        if (::poll(&pfd, 1, static_cast<int>(wait_ns / 1000000) + 1) <= 0) continue;
+
+        if (pfd.revents & POLLIN) {
+            const ssize_t n = ::read(fd, rx, std::min(sizeof(rx), result.sent_bytes - result.received_bytes));
+            if (n > 0) {
+                for (ssize_t i = 0; i < n; ++i) {
+                    if (rx[i] == pattern_byte(result.received_bytes + static_cast<size_t>(i))) {
+                        ++result.matched_bytes;
+                    } else {
+                        ++result.error_bytes;
+                    }
+                }
+                result.received_bytes += static_cast<size_t>(n);
+                last_rx_ns = end_ns = monotonic_ns();
+            }
+        }
+        if ((pfd.revents & POLLOUT) && can_send) {
+            const size_t chunk = std::min({sizeof(tx), bytes - result.sent_bytes,
+                                           MAX_IN_FLIGHT - (result.sent_bytes - result.received_bytes)});
+            for (size_t i = 0; i < chunk; ++i) tx[i] = pattern_byte(result.sent_bytes + i);
+            const ssize_t n = ::write(fd, tx, chunk);
+            if (n < 0 && errno != EAGAIN && errno != EINTR) {
+                result.error = std::string("写串口失败: ") + strerror(errno);
+                return result;
+            }
+            if (n > 0) result.sent_bytes += static_cast<size_t>(n);
+        }
+    }
+    result.error_bytes += result.sent_bytes - result.received_bytes;
+    result.seconds = (end_ns - start_ns) / 1e9;
+    result.bytes_per_second = result.seconds > 0 ? result.received_bytes / result.seconds : 0.0;
+    if (CheckContext::cancelled()) {
+        result.error = "已取消";
+        return result;
+    }
+    // 只有内容一致的回显才算回环正常：线路噪声或对端的零星字节不能让测试通过
+    const double byte_match = result.sent_bytes > 0 ? static_cast<double>(result.matched_bytes) / result.sent_bytes : 0.0;
+    const double frame_match = result.rtt_frames > 0
+        ? static_cast<double>(result.rtt_frames - result.rtt_lost) / result.rtt_frames : 1.0;
+    result.ok = byte_match >= min_match && frame_match >= min_match;
+    if (result.matched_bytes == 0 && rtts.empty()) {
+        result.error = "未收到回环数据，请确认 TX/RX 已短接或对端处于回显模式";
+    } else if (!result.ok) {
+        char text[128];
+        snprintf(text, sizeof(text), "回显内容一致的字节 %.1f%%、帧 %.1f%%，低于要求的 %.0f%%",
+                 byte_match * 100, frame_match * 100, min_match * 100);
+        result.error = text;
+    }
+    return result;
+}
+
+SystemCheckResult SerialLoopback::check() {
+    Logger::info("执行串口回环测试");
+
+    std::unique_lock<std::mutex> running(run_mutex, std::try_to_lock);
+    if (!running.owns_lock()) {
+        return {"warning", "串口回环测试正在进行中"};
+    }
+
+    YAML::Node config = ConfigManager::get_system_config();
+    // 回环测试会向线路发送测试图案，必须显式指定设备，不默认测试与飞控通信的串口
+    const std::string device = config["serial_test_device"].as<std::string>("");
+    if (device.empty()) {
+        return {"warning", "未配置测试串口（system.serial_test_device 需指定设备或 \"pty\"）"};
+    }
+    std::string reason;
+    if (ProcessMonitor::self_test_blocked(config, "serial_test_mission_processes", reason)) {
+        return {"warning", reason + "，跳过串口回环测试"};
+    }
+    const int baud = config["serial_test_baud"].as<int>(115200);
+    const size_t bytes = static_cast<size_t>(std::clamp(config["serial_test_bytes"].as<int>(4096), 16, 1 << 20));
+    const int rtt_frames = std::clamp(config["serial_test_rtt_frames"].as<int>(50), 0, 10000);
+    const int max_ms = std::clamp(config["serial_test_max_ms"].as<int>(2000), 100, MAX_TEST_MS);
+    const double min_efficiency = config["serial_test_min_efficiency_percent"].as<double>(80.0);
+    const double min_match = std::clamp(config["serial_test_min_match_percent"].as<double>(99.0), 0.0, 100.0) / 100.0;
+
+    const bool pty = device == "pty";
+    PtyEcho echo;
+    std::string path = device;
+    std::string error;
+    if (pty && !echo.open(path, error)) {
+        return {"error", error};
+    }
+    if (!pty) {
+        const int user = SerialPort::find_user(device);
+        if (user > 0) {
+            return {"warning", device + " 正被进程 " + std::to_string(user) + " 使用，跳过回环测试"};
+        }
+    }
+
+    const int fd = ::open(path.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        return {"error", "无法打开 " + path + ": " + strerror(errno)};
+    }
+    termios original{};
+    const bool restore = ::tcgetattr(fd, &original) == 0;
+    SerialTestResult result;
+    if (SerialPort::configure(fd, baud, error)) {
+        result = run(fd, baud, bytes, rtt_frames, max_ms, min_match);
+    } else {
+        result.error = error;
+    }
+    if (restore) ::tcsetattr(fd, TCSANOW, &original);
+    ::close(fd);
+
+    nlohmann::json details = {
+        {"device", device},
+        {"path", path},
+        {"baud", baud},
+        {"rtt_frames", result.rtt_frames},
+        {"rtt_lost", result.rtt_lost},
+        {"rtt_p50_us", result.rtt_p50_us},
+        {"rtt_p99_us", result.rtt_p99_us},
+        {"rtt_max_us", result.rtt_max_us},
+        {"sent_bytes", result.sent_bytes},
+        {"received_bytes", result.received_bytes},
+        {"matched_bytes", result.matched_bytes},
+        {"error_bytes", result.error_bytes},
+        {"error_rate", result.error_rate()},
+        {"seconds", result.seconds},
+        {"bytes_per_second", result.bytes_per_second},
+        {"line_bytes_per_second", result.line_bytes_per_second}
+    };
+    if (!result.ok) {
+        details["error"] = result.error;
+        return {"error", device + " 回环测试失败: " + result.error, details.dump()};
+    }
+
+    // 伪终端不受波特率限制，不评估线路利用率
+    const double efficiency = 100.0 * result.bytes_per_second / result.line_bytes_per_second;
+    if (!pty) details["efficiency_percent"] = efficiency;
+
+    std::ostringstream message;
+    char rate[64];
+    snprintf(rate, sizeof(rate), "%.1f KB/s", result.bytes_per_second / 1024);
+    message << device << " @" << baud << ": 吞吐 " << rate;
+    if (!pty) message << " (" << static_cast<int>(efficiency) << "% 线路速率)";
+    snprintf(rate, sizeof(rate), "%.4f%%", result.error_rate() * 100);
+    message << ", 误码率 " << rate << ", 往返 " << format_us(result.rtt_p50_us) << " (p99 "
+            << format_us(result.rtt_p99_us) << ")";
+
+    std::vector<std::string> warnings;
+    if (result.error_bytes > 0) warnings.push_back(std::to_string(result.error_bytes) + " 字节错误或丢失");
+    if (result.rtt_lost > 0) warnings.push_back(std::to_string(result.rtt_lost) + " 帧未回显");
+    if (!pty && efficiency < min_efficiency) warnings.push_back("吞吐低于线路速率的 " + std::to_string(static_cast<int>(min_efficiency)) + "%");
+
+    std::string status = "success";
+    if (!warnings.empty()) {
+        status = "warning";
+        message << " [告警:";
+        for (const auto& warning : warnings) message << " " << warning << ";";
+        message << "]";
+    }
+    return {status, message.str(), details.dump()};
+}
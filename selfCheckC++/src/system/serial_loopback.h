@@ -0,0 +1,48 @@
+#ifndef SERIAL_LOOPBACK_H
+#define SERIAL_LOOPBACK_H
+
+#include "../types/common_types.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// 一次串口回环测试的结果
+struct SerialTestResult {
+    bool ok = false;
+    std::string error;
+    // 往返延迟：逐帧发送 RTT_FRAME_BYTES 字节并等待完整回显
+    size_t rtt_frames = 0;
+    size_t rtt_lost = 0;
+    double rtt_p50_us = 0.0;
+    double rtt_p99_us = 0.0;
+    double rtt_max_us = 0.0;
+    // 吞吐：连续发送测试图案并同时接收
+    size_t sent_bytes = 0;
+    size_t received_bytes = 0;
+    size_t matched_bytes = 0;         // 与发送图案一致的字节
+    size_t error_bytes = 0;           // 内容不一致或未收到的字节
+    double seconds = 0.0;
+    double bytes_per_second = 0.0;
+    double line_bytes_per_second = 0.0;   // 8N1 下的理论值 baud / 10
+
+    double error_rate() const { return sent_bytes > 0 ? static_cast<double>(error_bytes) / sent_bytes : 0.0; }
+};
+
+// 串口主动自测：按配置的波特率把串口设为 8N1 原始模式，向 TX/RX 短接的回环线
+// 或回显对端发送测试图案，用非阻塞 IO 与 poll 测量吞吐、误码率和往返延迟分布。
+// 测试会占用串口收发，只在显式请求且配置了设备时执行；串口被其他进程打开、
+// 飞控进程运行或系统降载时拒绝测试。
+// 设备配置为 "pty" 时在伪终端对上自测，主端由回显线程原样返回，无需硬件
+class SerialLoopback {
+public:
+    static constexpr size_t RTT_FRAME_BYTES = 16;
+
+    // 串口回环检测（按需执行）
+    static SystemCheckResult check();
+
+    // 在已由 SerialPort::configure 配置的非阻塞 fd 上执行测试；内容一致的回显字节与帧
+    // 都不低于 min_match（0-1）时判定通过
+    static SerialTestResult run(int fd, int baud, size_t bytes, int rtt_frames, int max_ms, double min_match);
+};
+
+#endif // SERIAL_LOOPBACK_H
@@ -0,0 +1,338 @@
+#include "serial_stream.h"
+#include "check_context.h"
+#include "../config/config_manager.h"
+#include "../utils/link_framer.h"
+#include "../utils/logger.h"
+#include "../utils/monotonic_clock.h"
+#include "../utils/serial_port.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <poll.h>
+#include <sstream>
+#include <termios.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+constexpr const char* REPLAY_PREFIX = "pty:";
+constexpr int REPLAY_TICK_MS = 10;
+// 采集时 poll 的最长等待，到期检查一次检测是否已取消
+constexpr int CAPTURE_POLL_MS = 100;
+
+// 伪终端回放：按波特率对应的速率（8N1 下 baud / 10 字节每秒）把录制文件循环写入主端，
+// 被测代码读取从端，与真实串口看到的数据流一致
+class PtyReplay {
+public:
+    bool open(const std::string& file, int baud, std::string& slave_path, std::string& error) {
+        std::ifstream input(file, std::ios::binary);
+        data.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+        if (!input.good() && !input.eof()) {
+            error = "无法读取回放文件 " + file;
+            return false;
+        }
+        if (data.empty()) {
+            error = "回放文件为空或不存在: " + file;
+            return false;
+        }
+        master = ::posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC | O_NONBLOCK);
+        if (master < 0 || ::grantpt(master) != 0 || ::unlockpt(master) != 0 || ::pipe2(stop_pipe, O_CLOEXEC) != 0) {
+            error = std::string("创建伪终端失败: ") + strerror(errno);
+            return false;
+        }
+        const char* name = ::ptsname(master);
+        if (!name) {
+            error = std::string("获取伪终端从端失败: ") + strerror(errno);
+            return false;
+        }
+        slave_path = name;
+        bytes_per_second = static_cast<uint64_t>(std::max(10, baud) / 10);
+        thread = std::thread([this] { replay_loop(); });
+        return true;
+    }
+
+    ~PtyReplay() {
+        if (thread.joinable()) {
+            const char stop = 1;
+            (void)!::write(stop_pipe[1], &stop, 1);
+            thread.join();
+        }
+        for (int fd : {master, stop_pipe[0], stop_pipe[1]}) {
+            if (fd >= 0) ::close(fd);
+        }
+    }
+
+private:
+    void replay_loop() {
+        const int64_t start_ms = monotonic_ms();
+        uint64_t written = 0;
+        size_t offset = 0;
+        pollfd stop{stop_pipe[0], POLLIN, 0};
+        for (;;) {
+            const int ready = ::poll(&stop, 1, REPLAY_TICK_MS);
+            if (ready > 0 || (ready < 0 && errno != EINTR)) return;
+            // 按已流逝时间补足应发送的字节；主端缓冲已满时留到下一节拍，数据不会被截断
+            const uint64_t due = static_cast<uint64_t>(monotonic_ms() - start_ms) * bytes_per_second / 1000;
+            while (written < due) {
+                const size_t chunk = static_cast<size_t>(std::min<uint64_t>(due - written, data.size() - offset));
+                const ssize_t n = ::write(master, data.data() + offset, chunk);
+                if (n <= 0) break;
+                written += static_cast<uint64_t>(n);
+                offset = (offset + static_cast<size_t>(n)) % data.size();
+            }
+        }
+    }
+
+    std::vector<char> data;
+    uint64_t bytes_per_second = 1;
+    int master = -1;
+    int stop_pipe[2] = {-1, -1};
+    std::thread thread;
+};
+
+struct Capture {
+    SerialStreamPort port;
+    std::string path;
+    int fd = -1;
+    termios original{};
+    bool restore = false;
+    std::string status;       // 非空表示已在采集前确定结果
+    std::string problem;
+    bool disconnected = false;   // 采集中挂断（如拔出 USB 转串口），已停止读取
+    std::unique_ptr<PtyReplay> replay;
+    LinkFramer framer;
+};
+
+std::string format_rate(double value) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), value >= 10 ? "%.0f" : "%.1f", value);
+    return buffer;
+}
+
+} // namespace
+
+std::vector<SerialStreamPort> SerialStream::configured_ports() {
+    YAML::Node config = ConfigManager::get_system_config();
+    std::vector<SerialStreamPort> ports;
+    if (config["serial_stream_ports"] && config["serial_stream_ports"].IsSequence()) {
+        for (const auto& node : config["serial_stream_ports"]) {
+            const std::string entry = node.as<std::string>();
+            SerialStreamPort port;
+            const size_t at = entry.rfind('@');
+            port.device = entry.substr(0, at);
+            if (at != std::string::npos) {
+                try {
+                    port.baud = std::stoi(entry.substr(at + 1));
+                } catch (const std::exception&) {
+                    Logger::warning("serial_stream_ports 中的波特率无效: " + entry);
+                }
+            }
+            if (!port.device.empty()) ports.push_back(port);
+        }
+    }
+    if (!config["serial_stream_ports"] || ports.empty()) {
+        // 默认嗅探与飞控通信的串口（trans_config.yaml 中的 serial_device / baud_rate）
+        try {
+            YAML::Node trans = YAML::Load(ConfigManager::get_current_config("trans"));
+            SerialStreamPort port;
+            port.device = trans["serial_device"].as<std::string>("");
+            port.baud = trans["baud_rate"].as<int>(115200);
+            if (!port.device.empty()) ports.push_back(port);
+        } catch (const std::exception&) {
+        }
+    }
+    return ports;
+}
+
+SystemCheckResult SerialStream::check() {
+    Logger::info("执行串口数据流检测");
+
+    YAML::Node config = ConfigManager::get_system_config();
+    const int window_ms = std::clamp(config["serial_stream_window_ms"].as<int>(1000), 100, 10000);
+    const double bad_warn_percent = config["serial_stream_bad_warn_percent"].as<double>(1.0);
+
+    const auto ports = configured_ports();
+    if (ports.empty()) {
+        return {"warning", "未配置需要检测的串口（system.serial_stream_ports）"};
+    }
+
+    std::vector<std::unique_ptr<Capture>> captures;
+    for (const auto& port : ports) {
+        auto capture = std::make_unique<Capture>();
+        capture->port = port;
+        capture->path = port.device;
+        if (config["serial_stream_mavlink_crc_extra"] && config["serial_stream_mavlink_crc_extra"].IsMap()) {
+            for (const auto& item : config["serial_stream_mavlink_crc_extra"]) {
+                capture->framer.set_crc_extra(item.first.as<uint32_t>(), static_cast<uint8_t>(item.second.as<int>()));
+            }
+        }
+        captures.push_back(std::move(capture));
+
+        Capture& c = *captures.back();
+        std::string error;
+        if (port.device.compare(0, std::strlen(REPLAY_PREFIX), REPLAY_PREFIX) == 0) {
+            c.replay = std::make_unique<PtyReplay>();
+            if (!c.replay->open(port.device.substr(std::strlen(REPLAY_PREFIX)), port.baud, c.path, error)) {
+                c.status = "error";
+                c.problem = error;
+                continue;
+            }
+        } else {
+            const int user = SerialPort::find_user(port.device);
+            if (user > 0) {
+                c.status = "warning";
+                c.problem = "正被进程 " + std::to_string(user) + " 使用，未采集";
+                continue;
+            }
+        }
+        c.fd = ::open(c.path.c_str(), O_RDONLY | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+        if (c.fd < 0) {
+            c.status = "error";
+            c.problem = std::string("无法打开: ") + strerror(errno);
+            continue;
+        }
+        c.restore = ::tcgetattr(c.fd, &c.original) == 0;
+        if (!SerialPort::configure(c.fd, port.baud, error)) {
+            c.status = "error";
+            c.problem = error;
+        }
+    }
+
+    // 所有串口在同一时间窗内并行读取，read 直接写入分帧器的环形缓冲区
+    std::vector<pollfd> fds;
+    std::vector<Capture*> active;
+    for (auto& capture : captures) {
+        if (capture->status.empty()) {
+            fds.push_back({capture->fd, POLLIN, 0});
+            active.push_back(capture.get());
+        }
+    }
+    const int64_t start_ms = monotonic_ms();
+    const int64_t deadline_ms = start_ms + window_ms;
+    for (int64_t now = start_ms; !fds.empty() && now < deadline_ms && !CheckContext::cancelled();
+         now = monotonic_ms()) {
+        const int timeout = static_cast<int>(std::min<int64_t>(deadline_ms - now, CAPTURE_POLL_MS));
+        if (::poll(fds.data(), fds.size(), timeout) <= 0) continue;
+        for (size_t i = 0; i < fds.size();) {
+            const short revents = fds[i].revents;
+            bool gone = (revents & (POLLHUP | POLLERR | POLLNVAL)) != 0;
+            if (revents & POLLIN) {
+                LinkFramer& framer = active[i]->framer;
+                for (;;) {
+                    size_t length = 0;
+                    uint8_t* span = framer.write_span(length);
+                    const ssize_t n = ::read(fds[i].fd, span, length);
+                    // VMIN=0 时读空返回 0；挂断的伪终端等返回 EIO
+                    if (n < 0 && errno != EAGAIN && errno != EINTR) gone = true;
+                    if (n <= 0) break;
+                    framer.commit(static_cast<size_t>(n));
+                    if (static_cast<size_t>(n) < length) break;
+                }
+            }
+            if (gone) {
+                // 不再轮询挂断的 fd，否则 poll 立即返回，在剩余时间窗内空转
+                active[i]->disconnected = true;
+                fds.erase(fds.begin() + static_cast<std::ptrdiff_t>(i));
+                active.erase(active.begin() + static_cast<std::ptrdiff_t>(i));
+                continue;
+            }
+            ++i;
+        }
+    }
+    const double seconds = std::max(0.001, (monotonic_ms() - start_ms) / 1000.0);
+
+    std::string status = "success";
+    std::ostringstream message;
+    nlohmann::json list = nlohmann::json::array();
+    for (auto& capture : captures) {
+        Capture& c = *capture;
+        if (c.fd >= 0) {
+            if (c.restore) ::tcsetattr(c.fd, TCSANOW, &c.original);
+            ::close(c.fd);
+        }
+        const LinkStats& stats = c.framer.stats();
+        nlohmann::json entry = {{"device", c.port.device}, {"path", c.path}, {"baud", c.port.baud}};
+        if (!message.str().empty()) message << "; ";
+        message << c.port.device;
+
+        if (c.status.empty()) {
+            const uint64_t nmea_frames = stats.nmea_ok + stats.nmea_unchecked;
+            const uint64_t mavlink_frames = stats.mavlink_ok + stats.mavlink_unchecked;
+            const uint64_t bad = stats.nmea_bad + stats.mavlink_bad;
+            const uint64_t checked = stats.nmea_ok + stats.mavlink_ok + bad;
+            const double bad_percent = checked > 0 ? 100.0 * bad / checked : 0.0;
+            const double loss_percent = stats.mavlink_ok > 0
+                ? 100.0 * stats.mavlink_lost / (stats.mavlink_ok + stats.mavlink_lost) : 0.0;
+
+            nlohmann::json types = nlohmann::json::array();
+            std::vector<std::pair<double, std::string>> ranked;
+            for (const auto& [key, count] : stats.nmea_types) {
+                const std::string name = LinkFramer::nmea_name(key);
+                types.push_back({{"protocol", "nmea"}, {"type", name}, {"count", count}, {"rate_hz", count / seconds}});
+                ranked.push_back({count / seconds, name});
+            }
+            for (const auto& [id, count] : stats.mavlink_types) {
+                const char* known = LinkFramer::mavlink_name(id);
+                const std::string name = known ? known : "#" + std::to_string(id);
+                types.push_back({{"protocol", "mavlink"}, {"type", name}, {"id", id}, {"count", count},
+                                 {"rate_hz", count / seconds}});
+                ranked.push_back({count / seconds, name});
+            }
+            std::sort(ranked.begin(), ranked.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+            entry["bytes"] = stats.bytes;
+            entry["bytes_per_second"] = stats.bytes / seconds;
+            entry["skipped_bytes"] = stats.skipped_bytes;
+            entry["nmea"] = {{"ok", stats.nmea_ok}, {"bad", stats.nmea_bad}, {"unchecked", stats.nmea_unchecked},
+                             {"rate_hz", nmea_frames / seconds}};
+            entry["mavlink"] = {{"ok", stats.mavlink_ok}, {"bad", stats.mavlink_bad},
+                                {"unchecked", stats.mavlink_unchecked}, {"v1", stats.mavlink_v1},
+                                {"v2", stats.mavlink_v2}, {"lost", stats.mavlink_lost},
+                                {"loss_percent", loss_percent}, {"rate_hz", mavlink_frames / seconds}};
+            entry["bad_percent"] = bad_percent;
+            entry["types"] = types;
+
+            if (c.disconnected) {
+                c.status = "error";
+                c.problem = "设备断开";
+            } else if (stats.bytes == 0) {
+                c.status = "error";
+                c.problem = "时间窗内没有收到数据";
+            } else if (nmea_frames + mavlink_frames == 0) {
+                c.status = "error";
+                c.problem = "收到 " + std::to_string(stats.bytes) + " 字节但未识别出 NMEA/MAVLink 帧（波特率不匹配？）";
+            } else {
+                c.status = bad_percent > bad_warn_percent || loss_percent > bad_warn_percent ? "warning" : "success";
+                if (mavlink_frames > 0) message << " MAVLink " << format_rate(mavlink_frames / seconds) << " 包/s";
+                if (nmea_frames > 0) message << " NMEA " << format_rate(nmea_frames / seconds) << " 条/s";
+                message << " (";
+                for (size_t i = 0; i < std::min<size_t>(3, ranked.size()); ++i) {
+                    message << (i ? ", " : "") << ranked[i].second << " " << format_rate(ranked[i].first) << " Hz";
+                }
+                message << "), 校验失败 " << format_rate(bad_percent) << "%";
+                if (stats.mavlink_ok > 0) message << ", 丢包 " << format_rate(loss_percent) << "%";
+            }
+        }
+        if (!c.problem.empty()) {
+            message << " " << c.problem;
+            entry["problem"] = c.problem;
+        }
+        entry["status"] = c.status;
+        list.push_back(std::move(entry));
+        if (c.status == "error") {
+            status = "error";
+        } else if (c.status == "warning" && status == "success") {
+            status = "warning";
+        }
+    }
+
+    nlohmann::json details = {{"window_seconds", seconds}, {"ports", list}};
+    return {status, message.str(), details.dump()};
+}
@@ -0,0 +1,27 @@
+#ifndef SERIAL_STREAM_H
+#define SERIAL_STREAM_H
+
+#include "../types/common_types.h"
+#include <string>
+#include <vector>
+
+// 待嗅探的串口
+struct SerialStreamPort {
+    std::string device;   // 设备路径；"pty:<文件>" 表示在伪终端上回放录制的数据
+    int baud = 115200;
+};
+
+// GPS/飞控串口数据流检测：在一个有界时间窗内被动读取串口，以零拷贝环形缓冲区
+// 增量分帧 NMEA 语句与 MAVLink v1/v2 报文并校验，统计每秒消息数、各消息类型的频率、
+// 校验失败率与 MAVLink 序号丢包。多个串口在同一个 poll 循环内并行采集。
+// 串口被其他进程（如数据链路进程）打开时不读取，以免抢走对方的数据
+class SerialStream {
+public:
+    // 串口数据流检测（按需执行）
+    static SystemCheckResult check();
+
+    // 解析 system.serial_stream_ports（"设备[@波特率]"），未配置时使用 trans_config.yaml 中的飞控串口
+    static std::vector<SerialStreamPort> configured_ports();
+};
+
+#endif // SERIAL_STREAM_H
@@ -0,0 +1,443 @@
+#include "storage_monitor.h"
+#include "check_context.h"
+#include "load_shedder.h"
+#include "metric_sampler.h"
+#include "../config/config_manager.h"
+#include "../utils/logger.h"
+#include "../utils/monotonic_clock.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <random>
+#include <sstream>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#include <sys/sysmacros.h>
+#include <unistd.h>
+#include <vector>
+
+// 静态成员初始化
+std::mutex StorageMonitor::mutex;
+std::mutex StorageMonitor::probe_mutex;
+std::string StorageMonitor::directory;
+std::string StorageMonitor::device;
+SysfsReader StorageMonitor::diskstats;
+proc::DiskStats StorageMonitor::last_stats;
+int64_t StorageMonitor::last_sample_ns = 0;
+bool StorageMonitor::has_previous = false;
+StorageMonitor::Rates StorageMonitor::rates;
+double StorageMonitor::free_warn_percent = 10.0;
+double StorageMonitor::free_error_percent = 3.0;
+double StorageMonitor::util_warn_percent = 90.0;
+double StorageMonitor::await_warn_ms = 100.0;
+int StorageMonitor::probe_mb = 64;
+int StorageMonitor::probe_max_ms = 3000;
+double StorageMonitor::required_write_mbps = 20.0;
+
+namespace {
+
+constexpr double SECTOR_BYTES = 512.0;
+constexpr size_t SEQUENTIAL_BLOCK = 1 << 20;
+constexpr size_t RANDOM_BLOCK = 4096;
+constexpr size_t BUFFER_ALIGN = 4096;   // O_DIRECT 要求缓冲区、偏移与长度按逻辑块对齐
+
+// 设备较多（大量 loop/分区）时 /proc/diskstats 可达数 KB；放在静态区避免占用采样线程栈
+proc::FileBuffer<32768> diskstats_buffer;
+
+// 目录尚未创建时向上回退到最近的已存在目录，它与将来创建的目录位于同一文件系统
+std::string existing_ancestor(std::string path) {
+    while (!path.empty()) {
+        struct stat st{};
+        if (::stat(path.c_str(), &st) == 0) return path;
+        while (!path.empty() && path.back() == '/') path.pop_back();
+        const size_t slash = path.rfind('/');
+        if (slash == std::string::npos) return ".";
+        path = slash == 0 ? "/" : path.substr(0, slash);
+    }
+    return ".";
+}
+
+struct SpaceInfo {
+    bool valid = false;
+    uint64_t total_bytes = 0;
+    uint64_t free_bytes = 0;    // 非特权进程可用的空间（f_bavail）
+    double free_percent = 0.0;
+};
+
+SpaceInfo query_space(const std::string& path) {
+    SpaceInfo info;
+    struct statvfs vfs{};
+    if (::statvfs(path.c_str(), &vfs) != 0 || vfs.f_blocks == 0) return info;
+    info.valid = true;
+    info.total_bytes = static_cast<uint64_t>(vfs.f_blocks) * vfs.f_frsize;
+    info.free_bytes = static_cast<uint64_t>(vfs.f_bavail) * vfs.f_frsize;
+    info.free_percent = 100.0 * static_cast<double>(vfs.f_bavail) / static_cast<double>(vfs.f_blocks);
+    return info;
+}
+
+std::string format_bytes(uint64_t bytes) {
+    char buffer[32];
+    if (bytes >= (1ULL << 30)) {
+        snprintf(buffer, sizeof(buffer), "%.1f GB", bytes / 1073741824.0);
+    } else {
+        snprintf(buffer, sizeof(buffer), "%.0f MB", bytes / 1048576.0);
+    }
+    return buffer;
+}
+
+std::string format_double(double value, int precision = 1) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.*f", precision, value);
+    return buffer;
+}
+
+// 探测用的临时文件：优先 O_TMPFILE（不出现在目录中，进程异常退出也不会残留），
+// 文件系统不支持时创建具名文件并立即删除
+int open_probe_file(const std::string& dir, bool direct) {
+    const int flags = O_RDWR | O_CLOEXEC | (direct ? O_DIRECT : 0);
+    int fd = ::open(dir.c_str(), flags | O_TMPFILE, 0600);
+    if (fd >= 0 || (errno != EOPNOTSUPP && errno != EISDIR && errno != ENOENT)) return fd;
+
+    std::string name = dir + "/.storage_probe_XXXXXX";
+    std::vector<char> path(name.begin(), name.end());
+    path.push_back('\0');
+    fd = ::mkostemp(path.data(), O_CLOEXEC);
+    if (fd < 0) return -1;
+    ::unlink(path.data());
+    if (direct) {
+        const int current = ::fcntl(fd, F_GETFL);
+        if (current < 0 || ::fcntl(fd, F_SETFL, current | O_DIRECT) != 0) {
+            const int saved = errno;
+            ::close(fd);
+            errno = saved;
+            return -1;
+        }
+    }
+    return fd;
+}
+
+struct PhaseResult {
+    uint64_t bytes = 0;
+    uint64_t ops = 0;
+    double seconds = 0.0;
+    bool truncated = false;    // 因时长预算提前结束
+
+    double mbps() const { return seconds > 0 ? bytes / 1048576.0 / seconds : 0.0; }
+    double iops() const { return seconds > 0 ? ops / seconds : 0.0; }
+
+    nlohmann::json to_json() const {
+        return {{"bytes", bytes}, {"ops", ops}, {"seconds", seconds},
+                {"mbps", mbps()}, {"iops", iops()}, {"truncated", truncated}};
+    }
+};
+
+// 完整写入/读取一个块；O_DIRECT 下短读写只会发生在出错时
+bool transfer_block(int fd, char* buffer, size_t size, off_t offset, bool write) {
+    size_t done = 0;
+    while (done < size) {
+        ssize_t n = write ? ::pwrite(fd, buffer + done, size - done, offset + static_cast<off_t>(done))
+                          : ::pread(fd, buffer + done, size - done, offset + static_cast<off_t>(done));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        done += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// 依次处理 count 个块，到达截止时间或检测被取消即停止；写阶段以 fdatasync 结束，耗时计入结果
+bool run_phase(int fd, char* buffer, size_t block, uint64_t count, uint64_t span_blocks,
+               bool write, bool random, int64_t deadline_ns, bool buffered, PhaseResult& result) {
+    std::minstd_rand rng(0x5eed);
+    const int64_t start_ns = monotonic_ns();
+    for (uint64_t i = 0; i < count; ++i) {
+        if (monotonic_ns() >= deadline_ns || CheckContext::cancelled()) {
+            result.truncated = true;
+            break;
+        }
+        const uint64_t index = random ? rng() % span_blocks : i;
+        if (!transfer_block(fd, buffer, block, static_cast<off_t>(index * block), write)) return false;
+        result.bytes += block;
+        ++result.ops;
+    }
+    if (write && ::fdatasync(fd) != 0) return false;
+    result.seconds = (monotonic_ns() - start_ns) / 1e9;
+    // 无法使用 O_DIRECT 时，写完后丢弃页缓存，使后续读取落到设备上
+    if (write && buffered) ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    return true;
+}
+
+} // namespace
+
+std::string StorageMonitor::resolve_device(const std::string& path) {
+    struct stat st{};
+    if (::stat(path.c_str(), &st) != 0) return "";
+    // 主设备号为 0 的是 tmpfs/overlayfs 等匿名设备，没有对应的 diskstats 行
+    if (major(st.st_dev) == 0) return "";
+
+    // /sys/dev/block/M:m 链接到 /sys/devices/.../block/mmcblk0/mmcblk0p6，末级目录名即设备名
+    const std::string link = "/sys/dev/block/" + std::to_string(major(st.st_dev)) + ":" +
+                             std::to_string(minor(st.st_dev));
+    char resolved[PATH_MAX];
+    if (::realpath(link.c_str(), resolved) == nullptr) return "";
+    std::string name(resolved);
+    const size_t slash = name.rfind('/');
+    return slash == std::string::npos ? name : name.substr(slash + 1);
+}
+
+void StorageMonitor::initialize() {
+    YAML::Node config = ConfigManager::get_system_config();
+    free_warn_percent = config["storage_free_warn_percent"].as<double>(10.0);
+    free_error_percent = config["storage_free_error_percent"].as<double>(3.0);
+    util_warn_percent = config["storage_util_warn_percent"].as<double>(90.0);
+    await_warn_ms = config["storage_await_warn_ms"].as<double>(100.0);
+    probe_mb = std::clamp(config["storage_probe_mb"].as<int>(64), 1, 1024);
+    // storage_probe 的检测超时为 10 s，读写之外还要留出 fdatasync 与删除探测文件的时间
+    probe_max_ms = std::clamp(config["storage_probe_max_ms"].as<int>(3000), 100, 8000);
+    required_write_mbps = config["storage_required_write_mbps"].as<double>(20.0);
+    const int sample_hz = std::clamp(config["storage_sample_hz"].as<int>(1), 1, 10);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        directory = existing_ancestor(ConfigManager::get_image_directory());
+        device = resolve_device(directory);
+        if (device.empty()) {
+            Logger::warning("图片目录 " + directory + " 不在块设备上，仅报告剩余空间");
+            return;
+        }
+        if (!diskstats.open({"/proc/diskstats"})) {
+            Logger::warning("无法打开 /proc/diskstats，存储吞吐监控不可用");
+            device.clear();
+            return;
+        }
+        Logger::info("图片目录 " + directory + " 位于块设备 " + device);
+    }
+    MetricSampler::register_task("storage", std::chrono::milliseconds(1000 / sample_hz), &StorageMonitor::sample);
+}
+
+void StorageMonitor::sample() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (device.empty() || !diskstats_buffer.load(diskstats)) return;
+
+    proc::DiskStats stats;
+    if (!proc::find_diskstats(diskstats_buffer.view(), device, stats)) return;
+    const int64_t now_ns = monotonic_ns();
+
+    if (has_previous && now_ns > last_sample_ns) {
+        // 内核计数为 unsigned long，按无符号差分即可处理回绕
+        const double elapsed_s = (now_ns - last_sample_ns) / 1e9;
+        const uint64_t reads = stats.reads - last_stats.reads;
+        const uint64_t writes = stats.writes - last_stats.writes;
+
+        rates.window_s = elapsed_s;
+        rates.read_mbps = (stats.sectors_read - last_stats.sectors_read) * SECTOR_BYTES / 1048576.0 / elapsed_s;
+        rates.write_mbps = (stats.sectors_written - last_stats.sectors_written) * SECTOR_BYTES / 1048576.0 / elapsed_s;
+        rates.read_iops = reads / elapsed_s;
+        rates.write_iops = writes / elapsed_s;
+        rates.read_await_ms = reads > 0 ? static_cast<double>(stats.read_ms - last_stats.read_ms) / reads : 0.0;
+        rates.write_await_ms = writes > 0 ? static_cast<double>(stats.write_ms - last_stats.write_ms) / writes : 0.0;
+        rates.util_percent = std::min(100.0, (stats.io_ms - last_stats.io_ms) / (elapsed_s * 10.0));
+        rates.in_flight = stats.in_flight;
+
+        MetricSampler::record("storage.read_mbps", rates.read_mbps);
+        MetricSampler::record("storage.write_mbps", rates.write_mbps);
+        MetricSampler::record("storage.iops", rates.read_iops + rates.write_iops);
+        MetricSampler::record("storage.util_percent", rates.util_percent);
+    }
+    last_stats = stats;
+    last_sample_ns = now_ns;
+    has_previous = true;
+}
+
+SystemCheckResult StorageMonitor::check() {
+    Logger::info("执行存储检测");
+
+    std::string dir;
+    bool ready;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        dir = directory.empty() ? existing_ancestor(ConfigManager::get_image_directory()) : directory;
+        ready = device.empty() || rates.window_s > 0;
+    }
+    if (!ready) MetricSampler::warm_up(&StorageMonitor::sample);
+
+    const SpaceInfo space = query_space(dir);
+    if (!space.valid) {
+        return {"error", "无法获取 " + dir + " 的文件系统信息: " + std::string(strerror(errno))};
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::string status = "success";
+    std::vector<std::string> warnings;
+    if (space.free_percent < free_error_percent) {
+        status = "error";
+        warnings.push_back("剩余空间不足 " + format_double(free_error_percent, 0) + "%");
+    } else if (space.free_percent < free_warn_percent) {
+        status = "warning";
+        warnings.push_back("剩余空间低于 " + format_double(free_warn_percent, 0) + "%");
+    }
+
+    std::ostringstream message;
+    message << "图片目录 " << dir << ": 剩余 " << format_bytes(space.free_bytes) << " / "
+            << format_bytes(space.total_bytes) << " (" << format_double(space.free_percent) << "%)";
+
+    nlohmann::json details = {
+        {"directory", dir},
+        {"total_bytes", space.total_bytes},
+        {"free_bytes", space.free_bytes},
+        {"free_percent", space.free_percent}
+    };
+
+    if (!device.empty() && rates.window_s > 0) {
+        if (rates.util_percent >= util_warn_percent) {
+            warnings.push_back("设备利用率 " + format_double(rates.util_percent, 0) + "%");
+        }
+        if (rates.write_await_ms >= await_warn_ms) {
+            warnings.push_back("写延迟 " + format_double(rates.write_await_ms) + " ms");
+        }
+        if (status == "success" && !warnings.empty()) status = "warning";
+
+        message << "; " << device << ": 读 " << format_double(rates.read_mbps) << " MB/s, 写 "
+                << format_double(rates.write_mbps) << " MB/s, "
+                << format_double(rates.read_iops + rates.write_iops, 0) << " IOPS, 写延迟 "
+                << format_double(rates.write_await_ms) << " ms, 利用率 "
+                << format_double(rates.util_percent, 0) << "%";
+        details["device"] = device;
+        details["window_s"] = rates.window_s;
+        details["read_mbps"] = rates.read_mbps;
+        details["write_mbps"] = rates.write_mbps;
+        details["read_iops"] = rates.read_iops;
+        details["write_iops"] = rates.write_iops;
+        details["read_await_ms"] = rates.read_await_ms;
+        details["write_await_ms"] = rates.write_await_ms;
+        details["util_percent"] = rates.util_percent;
+        details["in_flight"] = rates.in_flight;
+    } else if (device.empty()) {
+        message << "; 不在块设备上，无吞吐数据";
+    }
+
+    if (!warnings.empty()) {
+        message << " [告警:";
+        for (const auto& warning : warnings) message << " " << warning;
+        message << "]";
+    }
+    return {status, message.str(), details.dump()};
+}
+
+SystemCheckResult StorageMonitor::probe() {
+    Logger::info("执行存储读写探测");
+
+    std::unique_lock<std::mutex> guard(probe_mutex, std::try_to_lock);
+    if (!guard.owns_lock()) {
+        return {"warning", "已有存储探测正在执行"};
+    }
+    // 探测会占满设备带宽，飞控侧有压力时不与 VO/图像采集争抢 IO
+    if (LoadShedder::shedding()) {
+        return {"warning", "系统处于降载状态，跳过存储探测"};
+    }
+
+    std::string dir;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        dir = directory.empty() ? existing_ancestor(ConfigManager::get_image_directory()) : directory;
+    }
+    const uint64_t probe_bytes = static_cast<uint64_t>(probe_mb) << 20;
+    const SpaceInfo space = query_space(dir);
+    if (!space.valid) {
+        return {"error", "无法获取 " + dir + " 的文件系统信息: " + std::string(strerror(errno))};
+    }
+    // 探测后剩余空间仍需高于告警线，避免为测速挤占图片存储
+    const double free_after = 100.0 * (static_cast<double>(space.free_bytes) - static_cast<double>(probe_bytes)) /
+                              static_cast<double>(space.total_bytes);
+    if (free_after < free_warn_percent) {
+        return {"warning", "剩余空间不足，跳过存储探测 (剩余 " + format_bytes(space.free_bytes) + ")"};
+    }
+
+    bool direct = true;
+    int fd = open_probe_file(dir, true);
+    if (fd < 0 && errno == EINVAL) {
+        // 部分文件系统（如 tmpfs、早期 overlayfs）不支持 O_DIRECT，退回缓冲 IO + fdatasync
+        direct = false;
+        fd = open_probe_file(dir, false);
+    }
+    if (fd < 0) {
+        return {"error", "无法在 " + dir + " 创建探测文件: " + std::string(strerror(errno))};
+    }
+
+    void* memory = nullptr;
+    if (posix_memalign(&memory, BUFFER_ALIGN, SEQUENTIAL_BLOCK) != 0) {
+        ::close(fd);
+        return {"error", "分配探测缓冲区失败"};
+    }
+    std::unique_ptr<char, decltype(&std::free)> buffer(static_cast<char*>(memory), &std::free);
+    // 填充非零的伪随机数据，避免被支持压缩/去重的控制器加速
+    std::minstd_rand fill(42);
+    for (size_t i = 0; i < SEQUENTIAL_BLOCK; i += sizeof(uint32_t)) {
+        const uint32_t value = static_cast<uint32_t>(fill());
+        std::memcpy(buffer.get() + i, &value, sizeof(value));
+    }
+
+    // 时长预算按 4:2:2:2 分给四个阶段；随机阶段只在顺序写入的范围内寻址
+    const int64_t start_ns = monotonic_ns();
+    const int64_t budget_ns = static_cast<int64_t>(probe_max_ms) * 1000000;
+    const uint64_t sequential_blocks = probe_bytes / SEQUENTIAL_BLOCK;
+    PhaseResult sequential_write;
+    PhaseResult sequential_read;
+    PhaseResult random_write;
+    PhaseResult random_read;
+    bool ok = run_phase(fd, buffer.get(), SEQUENTIAL_BLOCK, sequential_blocks, sequential_blocks,
+                        true, false, start_ns + budget_ns * 4 / 10, !direct, sequential_write);
+
+    const uint64_t written_blocks = sequential_write.bytes / SEQUENTIAL_BLOCK;
+    const uint64_t random_span = sequential_write.bytes / RANDOM_BLOCK;
+    const uint64_t random_ops = probe_bytes / RANDOM_BLOCK;
+    if (ok && written_blocks > 0) {
+        ok = run_phase(fd, buffer.get(), SEQUENTIAL_BLOCK, written_blocks, written_blocks,
+                       false, false, monotonic_ns() + budget_ns * 2 / 10, !direct, sequential_read) &&
+             run_phase(fd, buffer.get(), RANDOM_BLOCK, random_ops, random_span,
+                       true, true, monotonic_ns() + budget_ns * 2 / 10, !direct, random_write) &&
+             run_phase(fd, buffer.get(), RANDOM_BLOCK, random_ops, random_span,
+                       false, true, monotonic_ns() + budget_ns * 2 / 10, !direct, random_read);
+    }
+    const int saved_errno = errno;
+    ::close(fd);
+    const double total_s = (monotonic_ns() - start_ns) / 1e9;
+
+    if (!ok) {
+        return {"error", "存储探测读写失败: " + std::string(strerror(saved_errno))};
+    }
+
+    std::ostringstream message;
+    message << (direct ? "O_DIRECT" : "缓冲 IO") << " 探测 " << dir << ": 顺序写 "
+            << format_double(sequential_write.mbps()) << " MB/s, 顺序读 " << format_double(sequential_read.mbps())
+            << " MB/s, 随机写 " << format_double(random_write.iops(), 0) << " IOPS, 随机读 "
+            << format_double(random_read.iops(), 0) << " IOPS (" << format_double(total_s, 2) << " s)";
+
+    std::string status = "success";
+    if (sequential_write.mbps() < required_write_mbps) {
+        status = "warning";
+        message << " [告警: 顺序写低于采集所需的 " << format_double(required_write_mbps, 0) << " MB/s]";
+    }
+
+    nlohmann::json details = {
+        {"directory", dir},
+        {"direct_io", direct},
+        {"probe_bytes", probe_bytes},
+        {"duration_s", total_s},
+        {"required_write_mbps", required_write_mbps},
+        {"sequential_write", sequential_write.to_json()},
+        {"sequential_read", sequential_read.to_json()},
+        {"random_write", random_write.to_json()},
+        {"random_read", random_read.to_json()}
+    };
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!device.empty()) details["device"] = device;
+    }
+    return {status, message.str(), details.dump()};
+}
@@ -0,0 +1,63 @@
+#ifndef STORAGE_MONITOR_H
+#define STORAGE_MONITOR_H
+
+#include "../types/common_types.h"
+#include "../utils/proc_parser.h"
+#include "../utils/sysfs_reader.h"
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+// 存储监控：定位图片目录（system.image_directory）所在的块设备，按 1 Hz 对
+// /proc/diskstats 做差分得到吞吐、IOPS、平均延迟与利用率，并报告 statvfs 剩余空间。
+// 另提供按需执行的读写探测：以 O_DIRECT 绕过页缓存，在有限的数据量与时长内测量
+// 顺序/随机读写性能，反映采集链路可依赖的持续写入带宽
+class StorageMonitor {
+public:
+    // 解析图片目录所在的块设备并注册后台采样任务
+    static void initialize();
+
+    // 采样一次 /proc/diskstats 并计算速率，供采样线程调用
+    static void sample();
+
+    // 存储检测：剩余空间、吞吐、IOPS、延迟与利用率
+    static SystemCheckResult check();
+
+    // 读写探测（按需执行）：顺序 1 MiB 写/读与随机 4 KiB 写/读
+    static SystemCheckResult probe();
+
+private:
+    struct Rates {
+        double read_mbps = 0.0;
+        double write_mbps = 0.0;
+        double read_iops = 0.0;
+        double write_iops = 0.0;
+        double read_await_ms = 0.0;    // 窗口内每次读请求的平均耗时（含排队）
+        double write_await_ms = 0.0;
+        double util_percent = 0.0;     // 设备有请求在处理的时间占比
+        uint64_t in_flight = 0;
+        double window_s = 0.0;
+    };
+
+    static std::string resolve_device(const std::string& path);
+
+    static std::mutex mutex;
+    static std::mutex probe_mutex;     // 同一时间只允许一个探测
+    static std::string directory;
+    static std::string device;         // 块设备名，如 "mmcblk0p6"；非块设备上的文件系统为空
+    static SysfsReader diskstats;
+    static proc::DiskStats last_stats;
+    static int64_t last_sample_ns;
+    static bool has_previous;
+    static Rates rates;
+
+    static double free_warn_percent;
+    static double free_error_percent;
+    static double util_warn_percent;
+    static double await_warn_ms;
+    static int probe_mb;
+    static int probe_max_ms;
+    static double required_write_mbps;
+};
+
+#endif // STORAGE_MONITOR_H
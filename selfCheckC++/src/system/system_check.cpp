@@ -1,5 +1,25 @@
 #include "system_check.h"
+#include "check_context.h"
+#include "can_monitor.h"
+#include "cpu_monitor.h"
+#include "gpu_monitor.h"
+#include "endpoint_probe.h"
+#include "interrupt_monitor.h"
+#include "kernel_log_monitor.h"
+#include "latency_test.h"
+#include "hardware_test.h"
+#include "usb_topology.h"
+#include "model_verifier.h"
+#include "serial_loopback.h"
+#include "serial_stream.h"
+#include "network_monitor.h"
+#include "storage_monitor.h"
+#include "load_shedder.h"
+#include "memory_monitor.h"
+#include "process_monitor.h"
+#include "thermal_monitor.h"
 #include "../utils/logger.h"  // 包含Logger头文件
+#include "../utils/proc_parser.h"
 #include <fstream>
 #include <filesystem>
 #include <cctype>
@@ -17,6 +37,7 @@
 #include <cstring>    // 添加 strlen 函数声明
 #include <vector>
 #include <thread>     // 添加 thread 头文件
+#include <nlohmann/json.hpp>
 
 namespace fs = std::filesystem;
 
@@ -30,7 +51,8 @@ const std::vector<std::string> SystemCheck::GPU_TEMP_PATHS = {
 const std::vector<std::string> SystemCheck::GPU_FREQ_PATHS = {
     "/sys/devices/platform/fb000000.gpu/devfreq/fb000000.gpu/cur_freq",
     "/sys/class/devfreq/fb000000.gpu/cur_freq",
-    "/sys/class/misc/mali0/device/devfreq/cur_freq"
+    "/sys/class/misc/mali0/device/devfreq/cur_freq",
+    "/sys/class/devfreq/ff9a0000.gpu/cur_freq"  // 旧版内核路径
 };
 
 // RK3588 串口设备路径
@@ -40,97 +62,90 @@ const std::vector<std::string> SystemCheck::SERIAL_PORTS = {
     "/dev/ttyS6", "/dev/ttyS7", "/dev/ttyS8"
 };
 
+namespace {
+
+// thermal sysfs 的温度单位固定为毫摄氏度
+int to_celsius(long raw) {
+    return static_cast<int>(raw / 1000);
+}
+
+} // namespace
+
+void SystemCheck::initialize() {
+    const SysfsReader& freq = gpu_freq_reader();
+    const SysfsReader& temp = gpu_temp_reader();
+    Logger::info("GPU频率节点: " + (freq.is_open() ? freq.path() : std::string("未找到")));
+    Logger::info("GPU温度节点: " + (temp.is_open() ? temp.path() : std::string("未找到")));
+}
+
+const SysfsReader& SystemCheck::gpu_freq_reader() {
+    static const SysfsReader reader(GPU_FREQ_PATHS);
+    return reader;
+}
+
+const SysfsReader& SystemCheck::gpu_temp_reader() {
+    static const SysfsReader reader(GPU_TEMP_PATHS);
+    return reader;
+}
+
 int SystemCheck::get_gpu_temperature() {
-    for (const auto& temp_path : GPU_TEMP_PATHS) {
-        try {
-            if (fs::exists(temp_path)) {
-                std::ifstream temp_file(temp_path);
-                if (temp_file.is_open()) {
-                    int temp_value;
-                    temp_file >> temp_value;
-                    temp_file.close();
-                    
-                    // RK3588温度传感器输出为毫摄氏度
-                    if (temp_value > 10000) {
-                        return temp_value / 1000; // 转换为摄氏度
-                    }
-                    return temp_value; // 已经是摄氏度
-                }
-            }
-        } catch (...) {
-            // 忽略错误继续尝试
-        }
+    // 优先使用类型为 gpu-thermal 的热区
+    long temp_mc = 0;
+    if (ThermalMonitor::find_temperature("gpu", temp_mc)) {
+        return static_cast<int>(temp_mc / 1000);
+    }
+
+    long raw = 0;
+    if (gpu_temp_reader().read_long(raw)) {
+        return to_celsius(raw);
     }
     
-    // 尝试通过命令行获取温度
-    FILE* pipe = popen("cat /sys/class/thermal/thermal_zone*/temp | sort -nr | head -1", "r");
-    if (pipe) {
-        char buffer[16];
-        if (fgets(buffer, sizeof(buffer), pipe)) {
-            int max_temp = atoi(buffer);
-            if (max_temp > 10000) return max_temp / 1000;
-            if (max_temp > 100) return max_temp;
-            return max_temp / 100;
-        }
-        pclose(pipe);
+    // 备用方案：取所有热区中的最高温度
+    if (ThermalMonitor::max_temperature(temp_mc)) {
+        return static_cast<int>(temp_mc / 1000);
     }
     
     return -1; // 表示无法获取温度
 }
 
+SystemCheckResult SystemCheck::check_gpu_devfreq() {
+    const SysfsReader& reader = gpu_freq_reader();
+    if (reader.is_open()) {
+        return {"success", "GPU devfreq 节点: " + reader.path()};
+    }
+    GpuSnapshot dvfs = GpuMonitor::get_snapshot();
+    if (dvfs.available) {
+        return {"success", "GPU devfreq 节点: " + dvfs.devfreq_path};
+    }
+    return {"error", "未找到GPU devfreq节点，GPU驱动可能未加载"};
+}
+
 SystemCheckResult SystemCheck::check_gpu_frequency() {
     Logger::info("执行 RK3588 GPU频率检测");
     
+    const SysfsReader& reader = gpu_freq_reader();
+    GpuSnapshot dvfs = GpuMonitor::get_snapshot();
     long current_freq = -1;
-    std::string freq_path_used = "";
-
-    // 按优先级尝试所有可能的路径
-    for (const auto& path : GPU_FREQ_PATHS) {
-        try {
-            if (fs::exists(path)) {
-                std::ifstream freq_file(path);
-                if (freq_file.is_open()) {
-                    std::string freq_str;
-                    std::getline(freq_file, freq_str);
-                    freq_file.close();
-                    
-                    // 确保读取的是有效数字
-                    if (!freq_str.empty() && std::all_of(freq_str.begin(), freq_str.end(), ::isdigit)) {
-                        current_freq = std::stol(freq_str);
-                        freq_path_used = path;
-                        break;
-                    }
-                }
-            }
-        } catch (const std::exception& e) {
-            Logger::error(std::string("尝试访问 ") + path + " 时出错: " + e.what());
-        }
-    }
-    
-    // 如果都没有找到，尝试备用方案
-    if (current_freq == -1) {
-        // 尝试通过命令获取
-        FILE* pipe = popen("cat /sys/class/devfreq/ff9a0000.gpu/cur_freq 2>/dev/null", "r");
-        if (pipe) {
-            char buffer[64];
-            if (fgets(buffer, sizeof(buffer), pipe)) {
-                current_freq = atol(buffer);
-                freq_path_used = "命令行获取";
-            }
-            pclose(pipe);
-        }
+    std::string freq_path_used = reader.path();
+    if (!reader.read_long(current_freq) || current_freq < 0) {
+        // 固定路径不可用时使用调频监控发现（或配置）的 devfreq 节点
+        current_freq = dvfs.cur_freq_hz;
+        freq_path_used = dvfs.devfreq_path + "/cur_freq";
     }
-    
-    if (current_freq == -1) {
+    if (current_freq < 0) {
         return {"error", "无法获取GPU频率信息: 没有有效的访问路径"};
     }
 
     // 获取GPU温度
     int gpu_temp = get_gpu_temperature();
     
-    // 根据RK3588文档，频率范围可能为100-800MHz或100-1000MHz
-    const long MIN_FREQ = 100000000;  // 100 MHz
-    const long MAX_FREQ = 900000000;  // 900 MHz
+    // 有效频点范围优先取自 devfreq 频率表；根据RK3588文档，缺省范围为100-900MHz
+    long MIN_FREQ = 100000000;  // 100 MHz
+    long MAX_FREQ = 900000000;  // 900 MHz
+    if (!dvfs.frequencies_hz.empty()) {
+        MIN_FREQ = dvfs.frequencies_hz.front();
+        MAX_FREQ = dvfs.frequencies_hz.back();
+    }
     
     std::string status = "success";
     std::string temp_info = "";
@@ -157,7 +172,53 @@ SystemCheckResult SystemCheck::check_gpu_frequency() {
                 MIN_FREQ/1000000.0, MAX_FREQ/1000000.0);
     }
     
-    return {status, buffer};
+    std::string message = buffer;
+    nlohmann::json details;
+    if (dvfs.available && !dvfs.windows.empty()) {
+        // 汇总近 60 秒的调频情况，完整的窗口统计放在 details 中
+        const GpuResidencyWindow& window = dvfs.windows.size() > 1 ? dvfs.windows[1] : dvfs.windows.front();
+        char summary[160];
+        snprintf(summary, sizeof(summary), "; 近%d秒: 切换 %.1f 次/秒",
+                 window.seconds, window.transitions_per_second);
+        message += summary;
+        if (!window.residency_percent.empty()) {
+            snprintf(summary, sizeof(summary), ", 最高频驻留 %.0f%%", window.residency_percent.back());
+            message += summary;
+        }
+        if (window.average_load >= 0) {
+            snprintf(summary, sizeof(summary), ", 平均负载 %.0f%%", window.average_load);
+            message += summary;
+        }
+
+        std::vector<std::string> warnings = GpuMonitor::throttle_warnings(dvfs);
+        if (!warnings.empty()) {
+            status = "warning";
+            message += " [疑似限频:";
+            for (const auto& warning : warnings) message += " " + warning;
+            message += "]";
+        }
+
+        nlohmann::json windows = nlohmann::json::array();
+        for (const auto& w : dvfs.windows) {
+            windows.push_back({
+                {"seconds", w.seconds},
+                {"covered_seconds", w.covered_seconds},
+                {"residency_percent", w.residency_percent},
+                {"transitions_per_second", w.transitions_per_second},
+                {"average_load", w.average_load}
+            });
+        }
+        details = {
+            {"devfreq", dvfs.devfreq_path},
+            {"frequencies_hz", dvfs.frequencies_hz},
+            {"cur_freq_hz", dvfs.cur_freq_hz},
+            {"limit_freq_hz", dvfs.limit_freq_hz},
+            {"load_percent", dvfs.load_percent},
+            {"windows", windows}
+        };
+    }
+    
+    return {status, message, details.is_null() ? std::string() : details.dump()};
 }
 
 SystemCheckResult SystemCheck::check_serial_devices() {
@@ -166,6 +227,7 @@ SystemCheckResult SystemCheck::check_serial_devices() {
     std::vector<std::string> detected_ports;
     
     for (const auto& port : SERIAL_PORTS) {
+        if (CheckContext::cancelled()) break;
         if (fs::exists(port)) {
             int fd = open(port.c_str(), O_RDWR | O_NOCTTY | O_NDELAY);
             if (fd != -1) {
@@ -194,7 +256,7 @@ SystemCheckResult SystemCheck::check_camera_devices() {
     std::vector<std::string> camera_devices;
     
     // 检测CSI相机
-    for (int i = 0; i < 10; ++i) {
+    for (int i = 0; i < 10 && !CheckContext::cancelled(); ++i) {
         std::string device_path = "/dev/video" + std::to_string(i);
         if (fs::exists(device_path)) {
             int fd = open(device_path.c_str(), O_RDONLY);
@@ -211,7 +273,7 @@ SystemCheckResult SystemCheck::check_camera_devices() {
     }
     
     // 检测USB相机
-    for (int i = 10; i < 20; ++i) {
+    for (int i = 10; i < 20 && !CheckContext::cancelled(); ++i) {
         std::string device_path = "/dev/video" + std::to_string(i);
         if (fs::exists(device_path)) {
             int fd = open(device_path.c_str(), O_RDONLY);
@@ -235,57 +297,14 @@ SystemCheckResult SystemCheck::check_camera_devices() {
     return {"warning", "未检测到相机设备"};
 }
 
-SystemCheckResult SystemCheck::check_memory_usage() {
-    Logger::info("执行内存占用检测");
-    
-    std::ifstream meminfo_file("/proc/meminfo");
-    if (!meminfo_file.is_open()) {
-        return {"error", "无法打开/proc/meminfo"};
-    }
-    
-    long total_ram = 0, free_ram = 0, buffers = 0, cached = 0;
-    std::string line;
-    
-    while (std::getline(meminfo_file, line)) {
-        if (line.find("MemTotal") != std::string::npos) {
-            sscanf(line.c_str(), "MemTotal: %ld kB", &total_ram);
-        } else if (line.find("MemFree") != std::string::npos) {
-            sscanf(line.c_str(), "MemFree: %ld kB", &free_ram);
-        } else if (line.find("Buffers") != std::string::npos) {
-            sscanf(line.c_str(), "Buffers: %ld kB", &buffers);
-        } else if (line.find("Cached") != std::string::npos) {
-            sscanf(line.c_str(), "Cached: %ld kB", &cached);
-        }
-    }
-    meminfo_file.close();
-    
-    if (total_ram <= 0) {
-        return {"error", "无效的内存信息"};
-    }
-    
-    long available_ram = free_ram + buffers + cached;
-    long used_ram = total_ram - available_ram;
-    int usage_percent = static_cast<int>((used_ram * 100) / total_ram);
-    
-    std::string status = "success";
-    if (usage_percent > 85) {
-        status = "error";
-    } else if (usage_percent > 70) {
-        status = "warning";
-    }
-    
-    std::ostringstream oss;
-    oss << "总内存: " << total_ram/1024 << "MB, 已用: " << used_ram/1024 
-        << "MB, 可用: " << available_ram/1024 << "MB, 使用率: " << usage_percent << "%";
-    
-    return {status, oss.str()};
-}
-
 SystemCheckResult SystemCheck::check_ssh_connection() {
     Logger::info("执行 SSH 连接检测");
     
     // 检测SSH服务状态
     int service_status = system("systemctl is-active --quiet ssh");
+    if (CheckContext::cancelled()) {
+        return {"error", "SSH检测已取消"};
+    }
     if (service_status == 0) {
         // 检查端口监听
         int port_status = system("ss -tuln | grep -q ':22'");
@@ -299,8 +318,48 @@ SystemCheckResult SystemCheck::check_ssh_connection() {
 }
 
 std::string SystemCheck::create_json_response(const SystemCheckResult& result) {
-    char buffer[512];
-    snprintf(buffer, sizeof(buffer), R"({"status":"%s","message":"%s"})", 
-             result.status.c_str(), result.message.c_str());
-    return buffer;
+    // 使用json库序列化，保证消息中的引号等字符被正确转义
+    nlohmann::json j = {
+        {"status", result.status},
+        {"message", result.message}
+    };
+    if (!result.details.empty()) {
+        nlohmann::json details = nlohmann::json::parse(result.details, nullptr, false);
+        if (!details.is_discarded()) {
+            j["details"] = details;
+        }
+    }
+    return j.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+}
+
+const std::vector<CheckDefinition>& SystemCheck::get_check_definitions() {
+    // SSH检测依赖外部命令，给予更长的超时时间；GPU频率检测依赖 devfreq 节点
+    static const std::vector<CheckDefinition> definitions = {
+        {"ssh",         &SystemCheck::check_ssh_connection,  3000, CostClass::HEAVY, {}},
+        {"memory",      &MemoryMonitor::check,               1000, CostClass::CHEAP, {}},
+        {"gpu_devfreq", &SystemCheck::check_gpu_devfreq,      500, CostClass::CHEAP, {}},
+        {"gpu",         &SystemCheck::check_gpu_frequency,   2000, CostClass::CHEAP, {"gpu_devfreq"}},
+        {"serial",      &SystemCheck::check_serial_devices,  2000, CostClass::IO,    {}},
+        {"camera",      &SystemCheck::check_camera_devices,  3000, CostClass::IO,    {}},
+        {"cpu",         &CpuMonitor::check,                  1000, CostClass::CHEAP, {}},
+        {"thermal",     &ThermalMonitor::check,               500, CostClass::CHEAP, {}},
+        {"load",        &LoadShedder::check,                  500, CostClass::CHEAP, {}},
+        {"processes",   &ProcessMonitor::check,              1000, CostClass::CHEAP, {}},
+        {"interrupts",  &InterruptMonitor::check,            1000, CostClass::CHEAP, {}},
+        {"storage",     &StorageMonitor::check,              1000, CostClass::IO,    {}},
+        {"network",     &NetworkMonitor::check,              1000, CostClass::CHEAP, {}},
+        {"ipc",         &EndpointProbe::check,               2000, CostClass::IO,    {}},
+        {"models",      &ModelVerifier::check,              15000, CostClass::HEAVY, {}},
+        {"can",         &CanMonitor::check,                  6000, CostClass::IO,    {}},
+        {"kernel",      &KernelLogMonitor::check,             500, CostClass::CHEAP, {}},
+        {"usb",         &UsbTopology::check,                 1000, CostClass::CHEAP, {}},
+        // 读写探测会占满存储带宽，仅在显式请求时执行
+        {"storage_probe", &StorageMonitor::probe,           10000, CostClass::HEAVY, {"storage"}, "builtin", true},
+        // 回环测试占用串口收发，同样按需执行
+        {"serial_loopback", &SerialLoopback::check,          8000, CostClass::HEAVY, {}, "builtin", true},
+        {"serial_stream", &SerialStream::check,             12000, CostClass::IO,    {}, "builtin", true},
+        {"latency",     &LatencyTest::check,                12000, CostClass::HEAVY, {}, "builtin", true},
+        {"hardware",    &HardwareTest::check,               12000, CostClass::HEAVY, {}, "builtin", true}
+    };
+    return definitions;
 }
\ No newline at end of file
@@ -2,17 +2,40 @@
 #define SYSTEM_CHECK_H
 
 #include "../types/common_types.h"
+#include "../utils/sysfs_reader.h"
 #include <string>
 #include <vector>
 #include <map>
+#include <functional>
+
+// 检测开销等级：调度时优先执行廉价检测，并限制重型检测的并发数
+enum class CostClass {
+    CHEAP,   // 仅读取 sysfs/procfs
+    IO,      // 需要打开设备节点
+    HEAVY    // 需要启动外部进程
+};
+
+// 检测项定义：名称、检测函数、默认超时时间、开销等级与依赖项
+struct CheckDefinition {
+    std::string name;
+    std::function<SystemCheckResult()> run;
+    int timeout_ms;
+    CostClass cost;
+    std::vector<std::string> depends_on;  // 任一依赖失败时跳过本检测
+    std::string source = "builtin";       // "builtin" 或插件文件路径
+    bool on_demand = false;               // 仅在显式请求时执行，不计入默认的批量检测
+};
 
 class SystemCheck {
 public:
+    // 启动时解析 sysfs/procfs 路径并打开常驻文件描述符
+    static void initialize();
+    
     // SSH连接检测
     static SystemCheckResult check_ssh_connection();
     
-    // 内存占用检测
-    static SystemCheckResult check_memory_usage();
+    // GPU devfreq 节点检测（GPU频率检测的前置条件）
+    static SystemCheckResult check_gpu_devfreq();
     
     // GPU频点设置检测
     static SystemCheckResult check_gpu_frequency();
@@ -25,11 +48,18 @@ public:
     
     // 创建JSON响应
     static std::string create_json_response(const SystemCheckResult& result);
+    
+    // 内置检测项（按前端展示顺序），由 CheckRegistry 注册
+    static const std::vector<CheckDefinition>& get_check_definitions();
 
 private:
     // GPU温度检测（辅助函数）
     static int get_gpu_temperature();
     
+    // 常驻的 sysfs/procfs 读取器（首次使用时解析路径）
+    static const SysfsReader& gpu_freq_reader();
+    static const SysfsReader& gpu_temp_reader();
+    
     // RK3588 GPU路径常量
     static const std::vector<std::string> GPU_TEMP_PATHS;
     static const std::vector<std::string> GPU_FREQ_PATHS;
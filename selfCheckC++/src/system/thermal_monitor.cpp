@@ -0,0 +1,211 @@
+#include "thermal_monitor.h"
+#include "metric_sampler.h"
+#include "../config/config_manager.h"
+#include "../utils/file_utils.h"
+#include "../utils/logger.h"
+#include "../utils/string_utils.h"
+#include <algorithm>
+#include <filesystem>
+#include <map>
+#include <nlohmann/json.hpp>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+// 静态成员初始化
+std::mutex ThermalMonitor::mutex;
+std::vector<ThermalMonitor::Zone> ThermalMonitor::zones;
+int ThermalMonitor::margin_warn_c = 10;
+
+namespace {
+
+// 启动时读取热区的触发点，active 类触发点只用于风扇调速，不参与余量计算
+std::vector<ThermalTrip> read_trips(const fs::path& zone_dir) {
+    std::vector<ThermalTrip> trips;
+    for (int index = 0;; ++index) {
+        const std::string prefix = (zone_dir / ("trip_point_" + std::to_string(index))).string();
+        SysfsReader temp({prefix + "_temp"});
+        long value = 0;
+        if (!temp.read_long(value)) break;
+        trips.push_back({trim(FileUtils::read_file(prefix + "_type")), value});
+    }
+    std::sort(trips.begin(), trips.end(),
+              [](const ThermalTrip& a, const ThermalTrip& b) { return a.temp_mc < b.temp_mc; });
+    return trips;
+}
+
+std::string format_celsius(long temp_mc) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.1f°C", temp_mc / 1000.0);
+    return buffer;
+}
+
+} // namespace
+
+void ThermalMonitor::initialize() {
+    YAML::Node config = ConfigManager::get_system_config();
+    margin_warn_c = config["thermal_margin_warn_c"].as<int>(10);
+    int sample_hz = std::max(1, config["thermal_sample_hz"].as<int>(1));
+    const std::string root = config["thermal_sysfs_path"].as<std::string>("/sys/class/thermal");
+
+    // 按热区编号排序，保证输出顺序稳定
+    std::map<int, Zone> by_id;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(root, ec)) {
+        const std::string name = entry.path().filename().string();
+        if (name.rfind("thermal_zone", 0) != 0) continue;
+
+        Zone zone;
+        zone.stats.id = std::atoi(name.c_str() + 12);
+        zone.stats.type = trim(FileUtils::read_file((entry.path() / "type").string()));
+        if (zone.stats.type.empty()) zone.stats.type = name;
+        zone.stats.trips = read_trips(entry.path());
+        if (!zone.temp.open({(entry.path() / "temp").string()})) {
+            Logger::warning("热区 " + name + " 温度不可读，已忽略");
+            continue;
+        }
+        by_id[zone.stats.id] = std::move(zone);
+    }
+
+    std::map<std::string, int> type_count;
+    for (auto& [id, zone] : by_id) {
+        if (type_count[zone.stats.type]++ > 0) {
+            zone.series = "thermal." + zone.stats.type + "-" + std::to_string(id) + ".temp_c";
+        } else {
+            zone.series = "thermal." + zone.stats.type + ".temp_c";
+        }
+
+        std::ostringstream oss;
+        oss << "热区 thermal_zone" << id << ": " << zone.stats.type << "，触发点";
+        if (zone.stats.trips.empty()) oss << " 无";
+        for (const auto& trip : zone.stats.trips) {
+            oss << " " << trip.type << "@" << format_celsius(trip.temp_mc);
+        }
+        Logger::info(oss.str());
+        zones.push_back(std::move(zone));
+    }
+
+    if (zones.empty()) {
+        Logger::warning("未发现可读的热区，温度监控不可用");
+        return;
+    }
+    MetricSampler::register_task("thermal", std::chrono::milliseconds(1000 / sample_hz), &ThermalMonitor::sample);
+}
+
+void ThermalMonitor::sample() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& zone : zones) {
+        ThermalZoneStats& stats = zone.stats;
+        long raw = 0;
+        stats.valid = zone.temp.read_long(raw);
+        if (!stats.valid) continue;
+        stats.temp_mc = raw;
+
+        stats.margin_trip.clear();
+        for (const auto& trip : stats.trips) {
+            if (trip.type == "active") continue;
+            stats.margin_mc = trip.temp_mc - stats.temp_mc;
+            stats.margin_trip = trip.type;
+            break;
+        }
+        MetricSampler::record(zone.series, stats.temp_mc / 1000.0);
+    }
+}
+
+std::vector<ThermalZoneStats> ThermalMonitor::get_zones() {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<ThermalZoneStats> result;
+    result.reserve(zones.size());
+    for (const auto& zone : zones) {
+        result.push_back(zone.stats);
+    }
+    return result;
+}
+
+bool ThermalMonitor::find_temperature(const std::string& keyword, long& temp_mc) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& zone : zones) {
+        if (zone.stats.type.find(keyword) == std::string::npos) continue;
+        long raw = 0;
+        if (zone.temp.read_long(raw)) {
+            temp_mc = raw;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThermalMonitor::max_temperature(long& temp_mc) {
+    std::lock_guard<std::mutex> lock(mutex);
+    bool found = false;
+    for (const auto& zone : zones) {
+        long raw = 0;
+        if (!zone.temp.read_long(raw)) continue;
+        if (!found || raw > temp_mc) temp_mc = raw;
+        found = true;
+    }
+    return found;
+}
+
+SystemCheckResult ThermalMonitor::check() {
+    Logger::info("执行温度检测");
+
+    // 检测时现场读取一次，不依赖采样线程的节拍
+    sample();
+    std::vector<ThermalZoneStats> snapshot = get_zones();
+    if (snapshot.empty()) {
+        return {"error", "未发现可读的热区"};
+    }
+
+    std::string status = "success";
+    std::ostringstream message;
+    std::vector<std::string> warnings;
+    nlohmann::json zones_json = nlohmann::json::array();
+
+    bool first = true;
+    for (const auto& zone : snapshot) {
+        if (!zone.valid) {
+            warnings.push_back(zone.type + " 读取失败");
+            continue;
+        }
+        if (!first) message << "; ";
+        first = false;
+        message << zone.type << ": " << format_celsius(zone.temp_mc);
+
+        nlohmann::json trips = nlohmann::json::array();
+        for (const auto& trip : zone.trips) {
+            trips.push_back({{"type", trip.type}, {"temp_mc", trip.temp_mc}});
+            if (trip.type == "critical" && zone.temp_mc >= trip.temp_mc) {
+                status = "error";
+            }
+        }
+
+        nlohmann::json entry = {
+            {"id", zone.id},
+            {"type", zone.type},
+            {"temp_mc", zone.temp_mc},
+            {"trips", trips}
+        };
+        if (!zone.margin_trip.empty()) {
+            message << " (距 " << zone.margin_trip << " " << format_celsius(zone.margin_mc) << ")";
+            entry["margin_mc"] = zone.margin_mc;
+            entry["margin_trip"] = zone.margin_trip;
+            if (zone.margin_mc < 0) {
+                warnings.push_back(zone.type + " 已超过 " + zone.margin_trip + " 触发点");
+            } else if (zone.margin_mc < margin_warn_c * 1000L) {
+                warnings.push_back(zone.type + " 接近 " + zone.margin_trip + " 触发点");
+            }
+        }
+        zones_json.push_back(entry);
+    }
+
+    if (!warnings.empty()) {
+        if (status != "error") status = "warning";
+        message << " [告警:";
+        for (const auto& warning : warnings) message << " " << warning;
+        message << "]";
+    }
+
+    nlohmann::json details = {{"zones", zones_json}};
+    return {status, message.str(), details.dump()};
+}
@@ -0,0 +1,61 @@
+#ifndef THERMAL_MONITOR_H
+#define THERMAL_MONITOR_H
+
+#include "../types/common_types.h"
+#include "../utils/sysfs_reader.h"
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 热区触发点（trip point）
+struct ThermalTrip {
+    std::string type;    // passive / active / hot / critical
+    long temp_mc = 0;    // 毫摄氏度
+};
+
+// 单个热区的采样结果
+struct ThermalZoneStats {
+    int id = -1;                     // thermal_zoneN 中的 N
+    std::string type;                // 如 soc-thermal、bigcore0-thermal、gpu-thermal
+    long temp_mc = 0;
+    bool valid = false;              // 本次是否读取成功
+    std::vector<ThermalTrip> trips;  // 按温度升序
+    long margin_mc = 0;              // 距最近的降频/关机触发点的余量，可为负
+    std::string margin_trip;         // 余量对应的触发点类型，为空表示没有此类触发点
+};
+
+// 热区监控：启动时枚举所有 thermal_zone 的类型与触发点，
+// 之后通过常驻 fd 采样温度并计算距触发点的余量
+class ThermalMonitor {
+public:
+    // 枚举热区并注册后台采样任务
+    static void initialize();
+
+    // 读取所有热区温度，供采样线程与检测调用
+    static void sample();
+
+    // 最近一次采样结果
+    static std::vector<ThermalZoneStats> get_zones();
+
+    // 按类型查找热区温度（类型包含 keyword 即匹配），未找到返回 false
+    static bool find_temperature(const std::string& keyword, long& temp_mc);
+
+    // 所有热区中的最高温度，没有热区时返回 false
+    static bool max_temperature(long& temp_mc);
+
+    // 温度检测：逐热区报告温度与余量，接近或超过触发点时告警
+    static SystemCheckResult check();
+
+private:
+    struct Zone {
+        ThermalZoneStats stats;
+        SysfsReader temp;
+        std::string series;   // 预先生成的指标名称
+    };
+
+    static std::mutex mutex;
+    static std::vector<Zone> zones;
+    static int margin_warn_c;
+};
+
+#endif // THERMAL_MONITOR_H
@@ -0,0 +1,226 @@
+#include "thread_placement.h"
+#include "cpu_monitor.h"
+#include "../config/config_manager.h"
+#include "../utils/file_utils.h"
+#include "../utils/logger.h"
+#include "../utils/proc_parser.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sched.h>
+#include <sstream>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// 静态成员初始化
+ThreadPlacement::RolePolicy ThreadPlacement::server = {{}, SCHED_OTHER};
+ThreadPlacement::RolePolicy ThreadPlacement::check_worker = {{}, SCHED_OTHER};
+ThreadPlacement::RolePolicy ThreadPlacement::sampler = {{}, SCHED_IDLE};
+ThreadPlacement::RolePolicy ThreadPlacement::image_transfer = {{}, SCHED_BATCH};
+
+namespace {
+
+const char* policy_name(int policy) {
+    switch (policy) {
+        case SCHED_BATCH: return "SCHED_BATCH";
+        case SCHED_IDLE: return "SCHED_IDLE";
+        default: return "SCHED_OTHER";
+    }
+}
+
+int parse_policy(const std::string& name, int fallback) {
+    if (name == "other") return SCHED_OTHER;
+    if (name == "batch") return SCHED_BATCH;
+    if (name == "idle") return SCHED_IDLE;
+    if (!name.empty()) Logger::warning("未知的调度策略: " + name + "，使用 " + policy_name(fallback));
+    return fallback;
+}
+
+// 把 CPU 列表格式化为 "0-3,6" 的紧凑形式
+std::string format_cpu_list(const std::vector<int>& cpus) {
+    if (cpus.empty()) return "全部";
+    std::ostringstream oss;
+    for (size_t i = 0; i < cpus.size(); ++i) {
+        size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) ++j;
+        if (i > 0) oss << ",";
+        oss << cpus[i];
+        if (j > i) oss << "-" << cpus[j];
+        i = j;
+    }
+    return oss.str();
+}
+
+// "auto" 表示存在大小核时使用全部小核，否则不限制
+std::vector<int> resolve_cpus(const std::string& spec, const std::vector<int>& online,
+                              const std::vector<CpuClusterStats>& clusters) {
+    std::vector<int> requested;
+    if (spec == "auto") {
+        const bool has_big = std::any_of(clusters.begin(), clusters.end(),
+                                         [](const CpuClusterStats& c) { return c.big; });
+        if (!has_big) return {};
+        for (const auto& cluster : clusters) {
+            if (!cluster.big) requested.insert(requested.end(), cluster.cpus.begin(), cluster.cpus.end());
+        }
+    } else {
+        requested = proc::parse_cpu_list(spec);
+    }
+
+    std::vector<int> cpus;
+    for (int cpu : requested) {
+        if (std::find(online.begin(), online.end(), cpu) != online.end()) cpus.push_back(cpu);
+    }
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    if (!requested.empty() && cpus.empty()) {
+        Logger::warning("配置的 CPU " + spec + " 均不在线，不限制亲和性");
+    }
+    return cpus;
+}
+
+bool write_value(const std::string& path, const std::string& value) {
+    int fd = ::open(path.c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    bool ok = ::write(fd, value.c_str(), value.size()) == static_cast<ssize_t>(value.size());
+    int saved_errno = errno;
+    ::close(fd);
+    errno = saved_errno;
+    return ok;
+}
+
+// 从 mountinfo 中找到 cgroup2 挂载点（纯 v2 为 /sys/fs/cgroup，混合模式为 /sys/fs/cgroup/unified）
+std::string find_cgroup2_mount() {
+    std::istringstream mountinfo(FileUtils::read_file("/proc/self/mountinfo"));
+    std::string line;
+    while (std::getline(mountinfo, line)) {
+        size_t separator = line.find(" - cgroup2 ");
+        if (separator == std::string::npos) continue;
+        std::istringstream fields(line.substr(0, separator));
+        std::string field;
+        for (int i = 0; i < 5 && fields >> field; ++i) {}
+        return field;
+    }
+    return {};
+}
+
+} // namespace
+
+void ThreadPlacement::initialize() {
+    YAML::Node config = ConfigManager::get_system_config();
+    const std::vector<int> online = proc::parse_cpu_list(FileUtils::read_file("/sys/devices/system/cpu/online"));
+    const std::vector<CpuClusterStats> clusters = CpuMonitor::get_snapshot().clusters;
+
+    server.cpus = resolve_cpus(config["server_cpus"].as<std::string>("auto"), online, clusters);
+    check_worker.cpus = resolve_cpus(config["check_worker_cpus"].as<std::string>("auto"), online, clusters);
+    sampler.cpus = resolve_cpus(config["sampler_cpus"].as<std::string>("auto"), online, clusters);
+    image_transfer.cpus = server.cpus;
+    sampler.policy = parse_policy(config["sampler_sched_policy"].as<std::string>("idle"), SCHED_IDLE);
+    image_transfer.policy = parse_policy(config["image_sched_policy"].as<std::string>("batch"), SCHED_BATCH);
+
+    // 启动日志：CPU 拓扑
+    std::ostringstream topology;
+    topology << "CPU 拓扑: 在线 " << format_cpu_list(online);
+    for (const auto& cluster : clusters) {
+        topology << " | " << cluster.name << " [" << format_cpu_list(cluster.cpus) << "]"
+                 << (cluster.big ? " 大核" : " 小核");
+        if (cluster.max_freq_khz > 0) topology << " " << cluster.max_freq_khz / 1000 << "MHz";
+    }
+    Logger::info(topology.str());
+
+    std::string cgroup_info = "未设置";
+    const int weight = config["cgroup_cpu_weight"].as<int>(0);
+    if (weight > 0) {
+        std::string cgroup_path;
+        if (apply_cgroup_weight(weight, cgroup_path)) {
+            cgroup_info = std::to_string(weight) + " (" + cgroup_path + ")";
+        } else {
+            cgroup_info = "设置失败";
+        }
+    }
+
+    Logger::info("线程放置: 服务 CPU " + format_cpu_list(server.cpus) + " " + policy_name(server.policy) +
+                 "; 检测 CPU " + format_cpu_list(check_worker.cpus) + " " + policy_name(check_worker.policy) +
+                 "; 采样 CPU " + format_cpu_list(sampler.cpus) + " " + policy_name(sampler.policy) +
+                 "; 图片传输 " + policy_name(image_transfer.policy) +
+                 "; cgroup cpu.weight " + cgroup_info);
+}
+
+const ThreadPlacement::RolePolicy& ThreadPlacement::policy_for(ThreadRole role) {
+    switch (role) {
+        case ThreadRole::CHECK_WORKER: return check_worker;
+        case ThreadRole::SAMPLER: return sampler;
+        case ThreadRole::IMAGE_TRANSFER: return image_transfer;
+        default: return server;
+    }
+}
+
+void ThreadPlacement::apply(ThreadRole role) {
+    const RolePolicy& placement = policy_for(role);
+
+    if (!placement.cpus.empty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : placement.cpus) CPU_SET(cpu, &set);
+        if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+            Logger::warning("设置线程 CPU 亲和性失败: " + std::string(strerror(errno)));
+        }
+    }
+
+    if (sched_getscheduler(0) != placement.policy) {
+        sched_param param{};
+        if (sched_setscheduler(0, placement.policy, &param) != 0) {
+            Logger::warning(std::string("设置线程调度策略 ") + policy_name(placement.policy) +
+                            " 失败: " + strerror(errno));
+        }
+    }
+}
+
+std::vector<int> ThreadPlacement::current_affinity() {
+    std::vector<int> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+bool ThreadPlacement::apply_cgroup_weight(int weight, std::string& cgroup_path) {
+    const std::string mount = find_cgroup2_mount();
+    if (mount.empty()) {
+        Logger::warning("未挂载 cgroup v2，无法设置 cpu.weight");
+        return false;
+    }
+
+    std::string own_path;
+    std::istringstream cgroup(FileUtils::read_file("/proc/self/cgroup"));
+    std::string line;
+    while (std::getline(cgroup, line)) {
+        if (line.rfind("0::", 0) == 0) own_path = line.substr(3);
+    }
+
+    // 根 cgroup 没有 cpu.weight：创建子 cgroup 并把整个进程迁入。
+    // 由 systemd 启动时更推荐在 unit 中配置 CPUWeight=，此处直接写入所在 cgroup
+    cgroup_path = mount + own_path;
+    if (own_path.empty() || own_path == "/") {
+        cgroup_path = mount + "/selfcheck";
+        if (::mkdir(cgroup_path.c_str(), 0755) != 0 && errno != EEXIST) {
+            Logger::warning("创建 cgroup " + cgroup_path + " 失败: " + strerror(errno));
+            return false;
+        }
+        write_value(mount + "/cgroup.subtree_control", "+cpu");
+        if (!write_value(cgroup_path + "/cgroup.procs", std::to_string(getpid()))) {
+            Logger::warning("迁入 cgroup " + cgroup_path + " 失败: " + strerror(errno));
+            return false;
+        }
+    }
+
+    if (!write_value(cgroup_path + "/cpu.weight", std::to_string(weight))) {
+        Logger::warning("写入 " + cgroup_path + "/cpu.weight 失败（cpu 控制器未启用？）: " + strerror(errno));
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,44 @@
+#ifndef THREAD_PLACEMENT_H
+#define THREAD_PLACEMENT_H
+
+#include <string>
+#include <vector>
+
+// 服务线程的角色，决定其 CPU 亲和性与调度策略
+enum class ThreadRole {
+    SERVER,          // accept 主线程及其派生的连接线程
+    CHECK_WORKER,    // 批量检测线程池
+    SAMPLER,         // 后台指标采样线程
+    IMAGE_TRANSFER   // 图片传输（在连接线程内切换）
+};
+
+// 线程放置：把自检服务的线程限制在配置的 A55 小核上，后台任务使用
+// SCHED_IDLE/SCHED_BATCH，并可为整个进程设置 cgroup v2 cpu.weight，
+// 避免与 VO 等飞控进程争抢 A76 大核
+class ThreadPlacement {
+public:
+    // 读取配置，设置 cgroup 权重，并输出 CPU 拓扑与生效的放置策略
+    static void initialize();
+
+    // 对调用线程应用角色对应的亲和性与调度策略（Linux 上二者均按线程生效）
+    static void apply(ThreadRole role);
+
+    // 调用线程当前允许运行的 CPU
+    static std::vector<int> current_affinity();
+
+private:
+    struct RolePolicy {
+        std::vector<int> cpus;   // 为空表示不限制
+        int policy;              // SCHED_OTHER / SCHED_BATCH / SCHED_IDLE
+    };
+
+    static const RolePolicy& policy_for(ThreadRole role);
+    static bool apply_cgroup_weight(int weight, std::string& cgroup_path);
+
+    static RolePolicy server;
+    static RolePolicy check_worker;
+    static RolePolicy sampler;
+    static RolePolicy image_transfer;
+};
+
+#endif // THREAD_PLACEMENT_H
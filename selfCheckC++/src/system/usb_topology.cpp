@@ -0,0 +1,536 @@
+#include "usb_topology.h"
+#include "event_bus.h"
+#include "../config/config_manager.h"
+#include "../utils/logger.h"
+#include "../utils/monotonic_clock.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <linux/netlink.h>
+#include <map>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <poll.h>
+#include <sstream>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char* const USB_ROOT = "/sys/bus/usb/devices";
+const char* const VIDEO_ROOT = "/sys/class/video4linux";
+// 插拔时同一设备会连续产生多条 uevent（设备、各接口、驱动绑定），静默这么久后再重建
+constexpr int DEBOUNCE_MS = 500;
+constexpr size_t UEVENT_BYTES = 8192;
+
+// 描述符类型
+constexpr uint8_t DESC_CONFIG = 0x02;
+constexpr uint8_t DESC_INTERFACE = 0x04;
+constexpr uint8_t DESC_ENDPOINT = 0x05;
+constexpr uint8_t DESC_SS_COMPANION = 0x30;
+constexpr uint8_t ENDPOINT_ISOCHRONOUS = 1;
+constexpr uint8_t ENDPOINT_INTERRUPT = 3;
+
+std::mutex state_mutex;
+std::vector<UsbDevice> devices;
+int64_t scanned_ms = 0;
+uint64_t scans = 0;
+std::string hotplug_error;
+
+int uevent_fd = -1;
+int wakeup_fd = -1;
+std::thread hotplug_thread;
+std::atomic<bool> running{false};
+
+int64_t now_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+std::string read_attr(const fs::path& dir, const char* name) {
+    std::ifstream input(dir / name);
+    std::string value;
+    std::getline(input, value);
+    const size_t begin = value.find_first_not_of(" \t");
+    const size_t end = value.find_last_not_of(" \t\r");
+    return begin == std::string::npos ? "" : value.substr(begin, end - begin + 1);
+}
+
+long read_number(const fs::path& dir, const char* name, int base, long fallback) {
+    const std::string value = read_attr(dir, name);
+    if (value.empty()) return fallback;
+    char* end = nullptr;
+    const long number = std::strtol(value.c_str(), &end, base);
+    return end == value.c_str() ? fallback : number;
+}
+
+uint16_t le16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+// 端点每个服务周期传输的字节数除以服务周期。高速/超速的周期以微帧（125 us）为单位且按 2 的幂编码；
+// 全速/低速等时端点同样按 2 的幂（毫秒），中断端点直接为帧数。只计算有效载荷，不含协议开销
+double endpoint_bytes_per_s(double speed_mbps, uint8_t type, uint16_t max_packet, uint8_t interval,
+                            int companion_bytes) {
+    double bytes = 0.0;
+    double period_s = 0.0;
+    if (speed_mbps >= 480.0) {
+        const int exponent = std::clamp<int>(interval, 1, 16) - 1;
+        period_s = 125e-6 * static_cast<double>(1 << exponent);
+        if (speed_mbps >= 5000.0 && companion_bytes >= 0) {
+            bytes = companion_bytes;
+        } else {
+            // 高速高带宽端点：bit 11-12 为每微帧额外的事务数
+            bytes = static_cast<double>(max_packet & 0x7ff) * (((max_packet >> 11) & 3) + 1);
+        }
+    } else {
+        bytes = max_packet & 0x7ff;
+        if (type == ENDPOINT_ISOCHRONOUS) {
+            period_s = 1e-3 * static_cast<double>(1 << (std::clamp<int>(interval, 1, 16) - 1));
+        } else {
+            period_s = 1e-3 * std::max<int>(interval, 1);
+        }
+    }
+    return bytes / period_s;
+}
+
+// 解析 descriptors 属性（设备描述符后跟各配置的原始描述符），
+// 取当前配置中每个接口各备用设置的周期端点带宽
+void parse_descriptors(const std::string& raw, long configuration, double speed_mbps,
+                       std::map<int, UsbInterface>& interfaces) {
+    const auto* data = reinterpret_cast<const uint8_t*>(raw.data());
+    const size_t size = raw.size();
+    bool active = false;
+    UsbAltSetting* alt = nullptr;
+    int interface_number = -1;
+    // 超速端点的带宽由紧随其后的伴随描述符给出，先记下端点参数
+    int pending_type = -1;
+    uint16_t pending_packet = 0;
+    uint8_t pending_interval = 0;
+
+    auto flush = [&](int companion_bytes) {
+        if (pending_type < 0 || alt == nullptr) return;
+        alt->bytes_per_s += endpoint_bytes_per_s(speed_mbps, static_cast<uint8_t>(pending_type), pending_packet,
+                                                 pending_interval, companion_bytes);
+        if (pending_type == ENDPOINT_ISOCHRONOUS) ++alt->isochronous;
+        pending_type = -1;
+    };
+
+    for (size_t offset = 18; offset + 2 <= size;) {
+        const uint8_t length = data[offset];
+        const uint8_t type = data[offset + 1];
+        if (length < 2 || offset + length > size) break;
+        const uint8_t* d = data + offset;
+        if (type != DESC_SS_COMPANION) flush(-1);
+
+        if (type == DESC_CONFIG && length >= 9) {
+            active = d[5] == configuration;
+            alt = nullptr;
+        } else if (active && type == DESC_INTERFACE && length >= 9) {
+            interface_number = d[2];
+            UsbInterface& iface = interfaces[interface_number];
+            iface.number = interface_number;
+            if (iface.class_code < 0) iface.class_code = d[5];
+            iface.alts.push_back(UsbAltSetting{d[3], 0.0, 0});
+            alt = &iface.alts.back();
+        } else if (active && alt != nullptr && type == DESC_ENDPOINT && length >= 7) {
+            const uint8_t transfer = d[3] & 3;
+            if (transfer == ENDPOINT_ISOCHRONOUS || transfer == ENDPOINT_INTERRUPT) {
+                pending_type = transfer;
+                pending_packet = le16(d + 4);
+                pending_interval = d[6];
+            }
+        } else if (type == DESC_SS_COMPANION && length >= 6) {
+            flush(le16(d + 4));
+        }
+        offset += length;
+    }
+    flush(-1);
+}
+
+std::string class_name(int code) {
+    switch (code) {
+        case 0x01: return "audio";
+        case 0x02: return "cdc";
+        case 0x03: return "hid";
+        case 0x06: return "image";
+        case 0x08: return "storage";
+        case 0x09: return "hub";
+        case 0x0a: return "cdc-data";
+        case 0x0e: return "video";
+        case 0xe0: return "wireless";
+        case 0xef: return "misc";
+        case 0xff: return "vendor";
+        default: return std::to_string(code);
+    }
+}
+
+std::string format_rate(double bytes_per_s) {
+    std::ostringstream out;
+    out.setf(std::ios::fixed);
+    out.precision(1);
+    out << bytes_per_s / 1e6 << " MB/s";
+    return out.str();
+}
+
+std::string format_speed(double mbps) {
+    std::ostringstream out;
+    out << mbps << "M";
+    return out.str();
+}
+
+// 各接口当前备用设置对应的带宽与可能的最大带宽
+void interface_bandwidth(const UsbInterface& iface, int& current_alt, double& active, double& maximum) {
+    long alt = 0;
+    current_alt = iface.current_alt.read_long(alt) ? static_cast<int>(alt) : 0;
+    active = 0.0;
+    maximum = 0.0;
+    for (const auto& setting : iface.alts) {
+        if (setting.number == current_alt) active = setting.bytes_per_s;
+        maximum = std::max(maximum, setting.bytes_per_s);
+    }
+}
+
+nlohmann::json device_tree(const std::vector<UsbDevice>& list, const std::string& parent) {
+    nlohmann::json children = nlohmann::json::array();
+    for (const auto& device : list) {
+        if (device.parent != parent) continue;
+        nlohmann::json node = {
+            {"name", device.name},
+            {"id", device.id},
+            {"product", device.product},
+            {"speed_mbps", device.speed_mbps},
+            {"usb_version", device.bcd_usb / 100.0},
+            {"hub", device.hub}
+        };
+        if (device.downgraded) node["supported_mbps"] = device.supported_mbps;
+        if (!device.videos.empty()) node["videos"] = device.videos;
+        nlohmann::json interfaces = nlohmann::json::array();
+        for (const auto& iface : device.interfaces) {
+            int alt = 0;
+            double active = 0.0;
+            double maximum = 0.0;
+            interface_bandwidth(iface, alt, active, maximum);
+            interfaces.push_back({
+                {"number", iface.number},
+                {"class", class_name(iface.class_code)},
+                {"driver", iface.driver},
+                {"alt", alt},
+                {"active_bytes_s", active},
+                {"max_bytes_s", maximum}
+            });
+        }
+        node["interfaces"] = interfaces;
+        nlohmann::json grandchildren = device_tree(list, device.name);
+        if (!grandchildren.empty()) node["children"] = grandchildren;
+        children.push_back(std::move(node));
+    }
+    return children;
+}
+
+} // namespace
+
+double UsbTopology::periodic_budget(double speed_mbps) {
+    if (speed_mbps >= 10000.0) return speed_mbps * 1e6 / 8.0 * 128.0 / 132.0 * 0.9;   // 128b/132b 编码
+    if (speed_mbps >= 5000.0) return speed_mbps * 1e6 / 10.0 * 0.9;                   // 8b/10b 编码
+    if (speed_mbps >= 480.0) return speed_mbps * 1e6 / 8.0 * 0.8;
+    return speed_mbps * 1e6 / 8.0 * 0.9;
+}
+
+std::vector<UsbDevice> UsbTopology::scan(const std::string& root) {
+    std::vector<UsbDevice> result;
+    std::error_code ec;
+    std::vector<std::string> names;
+    for (const auto& entry : fs::directory_iterator(root, ec)) {
+        names.push_back(entry.path().filename().string());
+    }
+    std::sort(names.begin(), names.end());
+
+    for (const auto& name : names) {
+        if (name.find(':') != std::string::npos) continue;   // 接口在所属设备下处理
+        const fs::path dir = fs::path(root) / name;
+        UsbDevice device;
+        device.name = name;
+        device.bus = static_cast<int>(read_number(dir, "busnum", 10, 0));
+        if (name.compare(0, 3, "usb") != 0) {
+            const size_t dash = name.find('-');
+            const size_t dot = name.find('.');
+            device.root_port = name.substr(0, dot);
+            device.parent = dot == std::string::npos ? "usb" + name.substr(0, dash) : name.substr(0, name.rfind('.'));
+        }
+        device.speed_mbps = std::strtod(read_attr(dir, "speed").c_str(), nullptr);
+        // version 为 bcdUSB 的十进制写法，如 " 3.20"
+        const double version = std::strtod(read_attr(dir, "version").c_str(), nullptr);
+        device.bcd_usb = static_cast<unsigned>(std::lround(version * 100.0));
+        device.supported_mbps = version >= 3.0 ? 5000.0 : version >= 2.0 ? 480.0 : 12.0;
+        device.id = read_attr(dir, "idVendor") + ":" + read_attr(dir, "idProduct");
+        device.product = read_attr(dir, "product");
+        device.hub = read_number(dir, "bDeviceClass", 16, 0) == 0x09;
+
+        std::ifstream input(dir / "descriptors", std::ios::binary);
+        const std::string raw((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+        std::map<int, UsbInterface> interfaces;
+        parse_descriptors(raw, read_number(dir, "bConfigurationValue", 10, -1), device.speed_mbps, interfaces);
+        for (const auto& entry : names) {
+            if (entry.compare(0, name.size() + 1, name + ":") != 0) continue;
+            const fs::path iface_dir = fs::path(root) / entry;
+            const int number = static_cast<int>(read_number(iface_dir, "bInterfaceNumber", 16, -1));
+            auto found = interfaces.find(number);
+            if (found == interfaces.end()) continue;
+            found->second.name = entry;
+            found->second.driver = fs::read_symlink(iface_dir / "driver", ec).filename().string();
+            found->second.current_alt.open({(iface_dir / "bAlternateSetting").string()});
+        }
+        for (auto& entry : interfaces) device.interfaces.push_back(std::move(entry.second));
+        result.push_back(std::move(device));
+    }
+
+    // 降速：USB3 设备未以超速枚举属确定的降速；支持 USB2 的集线器、相机、存储掉到全速多为线缆或端口问题
+    for (auto& device : result) {
+        if (device.root_port.empty()) continue;
+        bool high_bandwidth = device.hub;
+        for (const auto& iface : device.interfaces) {
+            high_bandwidth = high_bandwidth || iface.class_code == 0x0e || iface.class_code == 0x08;
+        }
+        device.downgraded = (device.supported_mbps >= 5000.0 && device.speed_mbps < 5000.0) ||
+                            (high_bandwidth && device.supported_mbps >= 480.0 && device.speed_mbps < 480.0);
+    }
+
+    // /dev/videoN 的 device 链接指向所属 USB 接口
+    for (const auto& entry : fs::directory_iterator(VIDEO_ROOT, ec)) {
+        const std::string iface = fs::canonical(entry.path() / "device", ec).filename().string();
+        if (ec) continue;
+        const std::string owner = iface.substr(0, iface.find(':'));
+        for (auto& device : result) {
+            if (device.name == owner) device.videos.push_back("/dev/" + entry.path().filename().string());
+        }
+    }
+    for (auto& device : result) std::sort(device.videos.begin(), device.videos.end());
+    return result;
+}
+
+void UsbTopology::rescan() {
+    std::vector<UsbDevice> updated = scan(USB_ROOT);
+    std::vector<std::string> added;
+    std::vector<std::string> removed;
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        auto describe = [](const UsbDevice& device) {
+            return device.name + " " + device.id + (device.product.empty() ? "" : " " + device.product);
+        };
+        auto contains = [](const std::vector<UsbDevice>& list, const UsbDevice& device) {
+            return std::any_of(list.begin(), list.end(), [&](const UsbDevice& other) {
+                return other.name == device.name && other.id == device.id;
+            });
+        };
+        // 首次遍历不推送事件
+        if (scans > 0) {
+            for (const auto& device : updated) {
+                if (!contains(devices, device)) added.push_back(describe(device));
+            }
+            for (const auto& device : devices) {
+                if (!contains(updated, device)) removed.push_back(describe(device));
+            }
+        }
+        devices = std::move(updated);
+        scanned_ms = now_ms();
+        ++scans;
+    }
+    for (const auto& text : added) EventBus::publish("usb", "success", "USB 设备接入: " + text);
+    for (const auto& text : removed) EventBus::publish("usb", "warning", "USB 设备断开: " + text);
+}
+
+void UsbTopology::initialize() {
+    rescan();
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        Logger::info("USB 拓扑: " + std::to_string(devices.size()) + " 个设备");
+    }
+
+    uevent_fd = ::socket(AF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_KOBJECT_UEVENT);
+    sockaddr_nl address{};
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = 1;   // 内核广播组
+    if (uevent_fd < 0 || ::bind(uevent_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        hotplug_error = std::string("无法监听 uevent: ") + strerror(errno) + "，检测时重新遍历";
+        Logger::warning(hotplug_error);
+        if (uevent_fd >= 0) ::close(uevent_fd);
+        uevent_fd = -1;
+        return;
+    }
+    wakeup_fd = ::eventfd(0, EFD_CLOEXEC);
+    running = true;
+    hotplug_thread = std::thread(&UsbTopology::hotplug_loop);
+}
+
+void UsbTopology::shutdown() {
+    if (!running.exchange(false)) return;
+    uint64_t one = 1;
+    if (::write(wakeup_fd, &one, sizeof(one)) < 0) {
+        Logger::error("唤醒 USB 热插拔线程失败: " + std::string(strerror(errno)));
+    }
+    if (hotplug_thread.joinable()) {
+        hotplug_thread.join();
+    }
+    ::close(wakeup_fd);
+    ::close(uevent_fd);
+    wakeup_fd = -1;
+    uevent_fd = -1;
+}
+
+void UsbTopology::hotplug_loop() {
+    char buffer[UEVENT_BYTES];
+    int64_t rescan_at = -1;
+    while (running) {
+        const int timeout = rescan_at < 0 ? -1 : static_cast<int>(std::clamp<int64_t>(rescan_at - monotonic_ms(), 0, DEBOUNCE_MS));
+        pollfd fds[2] = {{uevent_fd, POLLIN, 0}, {wakeup_fd, POLLIN, 0}};
+        const int ready = ::poll(fds, 2, timeout);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            Logger::error("uevent poll 失败: " + std::string(strerror(errno)));
+            break;
+        }
+        if (fds[1].revents & POLLIN) break;
+        if (ready == 0) {
+            rescan();
+            rescan_at = -1;
+            continue;
+        }
+
+        // 消息为 "动作@路径\0KEY=VALUE\0..."，只关心 USB 与 V4L2 设备
+        for (;;) {
+            const ssize_t n = ::recv(uevent_fd, buffer, sizeof(buffer) - 1, 0);
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && errno == ENOBUFS) {
+                // 接收缓冲溢出，已有 uevent 丢失：无法知道丢了哪些设备，去抖后重新遍历
+                rescan_at = monotonic_ms() + DEBOUNCE_MS;
+                continue;
+            }
+            if (n <= 0) break;
+            buffer[n] = '\0';
+            for (const char* field = buffer; field < buffer + n; field += std::strlen(field) + 1) {
+                if (std::strcmp(field, "SUBSYSTEM=usb") == 0 || std::strcmp(field, "SUBSYSTEM=video4linux") == 0) {
+                    rescan_at = monotonic_ms() + DEBOUNCE_MS;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+SystemCheckResult UsbTopology::check() {
+    Logger::info("执行 USB 拓扑检测");
+
+    // 没有热插拔通知时缓存可能过期，每次检测重新遍历
+    if (!running) rescan();
+
+    YAML::Node config = ConfigManager::get_system_config();
+    const double warn_percent = config["usb_periodic_warn_percent"].as<double>(90.0);
+    const bool check_potential = config["usb_check_potential"].as<bool>(true);
+
+    std::lock_guard<std::mutex> lock(state_mutex);
+    struct RootPort {
+        std::string name;
+        double speed_mbps = 0.0;
+        double active = 0.0;
+        double potential = 0.0;
+        std::vector<std::string> members;
+        std::vector<std::string> videos;
+    };
+    std::map<std::string, RootPort> ports;
+    std::vector<std::string> errors;
+    std::vector<std::string> warnings;
+    size_t device_count = 0;
+
+    for (const auto& device : devices) {
+        if (device.root_port.empty()) continue;
+        ++device_count;
+        RootPort& port = ports[device.root_port];
+        port.name = device.root_port;
+        if (device.name == device.root_port) port.speed_mbps = device.speed_mbps;
+        port.members.push_back(device.name);
+        port.videos.insert(port.videos.end(), device.videos.begin(), device.videos.end());
+        for (const auto& iface : device.interfaces) {
+            int alt = 0;
+            double active = 0.0;
+            double maximum = 0.0;
+            interface_bandwidth(iface, alt, active, maximum);
+            port.active += active;
+            port.potential += maximum;
+        }
+        if (device.downgraded) {
+            warnings.push_back(device.name + (device.product.empty() ? "" : " (" + device.product + ")") +
+                               " 以 " + format_speed(device.speed_mbps) + " 枚举，设备支持 " +
+                               format_speed(device.supported_mbps));
+        }
+    }
+
+    nlohmann::json port_list = nlohmann::json::array();
+    for (const auto& entry : ports) {
+        const RootPort& port = entry.second;
+        const double budget = periodic_budget(port.speed_mbps);
+        const double active_percent = budget > 0.0 ? 100.0 * port.active / budget : 0.0;
+        const double potential_percent = budget > 0.0 ? 100.0 * port.potential / budget : 0.0;
+        std::string label = "根端口 " + port.name + " (" + format_speed(port.speed_mbps);
+        for (const auto& video : port.videos) label += ", " + video;
+        label += ")";
+        if (active_percent >= 100.0) {
+            errors.push_back(label + " 周期带宽已预留 " + format_rate(port.active) + "，超过上限 " + format_rate(budget));
+        } else if (active_percent >= warn_percent) {
+            warnings.push_back(label + " 周期带宽已预留 " + format_rate(port.active) + "，达到上限的 " +
+                               std::to_string(static_cast<int>(active_percent)) + "%");
+        } else if (check_potential && potential_percent > 100.0) {
+            warnings.push_back(label + " 全部接口满速时需 " + format_rate(port.potential) + "，超过上限 " +
+                               format_rate(budget));
+        }
+        port_list.push_back({
+            {"port", port.name},
+            {"speed_mbps", port.speed_mbps},
+            {"budget_bytes_s", budget},
+            {"active_bytes_s", port.active},
+            {"potential_bytes_s", port.potential},
+            {"active_percent", active_percent},
+            {"potential_percent", potential_percent},
+            {"devices", port.members},
+            {"videos", port.videos}
+        });
+    }
+
+    std::string status = "success";
+    std::ostringstream message;
+    if (devices.empty()) {
+        status = "warning";
+        message << "未发现 USB 设备";
+    } else {
+        message << device_count << " 个 USB 设备, " << ports.size() << " 个根端口在用";
+        if (!errors.empty()) status = "error";
+        else if (!warnings.empty()) status = "warning";
+        std::vector<std::string> problems = errors;
+        problems.insert(problems.end(), warnings.begin(), warnings.end());
+        if (!problems.empty()) {
+            message << ": ";
+            for (size_t i = 0; i < problems.size(); ++i) message << (i ? "; " : "") << problems[i];
+        }
+    }
+
+    nlohmann::json details = {
+        {"scanned_ms", scanned_ms},
+        {"scans", scans},
+        {"hotplug", running.load()},
+        {"root_ports", port_list},
+        {"tree", device_tree(devices, "")}
+    };
+    if (!hotplug_error.empty()) details["hotplug_error"] = hotplug_error;
+    return {status, message.str(), details.dump()};
+}
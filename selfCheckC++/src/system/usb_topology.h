@@ -0,0 +1,70 @@
+#ifndef USB_TOPOLOGY_H
+#define USB_TOPOLOGY_H
+
+#include "../types/common_types.h"
+#include "../utils/sysfs_reader.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 接口的一个备用设置及其周期性（等时/中断）端点需要预留的带宽
+struct UsbAltSetting {
+    int number = 0;
+    double bytes_per_s = 0.0;
+    int isochronous = 0;          // 等时端点个数
+};
+
+struct UsbInterface {
+    std::string name;             // sysfs 名称，如 "1-1.2:1.0"
+    int number = 0;
+    int class_code = -1;
+    std::string driver;
+    std::vector<UsbAltSetting> alts;
+    SysfsReader current_alt;      // bAlternateSetting：UVC 开始取流时切换，不产生 uevent，检测时重新读取
+};
+
+struct UsbDevice {
+    std::string name;             // "usb1" 为根集线器，"1-1.2" 为总线 1 根端口 1 下集线器端口 2 上的设备
+    std::string parent;
+    std::string root_port;        // 所属根端口，如 "1-1"；根集线器为空
+    int bus = 0;
+    double speed_mbps = 0.0;      // 实际枚举速率
+    double supported_mbps = 0.0;  // 按 bcdUSB 推断的设备能力
+    unsigned bcd_usb = 0;         // bcdUSB 按十进制乘 100，如 USB 3.2 为 320
+    std::string id;               // "vid:pid"
+    std::string product;
+    bool hub = false;
+    bool downgraded = false;      // 以低于设备能力的速率枚举
+    std::vector<UsbInterface> interfaces;
+    std::vector<std::string> videos;   // 该设备提供的 /dev/videoN
+};
+
+// USB 拓扑检测：遍历一次 /sys/bus/usb/devices 建立集线器、速率与接口的树，
+// 从 descriptors 原始描述符解析每个接口各备用设置下等时/中断端点的带宽，缓存结果；
+// 后台线程监听内核 uevent（NETLINK_KOBJECT_UEVENT），USB 或 video4linux 设备插拔后
+// 去抖重建并推送事件。检测时只重新读取各接口当前的备用设置，
+// 按根端口汇总已预留和最大可能的周期带宽，与该链路速率的周期传输上限比较，
+// 超额时报错或告警，同时报告以低于自身能力的速率枚举的设备（如 USB3 设备掉到 480M）
+class UsbTopology {
+public:
+    // 首次遍历并启动热插拔监听线程
+    static void initialize();
+
+    // 停止监听线程
+    static void shutdown();
+
+    // USB 检测：根端口周期带宽与降速设备
+    static SystemCheckResult check();
+
+    // 遍历 root（通常为 /sys/bus/usb/devices）建立设备列表，按名称排序
+    static std::vector<UsbDevice> scan(const std::string& root);
+
+    // 链路速率下周期传输可用的带宽（字节/秒）：高速（480M）为 80%，其余速率为 90%
+    static double periodic_budget(double speed_mbps);
+
+private:
+    static void hotplug_loop();
+    static void rescan();
+};
+
+#endif // USB_TOPOLOGY_H
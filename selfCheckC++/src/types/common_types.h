@@ -28,6 +28,7 @@ const std::string HTTP_NOT_FOUND =
 struct SystemCheckResult {
     std::string status;   // "success", "warning", "error"
     std::string message;  // 详细描述信息
+    std::string details = {};  // 可选的结构化数据（JSON对象），为空时不输出
 };
 
 #endif // COMMON_TYPES_H
\ No newline at end of file
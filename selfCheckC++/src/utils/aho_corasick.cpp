@@ -0,0 +1,85 @@
+#include "aho_corasick.h"
+#include <queue>
+
+namespace {
+
+inline uint8_t fold(uint8_t c) {
+    return static_cast<uint8_t>(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c);
+}
+
+} // namespace
+
+bool AhoCorasick::add(const std::string& pattern, size_t group) {
+    if (pattern.empty() || group >= MAX_GROUPS) return false;
+    patterns.push_back(pattern);
+    groups.push_back(group);
+    return true;
+}
+
+void AhoCorasick::build() {
+    // 字符类：大小写折叠后每个出现过的字节一个类，其余字节共用类 0
+    class_count = 1;
+    for (auto& entry : byte_class) entry = 0;
+    for (const auto& pattern : patterns) {
+        for (unsigned char c : pattern) {
+            const uint8_t folded = fold(c);
+            if (byte_class[folded] == 0) byte_class[folded] = static_cast<uint8_t>(class_count++);
+        }
+    }
+    for (int c = 'A'; c <= 'Z'; ++c) byte_class[c] = byte_class[c - 'A' + 'a'];
+
+    // 字典树：-1 表示没有该转移
+    transitions.assign(class_count, -1);
+    outputs.assign(1, 0);
+    for (size_t p = 0; p < patterns.size(); ++p) {
+        int32_t state = 0;
+        for (unsigned char c : patterns[p]) {
+            const size_t index = static_cast<size_t>(state) * class_count + byte_class[c];
+            if (transitions[index] < 0) {
+                transitions[index] = static_cast<int32_t>(outputs.size());
+                outputs.push_back(0);
+                transitions.resize(transitions.size() + class_count, -1);
+            }
+            state = transitions[index];
+        }
+        outputs[static_cast<size_t>(state)] |= uint64_t{1} << groups[p];
+    }
+
+    // 按层次遍历计算失配链接，同时把缺失的转移替换为失配状态的转移，得到完整 DFA
+    std::vector<int32_t> fail(outputs.size(), 0);
+    std::queue<int32_t> pending;
+    for (size_t c = 0; c < class_count; ++c) {
+        int32_t& next = transitions[c];
+        if (next < 0) {
+            next = 0;
+        } else {
+            pending.push(next);
+        }
+    }
+    while (!pending.empty()) {
+        const int32_t state = pending.front();
+        pending.pop();
+        outputs[static_cast<size_t>(state)] |= outputs[static_cast<size_t>(fail[state])];
+        for (size_t c = 0; c < class_count; ++c) {
+            int32_t& next = transitions[static_cast<size_t>(state) * class_count + c];
+            const int32_t fallback = transitions[static_cast<size_t>(fail[state]) * class_count + c];
+            if (next < 0) {
+                next = fallback;
+            } else {
+                fail[next] = fallback;
+                pending.push(next);
+            }
+        }
+    }
+}
+
+uint64_t AhoCorasick::scan(const char* text, size_t length) const {
+    if (outputs.empty()) return 0;
+    uint64_t found = 0;
+    size_t state = 0;
+    for (size_t i = 0; i < length; ++i) {
+        state = static_cast<size_t>(transitions[state * class_count + byte_class[static_cast<uint8_t>(text[i])]]);
+        found |= outputs[state];
+    }
+    return found;
+}
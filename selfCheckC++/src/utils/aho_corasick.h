@@ -0,0 +1,37 @@
+#ifndef AHO_CORASICK_H
+#define AHO_CORASICK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 多模式子串匹配（Aho-Corasick）。构建时把失配跳转展开成完整的 DFA，
+// 并把输入字节压缩成模式中出现过的字符类，扫描时每个字节只需一次查表；
+// 每个状态的输出合并为 64 位掩码，一遍扫描即可得到文本中出现的全部模式组。
+// 匹配不区分 ASCII 大小写。最多 MAX_GROUPS 个模式组，每组可包含多个模式串
+class AhoCorasick {
+public:
+    static constexpr size_t MAX_GROUPS = 64;
+
+    // 添加属于 group 的模式串，空串或 group 越界时忽略并返回 false
+    bool add(const std::string& pattern, size_t group);
+
+    // 添加完全部模式后构建 DFA
+    void build();
+
+    // 扫描文本，返回出现过的模式组掩码（第 i 位对应组 i）
+    uint64_t scan(const char* text, size_t length) const;
+
+    size_t state_count() const { return outputs.size(); }
+
+private:
+    std::vector<std::string> patterns;
+    std::vector<size_t> groups;
+    uint8_t byte_class[256] = {};      // 0 为未出现在任何模式中的字节
+    size_t class_count = 1;
+    std::vector<int32_t> transitions;  // state * class_count + class
+    std::vector<uint64_t> outputs;
+};
+
+#endif // AHO_CORASICK_H
@@ -0,0 +1,37 @@
+#ifndef BYTE_RING_H
+#define BYTE_RING_H
+
+#include <cstddef>
+#include <cstdint>
+
+// 单线程字节环形缓冲区，容量为 2 的幂。
+// read() 直接写入 write_span() 返回的空闲区域，解析方按下标 peek 原地读取，
+// 处理完再 consume，数据从内核到解析全程不做额外拷贝
+template <size_t N>
+class ByteRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "ByteRing 容量必须是 2 的幂");
+
+public:
+    size_t size() const { return static_cast<size_t>(tail - head); }
+    size_t free_space() const { return N - size(); }
+    static constexpr size_t capacity() { return N; }
+
+    // 从 tail 开始的连续空闲区域（到达数组末尾时截断，下一次调用返回开头部分）
+    uint8_t* write_span(size_t& length) {
+        const size_t offset = static_cast<size_t>(tail) & (N - 1);
+        length = free_space() < N - offset ? free_space() : N - offset;
+        return data + offset;
+    }
+    void commit(size_t length) { tail += length; }
+
+    // 第 index 个未消费的字节，调用方保证 index < size()
+    uint8_t peek(size_t index) const { return data[static_cast<size_t>(head + index) & (N - 1)]; }
+    void consume(size_t length) { head += length; }
+
+private:
+    uint8_t data[N];
+    uint64_t head = 0;
+    uint64_t tail = 0;
+};
+
+#endif // BYTE_RING_H
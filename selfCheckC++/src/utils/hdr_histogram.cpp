@@ -0,0 +1,67 @@
+#include "hdr_histogram.h"
+#include <algorithm>
+#include <cmath>
+
+HdrHistogram::HdrHistogram(uint64_t highest_value, int significant_digits)
+    : highest(std::max<uint64_t>(highest_value, 2)) {
+    significant_digits = std::clamp(significant_digits, 1, 5);
+    // 桶内细分数取能表示 2 * 10^digits 的最小 2 的幂，保证相对误差
+    const double largest_single_unit = 2.0 * std::pow(10.0, significant_digits);
+    const int sub_bucket_magnitude = static_cast<int>(std::ceil(std::log2(largest_single_unit)));
+    sub_bucket_half_magnitude = sub_bucket_magnitude - 1;
+    sub_bucket_half_count = uint64_t{1} << sub_bucket_half_magnitude;
+    sub_bucket_mask = (uint64_t{1} << sub_bucket_magnitude) - 1;
+
+    size_t buckets = 1;
+    for (uint64_t untrackable = uint64_t{1} << sub_bucket_magnitude; untrackable <= highest; untrackable <<= 1) {
+        ++buckets;
+        if (untrackable > UINT64_MAX / 2) break;
+    }
+    counts.assign((buckets + 1) * sub_bucket_half_count, 0);
+}
+
+size_t HdrHistogram::index_of(uint64_t value) const {
+    const int bucket = 64 - __builtin_clzll(value | sub_bucket_mask) - (sub_bucket_half_magnitude + 1);
+    const uint64_t sub_bucket = value >> bucket;
+    return static_cast<size_t>((static_cast<uint64_t>(bucket + 1) << sub_bucket_half_magnitude) +
+                               (sub_bucket - sub_bucket_half_count));
+}
+
+uint64_t HdrHistogram::highest_equivalent(size_t index) const {
+    int bucket = static_cast<int>(index >> sub_bucket_half_magnitude) - 1;
+    uint64_t sub_bucket = (index & (sub_bucket_half_count - 1)) + sub_bucket_half_count;
+    if (bucket < 0) {
+        bucket = 0;
+        sub_bucket -= sub_bucket_half_count;
+    }
+    return (sub_bucket << bucket) + (uint64_t{1} << bucket) - 1;
+}
+
+void HdrHistogram::record(uint64_t value) {
+    ++counts[index_of(std::min(value, highest))];
+    ++total;
+    sum += value;
+    minimum = std::min(minimum, value);
+    maximum = std::max(maximum, value);
+}
+
+void HdrHistogram::merge(const HdrHistogram& other) {
+    const size_t length = std::min(counts.size(), other.counts.size());
+    for (size_t i = 0; i < length; ++i) counts[i] += other.counts[i];
+    total += other.total;
+    sum += other.sum;
+    minimum = std::min(minimum, other.minimum);
+    maximum = std::max(maximum, other.maximum);
+}
+
+uint64_t HdrHistogram::percentile(double percent) const {
+    if (total == 0) return 0;
+    const double clamped = std::clamp(percent, 0.0, 100.0);
+    const uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(clamped / 100.0 * total)));
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        cumulative += counts[i];
+        if (cumulative >= target) return std::min(highest_equivalent(i), maximum);
+    }
+    return maximum;
+}
@@ -0,0 +1,44 @@
+#ifndef HDR_HISTOGRAM_H
+#define HDR_HISTOGRAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// HDR 直方图：在 [1, highest] 范围内以固定的有效数字精度记录整数值。
+// 计数数组按 2 的幂分桶、桶内线性细分，记录一次只需一次 clz 与一次加法，
+// 不做堆分配，适合在测量线程的热循环中使用；分位数的误差不超过 10^-significant_digits。
+// 超过 highest 的值按 highest 计数，但 max() 保留真实最大值
+class HdrHistogram {
+public:
+    HdrHistogram(uint64_t highest, int significant_digits);
+
+    void record(uint64_t value);
+
+    // 合并另一个参数相同的直方图
+    void merge(const HdrHistogram& other);
+
+    uint64_t count() const { return total; }
+    uint64_t min() const { return total > 0 ? minimum : 0; }
+    uint64_t max() const { return maximum; }
+    double mean() const { return total > 0 ? static_cast<double>(sum) / total : 0.0; }
+
+    // 分位数（0-100），返回所在区间的上界
+    uint64_t percentile(double percent) const;
+
+private:
+    size_t index_of(uint64_t value) const;
+    uint64_t highest_equivalent(size_t index) const;
+
+    uint64_t highest;
+    int sub_bucket_half_magnitude;
+    uint64_t sub_bucket_half_count;
+    uint64_t sub_bucket_mask;
+    std::vector<uint64_t> counts;
+    uint64_t total = 0;
+    uint64_t sum = 0;
+    uint64_t minimum = UINT64_MAX;
+    uint64_t maximum = 0;
+};
+
+#endif // HDR_HISTOGRAM_H
@@ -0,0 +1,281 @@
+#include "link_framer.h"
+#include <algorithm>
+#include <array>
+
+namespace {
+
+// 符合 NMEA 0183 的语句最长 82 字节，厂商私有语句（$P...）常略长，超出即视为截断
+constexpr size_t MAX_NMEA_BYTES = 128;
+
+constexpr uint8_t MAVLINK_V1_STX = 0xFE;
+constexpr uint8_t MAVLINK_V2_STX = 0xFD;
+constexpr uint8_t MAVLINK_IFLAG_SIGNED = 0x01;
+constexpr size_t MAVLINK_SIGNATURE_BYTES = 13;
+
+// CRC-16/MCRF4XX：反射多项式 0x8408，编译期生成查找表
+constexpr std::array<uint16_t, 256> make_crc_table() {
+    std::array<uint16_t, 256> table{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint16_t crc = static_cast<uint16_t>(i);
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? static_cast<uint16_t>((crc >> 1) ^ 0x8408) : static_cast<uint16_t>(crc >> 1);
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+constexpr std::array<uint16_t, 256> CRC_TABLE = make_crc_table();
+
+inline uint16_t crc_step(uint16_t crc, uint8_t byte) {
+    return static_cast<uint16_t>((crc >> 8) ^ CRC_TABLE[(crc ^ byte) & 0xFF]);
+}
+
+struct MavlinkMessage {
+    uint32_t id;
+    uint8_t crc_extra;
+    const char* name;
+};
+
+// common.xml 中飞控常发的消息，按 ID 升序；其他消息可通过 set_crc_extra 补充
+constexpr MavlinkMessage MAVLINK_MESSAGES[] = {
+    {0, 50, "HEARTBEAT"},
+    {1, 124, "SYS_STATUS"},
+    {2, 137, "SYSTEM_TIME"},
+    {4, 237, "PING"},
+    {11, 89, "SET_MODE"},
+    {20, 214, "PARAM_REQUEST_READ"},
+    {21, 159, "PARAM_REQUEST_LIST"},
+    {22, 220, "PARAM_VALUE"},
+    {23, 168, "PARAM_SET"},
+    {24, 24, "GPS_RAW_INT"},
+    {25, 23, "GPS_STATUS"},
+    {26, 170, "SCALED_IMU"},
+    {27, 144, "RAW_IMU"},
+    {29, 115, "SCALED_PRESSURE"},
+    {30, 39, "ATTITUDE"},
+    {31, 246, "ATTITUDE_QUATERNION"},
+    {32, 185, "LOCAL_POSITION_NED"},
+    {33, 104, "GLOBAL_POSITION_INT"},
+    {35, 244, "RC_CHANNELS_RAW"},
+    {36, 222, "SERVO_OUTPUT_RAW"},
+    {42, 28, "MISSION_CURRENT"},
+    {44, 221, "MISSION_COUNT"},
+    {62, 183, "NAV_CONTROLLER_OUTPUT"},
+    {65, 118, "RC_CHANNELS"},
+    {66, 148, "REQUEST_DATA_STREAM"},
+    {69, 243, "MANUAL_CONTROL"},
+    {73, 38, "MISSION_ITEM_INT"},
+    {74, 20, "VFR_HUD"},
+    {76, 152, "COMMAND_LONG"},
+    {77, 143, "COMMAND_ACK"},
+    {83, 22, "ATTITUDE_TARGET"},
+    {85, 140, "POSITION_TARGET_LOCAL_NED"},
+    {87, 150, "POSITION_TARGET_GLOBAL_INT"},
+    {105, 93, "HIGHRES_IMU"},
+    {109, 185, "RADIO_STATUS"},
+    {111, 34, "TIMESYNC"},
+    {116, 76, "SCALED_IMU2"},
+    {125, 203, "POWER_STATUS"},
+    {132, 85, "DISTANCE_SENSOR"},
+    {141, 47, "ALTITUDE"},
+    {147, 154, "BATTERY_STATUS"},
+    {148, 178, "AUTOPILOT_VERSION"},
+    {230, 163, "ESTIMATOR_STATUS"},
+    {241, 90, "VIBRATION"},
+    {242, 104, "HOME_POSITION"},
+    {245, 130, "EXTENDED_SYS_STATE"},
+    {253, 83, "STATUSTEXT"},
+};
+
+const MavlinkMessage* find_message(uint32_t id) {
+    const auto end = std::end(MAVLINK_MESSAGES);
+    const auto found = std::lower_bound(std::begin(MAVLINK_MESSAGES), end, id,
+                                        [](const MavlinkMessage& message, uint32_t key) { return message.id < key; });
+    return found != end && found->id == id ? found : nullptr;
+}
+
+int hex_value(uint8_t c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+} // namespace
+
+uint16_t LinkFramer::crc16(const uint8_t* data, size_t length, uint16_t crc) {
+    for (size_t i = 0; i < length; ++i) crc = crc_step(crc, data[i]);
+    return crc;
+}
+
+const char* LinkFramer::mavlink_name(uint32_t message_id) {
+    const MavlinkMessage* message = find_message(message_id);
+    return message ? message->name : nullptr;
+}
+
+std::string LinkFramer::nmea_name(uint64_t key) {
+    std::string name;
+    for (; key != 0; key >>= 8) name.insert(name.begin(), static_cast<char>(key & 0xFF));
+    return name;
+}
+
+bool LinkFramer::lookup_crc_extra(uint32_t message_id, uint8_t& extra) const {
+    auto override_it = extra_overrides.find(message_id);
+    if (override_it != extra_overrides.end()) {
+        extra = override_it->second;
+        return true;
+    }
+    const MavlinkMessage* message = find_message(message_id);
+    if (!message) return false;
+    extra = message->crc_extra;
+    return true;
+}
+
+void LinkFramer::skip(size_t length) {
+    counters.skipped_bytes += length;
+    ring.consume(length);
+    nmea_scanned = 0;
+}
+
+void LinkFramer::commit(size_t length) {
+    ring.commit(length);
+    counters.bytes += length;
+    while (ring.size() > 0) {
+        const uint8_t start = ring.peek(0);
+        bool framed;
+        if (start == '$') {
+            framed = parse_nmea();
+        } else if (start == MAVLINK_V1_STX || start == MAVLINK_V2_STX) {
+            framed = parse_mavlink();
+        } else {
+            skip(1);
+            continue;
+        }
+        if (!framed) break;
+    }
+}
+
+bool LinkFramer::parse_nmea() {
+    // 从上次扫描到的位置继续查找换行，避免每次提交都重扫整条语句
+    const size_t available = std::min(ring.size(), MAX_NMEA_BYTES);
+    size_t newline = 0;
+    for (size_t i = std::max<size_t>(1, nmea_scanned); i < available; ++i) {
+        const uint8_t c = ring.peek(i);
+        if (c == '\n') {
+            newline = i;
+            break;
+        }
+        // 语句中途出现新的起始符或非文本字节：前一条语句被截断
+        if (c == '$' || c == MAVLINK_V1_STX || c == MAVLINK_V2_STX || (c < 0x20 && c != '\r') || c > 0x7E) {
+            ++counters.nmea_bad;
+            skip(i);
+            return true;
+        }
+    }
+    if (newline == 0) {
+        if (available < MAX_NMEA_BYTES) {
+            nmea_scanned = available;
+            return false;
+        }
+        ++counters.nmea_bad;
+        skip(MAX_NMEA_BYTES);
+        return true;
+    }
+
+    const size_t end = ring.peek(newline - 1) == '\r' ? newline - 1 : newline;
+    uint8_t checksum = 0;
+    uint64_t address = 0;
+    bool in_address = true;
+    size_t star = 0;
+    for (size_t i = 1; i < end; ++i) {
+        const uint8_t c = ring.peek(i);
+        if (c == '*') {
+            star = i;
+            break;
+        }
+        checksum ^= c;
+        if (c == ',') in_address = false;
+        if (in_address && (address >> 56) == 0) address = address << 8 | c;
+    }
+
+    bool valid = true;
+    if (star == 0) {
+        ++counters.nmea_unchecked;
+    } else {
+        const int high = star + 2 < end ? hex_value(ring.peek(star + 1)) : -1;
+        const int low = star + 2 < end ? hex_value(ring.peek(star + 2)) : -1;
+        valid = high >= 0 && low >= 0 && (high << 4 | low) == checksum;
+    }
+    if (!valid) {
+        ++counters.nmea_bad;
+        skip(newline + 1);
+        return true;
+    }
+    if (star != 0) ++counters.nmea_ok;
+    ++counters.nmea_types[address];
+    ring.consume(newline + 1);
+    nmea_scanned = 0;
+    return true;
+}
+
+bool LinkFramer::parse_mavlink() {
+    const bool v2 = ring.peek(0) == MAVLINK_V2_STX;
+    const size_t header = v2 ? 10 : 6;
+    if (ring.size() < 3) return false;
+    const size_t payload = ring.peek(1);
+    size_t total = header + payload + 2;
+    if (v2 && (ring.peek(2) & MAVLINK_IFLAG_SIGNED)) total += MAVLINK_SIGNATURE_BYTES;
+    if (ring.size() < total) return false;
+
+    const uint32_t message_id = v2 ? (ring.peek(7) | ring.peek(8) << 8 | static_cast<uint32_t>(ring.peek(9)) << 16)
+                                   : ring.peek(5);
+    uint8_t extra = 0;
+    if (!lookup_crc_extra(message_id, extra)) {
+        // 无法校验的帧只在按长度推算的帧尾紧接着下一个起始符时接受，
+        // 否则多半是噪声中的伪起始符，丢弃起始字节后重新同步
+        if (ring.size() < total + 1) return false;
+        const uint8_t next = ring.peek(total);
+        if (next != MAVLINK_V1_STX && next != MAVLINK_V2_STX) {
+            skip(1);
+            return true;
+        }
+        ++counters.mavlink_unchecked;
+        ++(v2 ? counters.mavlink_v2 : counters.mavlink_v1);
+        ++counters.mavlink_types[message_id];
+        track_sequence(v2);
+        ring.consume(total);
+        return true;
+    }
+
+    // 校验范围为起始符之后到负载结束，再累加 CRC_EXTRA；帧内字节通过 peek 原地读取
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 1; i < header + payload; ++i) crc = crc_step(crc, ring.peek(i));
+    crc = crc_step(crc, extra);
+    const uint16_t received = static_cast<uint16_t>(ring.peek(header + payload) | ring.peek(header + payload + 1) << 8);
+    if (crc != received) {
+        // 可能是负载中的伪起始符，只丢弃起始字节后重新同步
+        ++counters.mavlink_bad;
+        skip(1);
+        return true;
+    }
+
+    ++counters.mavlink_ok;
+    ++(v2 ? counters.mavlink_v2 : counters.mavlink_v1);
+    ++counters.mavlink_types[message_id];
+    track_sequence(v2);
+    ring.consume(total);
+    return true;
+}
+
+void LinkFramer::track_sequence(bool v2) {
+    const uint8_t sequence = ring.peek(v2 ? 4 : 2);
+    const uint16_t source = static_cast<uint16_t>(ring.peek(v2 ? 5 : 3) << 8 | ring.peek(v2 ? 6 : 4));
+    auto last = last_sequence.find(source);
+    if (last != last_sequence.end()) {
+        counters.mavlink_lost += static_cast<uint8_t>(sequence - last->second - 1);
+        last->second = sequence;
+    } else {
+        last_sequence.emplace(source, sequence);
+    }
+}
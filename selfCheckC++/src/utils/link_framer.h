@@ -0,0 +1,71 @@
+#ifndef LINK_FRAMER_H
+#define LINK_FRAMER_H
+
+#include "byte_ring.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+// 串口数据流的分帧统计
+struct LinkStats {
+    uint64_t bytes = 0;
+    uint64_t skipped_bytes = 0;          // 不属于任何有效帧的字节（噪声、截断或校验失败的帧）
+    uint64_t nmea_ok = 0;
+    uint64_t nmea_bad = 0;               // 校验和错误或被截断的语句
+    uint64_t nmea_unchecked = 0;         // 不带 *hh 校验和的语句
+    uint64_t mavlink_ok = 0;
+    uint64_t mavlink_bad = 0;            // CRC 错误
+    uint64_t mavlink_unchecked = 0;      // 消息 ID 不在 CRC_EXTRA 表中，无法校验（帧尾须紧跟下一个起始符）
+    uint64_t mavlink_v1 = 0;             // 按协议版本统计接受的帧（含无法校验的帧）
+    uint64_t mavlink_v2 = 0;
+    uint64_t mavlink_lost = 0;           // 按 (sysid, compid) 的序号间隙估计的丢包数
+    std::unordered_map<uint64_t, uint64_t> nmea_types;      // 按语句地址（如 GPGGA）计数
+    std::unordered_map<uint32_t, uint64_t> mavlink_types;   // 按消息 ID 计数
+};
+
+// NMEA 0183 语句与 MAVLink v1/v2 报文的增量分帧器。
+// 数据由 read() 直接写入内部环形缓冲区，每次 commit 后原地解析完整的帧，
+// 不完整的帧留在缓冲区等待后续字节；NMEA 校验 XOR 校验和，MAVLink 以查表法计算
+// CRC-16/MCRF4XX 并累加消息的 CRC_EXTRA。解析过程不做堆分配（新类型首次出现时除外）
+class LinkFramer {
+public:
+    static constexpr size_t RING_BYTES = 8192;
+
+    // 供 read() 直接写入的连续空闲区域
+    uint8_t* write_span(size_t& length) { return ring.write_span(length); }
+
+    // 提交写入的字节并解析其中的完整帧
+    void commit(size_t length);
+
+    const LinkStats& stats() const { return counters; }
+
+    // 补充或覆盖内置表中某个消息的 CRC_EXTRA（自定义方言）
+    void set_crc_extra(uint32_t message_id, uint8_t extra) { extra_overrides[message_id] = extra; }
+
+    // CRC-16/MCRF4XX（MAVLink 使用的 X.25 变体），查表实现
+    static uint16_t crc16(const uint8_t* data, size_t length, uint16_t crc = 0xFFFF);
+
+    // 常用 MAVLink 消息名称，未知 ID 返回 nullptr
+    static const char* mavlink_name(uint32_t message_id);
+
+    // nmea_types 的键还原为语句地址
+    static std::string nmea_name(uint64_t key);
+
+private:
+    // 以下解析函数在帧完整时消费字节并返回 true，需要更多数据时返回 false
+    bool parse_nmea();
+    bool parse_mavlink();
+    bool lookup_crc_extra(uint32_t message_id, uint8_t& extra) const;
+    void skip(size_t length);
+    // 按 (sysid, compid) 的序号间隙累计丢包，帧头位于环形缓冲区开头
+    void track_sequence(bool v2);
+
+    ByteRing<RING_BYTES> ring;
+    LinkStats counters;
+    size_t nmea_scanned = 0;   // 当前 NMEA 候选语句中已确认不含换行的字节数
+    std::unordered_map<uint32_t, uint8_t> extra_overrides;
+    std::unordered_map<uint16_t, uint8_t> last_sequence;   // 键为 sysid << 8 | compid
+};
+
+#endif // LINK_FRAMER_H
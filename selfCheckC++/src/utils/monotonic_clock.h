@@ -0,0 +1,24 @@
+#ifndef MONOTONIC_CLOCK_H
+#define MONOTONIC_CLOCK_H
+
+#include <chrono>
+#include <cstdint>
+
+// 单调时钟读数（Linux 上即 CLOCK_MONOTONIC），用于采样间隔、去抖与截止时间。
+// 不受 NTP/GPS 校时影响；需要展示给用户的时间戳仍使用 system_clock
+inline int64_t monotonic_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+inline int64_t monotonic_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+inline int64_t monotonic_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#endif // MONOTONIC_CLOCK_H
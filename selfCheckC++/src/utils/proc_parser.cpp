@@ -0,0 +1,251 @@
+#include "proc_parser.h"
+#include <charconv>
+
+namespace proc {
+
+bool TokenScanner::next_u64(uint64_t& value) {
+    std::string_view token;
+    return next(token) && parse_u64(token, value);
+}
+
+bool parse_u64(std::string_view text, uint64_t& value) {
+    const char* begin = text.data();
+    const char* end = begin + text.size();
+    while (begin < end && (*begin == ' ' || *begin == '\t')) ++begin;
+    auto [ptr, ec] = std::from_chars(begin, end, value);
+    return ec == std::errc() && ptr != begin;
+}
+
+namespace {
+
+constexpr PerfectKeyMap<11> MEMINFO_KEYS({
+    "MemTotal", "MemFree", "MemAvailable", "Buffers", "Cached", "SwapCached",
+    "SwapTotal", "SwapFree", "Shmem", "CmaTotal", "CmaFree"
+});
+static_assert(MEMINFO_KEYS.valid(), "meminfo 完美哈希种子搜索失败");
+
+constexpr std::array<uint64_t MemInfo::*, 11> MEMINFO_MEMBERS = {
+    &MemInfo::mem_total, &MemInfo::mem_free, &MemInfo::mem_available, &MemInfo::buffers,
+    &MemInfo::cached, &MemInfo::swap_cached, &MemInfo::swap_total, &MemInfo::swap_free,
+    &MemInfo::shmem, &MemInfo::cma_total, &MemInfo::cma_free
+};
+
+// 解析 "12.34" 形式的非负小数；不依赖浮点 from_chars（GCC 11 之前不支持）
+bool parse_decimal(std::string_view text, double& value) {
+    size_t dot = text.find('.');
+    uint64_t integer = 0;
+    if (!parse_u64(text.substr(0, dot), integer)) return false;
+    value = static_cast<double>(integer);
+    if (dot == std::string_view::npos) return true;
+
+    std::string_view fraction = text.substr(dot + 1);
+    uint64_t digits = 0;
+    if (fraction.empty() || !parse_u64(fraction, digits)) return true;
+    double scale = 1.0;
+    for (size_t i = 0; i < fraction.size(); ++i) scale *= 10.0;
+    value += static_cast<double>(digits) / scale;
+    return true;
+}
+
+} // namespace
+
+bool parse_meminfo(std::string_view text, MemInfo& info) {
+    info = MemInfo();
+    parse_key_values(text, MEMINFO_KEYS, MEMINFO_MEMBERS, info);
+    return info.mem_total > 0;
+}
+
+bool parse_trans_stat(std::string_view text, DevfreqTransStat& stat) {
+    stat.state_count = 0;
+    stat.current = -1;
+    stat.total_transitions = 0;
+
+    // 行格式: "*  800000000:   0   3 ...   1234"，末列为驻留时间(ms)；
+    // 表头行以 "From" 或 ":" 开头，末行为 "Total transition : N"
+    LineScanner lines(text);
+    std::string_view line;
+    while (lines.next(line)) {
+        TokenScanner tokens(line);
+        std::string_view first;
+        if (!tokens.next(first)) continue;
+
+        std::string_view token = first;
+        std::string_view last = first;
+        while (tokens.next(token)) last = token;
+
+        if (first == "Total") {
+            parse_u64(last, stat.total_transitions);
+            continue;
+        }
+
+        bool current = false;
+        if (first.front() == '*') {
+            current = true;
+            first.remove_prefix(1);
+            // "*" 与频率之间可能有空格
+            if (first.empty()) {
+                TokenScanner again(line);
+                again.skip(1);
+                again.next(first);
+            }
+        }
+        if (first.empty() || first.back() != ':') continue;
+        first.remove_suffix(1);
+
+        uint64_t frequency = 0;
+        uint64_t time_ms = 0;
+        if (!parse_u64(first, frequency) || !parse_u64(last, time_ms)) continue;
+        if (stat.state_count >= DevfreqTransStat::MAX_STATES) break;
+
+        if (current) stat.current = static_cast<int>(stat.state_count);
+        stat.frequency_hz[stat.state_count] = frequency;
+        stat.time_ms[stat.state_count] = time_ms;
+        ++stat.state_count;
+    }
+    return stat.state_count > 0;
+}
+
+bool parse_psi(std::string_view text, PsiInfo& info) {
+    info = PsiInfo();
+    bool has_some = false;
+
+    // 行格式: "some avg10=0.00 avg60=0.00 avg300=0.00 total=0"
+    LineScanner lines(text);
+    std::string_view line;
+    while (lines.next(line)) {
+        TokenScanner tokens(line);
+        std::string_view kind;
+        if (!tokens.next(kind)) continue;
+
+        PsiLine* target = nullptr;
+        if (kind == "some") {
+            target = &info.some;
+            has_some = true;
+        } else if (kind == "full") {
+            target = &info.full;
+            info.has_full = true;
+        } else {
+            continue;
+        }
+
+        std::string_view field;
+        while (tokens.next(field)) {
+            size_t eq = field.find('=');
+            if (eq == std::string_view::npos) continue;
+            std::string_view key = field.substr(0, eq);
+            std::string_view value = field.substr(eq + 1);
+            if (key == "avg10") parse_decimal(value, target->avg10);
+            else if (key == "avg60") parse_decimal(value, target->avg60);
+            else if (key == "avg300") parse_decimal(value, target->avg300);
+            else if (key == "total") parse_u64(value, target->total_us);
+        }
+    }
+    return has_some;
+}
+
+bool parse_pid_stat(std::string_view text, PidStat& stat) {
+    size_t open_paren = text.find('(');
+    size_t paren = text.rfind(')');
+    if (open_paren == std::string_view::npos || paren == std::string_view::npos || paren < open_paren) return false;
+    stat.comm = text.substr(open_paren + 1, paren - open_paren - 1);
+
+    // ')' 之后依次为 state(3) ppid(4) ... utime(14) stime(15) ... num_threads(20) itrealvalue(21)
+    // starttime(22) vsize(23) rss(24)
+    TokenScanner tokens(text.substr(paren + 1));
+    std::string_view state;
+    if (!tokens.next(state) || state.empty()) return false;
+    stat.state = state.front();
+    return tokens.skip(10) &&
+           tokens.next_u64(stat.utime) &&
+           tokens.next_u64(stat.stime) &&
+           tokens.skip(4) &&
+           tokens.next_u64(stat.num_threads) &&
+           tokens.skip(1) &&
+           tokens.next_u64(stat.starttime) &&
+           tokens.skip(1) &&
+           tokens.next_u64(stat.rss);
+}
+
+bool parse_pid_statm(std::string_view text, PidStatm& statm) {
+    TokenScanner tokens(text);
+    return tokens.next_u64(statm.size) &&
+           tokens.next_u64(statm.resident) &&
+           tokens.next_u64(statm.shared);
+}
+
+bool parse_schedstat(std::string_view text, SchedStat& stat) {
+    TokenScanner tokens(text);
+    return tokens.next_u64(stat.cpu_ns) &&
+           tokens.next_u64(stat.run_delay_ns) &&
+           tokens.next_u64(stat.timeslices);
+}
+
+bool find_diskstats(std::string_view text, std::string_view device, DiskStats& stats) {
+    // 行格式: "179  3 mmcblk0p3 reads reads_merged sectors_read read_ms writes ... weighted_ms [discard/flush 字段]"
+    LineScanner lines(text);
+    std::string_view line;
+    while (lines.next(line)) {
+        TokenScanner tokens(line);
+        std::string_view name;
+        if (!tokens.skip(2) || !tokens.next(name) || name != device) continue;
+        return tokens.next_u64(stats.reads) && tokens.next_u64(stats.reads_merged) &&
+               tokens.next_u64(stats.sectors_read) && tokens.next_u64(stats.read_ms) &&
+               tokens.next_u64(stats.writes) && tokens.next_u64(stats.writes_merged) &&
+               tokens.next_u64(stats.sectors_written) && tokens.next_u64(stats.write_ms) &&
+               tokens.next_u64(stats.in_flight) && tokens.next_u64(stats.io_ms) &&
+               tokens.next_u64(stats.weighted_ms);
+    }
+    return false;
+}
+
+bool parse_netdev_line(std::string_view line, std::string_view& name, NetDevStats& stats) {
+    const size_t colon = line.find(':');
+    if (colon == std::string_view::npos) return false;
+    name = line.substr(0, colon);
+    while (!name.empty() && (name.front() == ' ' || name.front() == '\t')) name.remove_prefix(1);
+    if (name.empty()) return false;
+
+    TokenScanner tokens(line.substr(colon + 1));
+    return tokens.next_u64(stats.rx_bytes) && tokens.next_u64(stats.rx_packets) &&
+           tokens.next_u64(stats.rx_errors) && tokens.next_u64(stats.rx_dropped) && tokens.skip(4) &&
+           tokens.next_u64(stats.tx_bytes) && tokens.next_u64(stats.tx_packets) &&
+           tokens.next_u64(stats.tx_errors) && tokens.next_u64(stats.tx_dropped);
+}
+
+size_t parse_cpu_columns(std::string_view header, int* cpu_ids, size_t capacity) {
+    size_t columns = 0;
+    TokenScanner tokens(header);
+    std::string_view token;
+    while (columns < capacity && tokens.next(token)) {
+        uint64_t cpu = 0;
+        if (token.size() <= 3 || token.compare(0, 3, "CPU") != 0 || !parse_u64(token.substr(3), cpu)) break;
+        cpu_ids[columns++] = static_cast<int>(cpu);
+    }
+    return columns;
+}
+
+std::vector<int> parse_cpu_list(std::string_view text) {
+    std::vector<int> cpus;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t end = text.find_first_of(", \t\r\n", pos);
+        if (end == std::string_view::npos) end = text.size();
+        std::string_view item = text.substr(pos, end - pos);
+        pos = end + 1;
+        if (item.empty()) continue;
+
+        size_t dash = item.find('-');
+        uint64_t first = 0;
+        uint64_t last = 0;
+        if (!parse_u64(item.substr(0, dash), first)) continue;
+        last = first;
+        if (dash != std::string_view::npos && !parse_u64(item.substr(dash + 1), last)) continue;
+        if (last < first || last - first > 4096) continue;
+        for (uint64_t cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+    }
+    return cpus;
+}
+
+} // namespace proc
@@ -0,0 +1,333 @@
+#ifndef PROC_PARSER_H
+#define PROC_PARSER_H
+
+#include "sysfs_reader.h"
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+// procfs/sysfs 零分配解析库：
+// 一次 pread 把整个文件读入固定缓冲区，再用行/字段扫描器在原地切分，
+// "Key: value" 格式通过编译期生成的完美哈希表定位结构体字段
+namespace proc {
+
+// 固定大小的文件缓冲区
+template <size_t N>
+struct FileBuffer {
+    char data[N];
+    size_t size = 0;
+
+    // 一次系统调用读取整个文件（超出 N 的部分被截断）
+    bool load(const SysfsReader& reader) {
+        ssize_t n = reader.read(data, N);
+        size = n > 0 ? static_cast<size_t>(n) : 0;
+        return n > 0;
+    }
+
+    std::string_view view() const { return std::string_view(data, size); }
+};
+
+// 逐行扫描；memchr 在 glibc 中有 SIMD 实现（aarch64 上为 NEON）
+class LineScanner {
+public:
+    explicit LineScanner(std::string_view text) : cursor(text.data()), end(text.data() + text.size()) {}
+
+    bool next(std::string_view& line) {
+        if (cursor >= end) return false;
+        const char* eol = static_cast<const char*>(std::memchr(cursor, '\n', static_cast<size_t>(end - cursor)));
+        const char* line_end = eol ? eol : end;
+        line = std::string_view(cursor, static_cast<size_t>(line_end - cursor));
+        cursor = eol ? eol + 1 : end;
+        return true;
+    }
+
+private:
+    const char* cursor;
+    const char* end;
+};
+
+// 按空白切分字段
+class TokenScanner {
+public:
+    explicit TokenScanner(std::string_view text) : cursor(text.data()), end(text.data() + text.size()) {}
+
+    bool next(std::string_view& token) {
+        while (cursor < end && (*cursor == ' ' || *cursor == '\t')) ++cursor;
+        if (cursor >= end) return false;
+        const char* start = cursor;
+        while (cursor < end && *cursor != ' ' && *cursor != '\t') ++cursor;
+        token = std::string_view(start, static_cast<size_t>(cursor - start));
+        return true;
+    }
+
+    bool next_u64(uint64_t& value);
+
+    // 跳过 count 个字段
+    bool skip(size_t count) {
+        std::string_view ignored;
+        for (size_t i = 0; i < count; ++i) {
+            if (!next(ignored)) return false;
+        }
+        return true;
+    }
+
+    // 尚未扫描的剩余部分
+    std::string_view rest() const { return std::string_view(cursor, static_cast<size_t>(end - cursor)); }
+
+private:
+    const char* cursor;
+    const char* end;
+};
+
+// 解析无符号十进制整数（允许前导空白）
+bool parse_u64(std::string_view text, uint64_t& value);
+
+// 带种子的 FNV-1a，用于构造完美哈希
+constexpr uint32_t hash_key(std::string_view key, uint32_t seed) {
+    uint32_t h = 2166136261u ^ seed;
+    for (char c : key) {
+        h ^= static_cast<uint8_t>(c);
+        h *= 16777619u;
+    }
+    return h ^ (h >> 15);
+}
+
+// 编译期完美哈希：构造时搜索一个使所有键互不冲突的种子，
+// 查找只需一次哈希与一次字符串比较
+template <size_t N>
+class PerfectKeyMap {
+public:
+    static constexpr size_t TABLE_SIZE = [] {
+        size_t size = 1;
+        while (size < N * 4) size <<= 1;
+        return size;
+    }();
+
+    constexpr explicit PerfectKeyMap(const std::array<std::string_view, N>& key_list) : keys(key_list) {
+        for (uint32_t candidate = 1; candidate < 100000; ++candidate) {
+            if (try_seed(candidate)) {
+                seed = candidate;
+                return;
+            }
+        }
+    }
+
+    // 返回键的下标，不存在返回 -1
+    constexpr int find(std::string_view key) const {
+        int index = slots[hash_key(key, seed) & (TABLE_SIZE - 1)];
+        return (index >= 0 && keys[static_cast<size_t>(index)] == key) ? index : -1;
+    }
+
+    constexpr bool valid() const { return seed != 0; }
+
+private:
+    constexpr bool try_seed(uint32_t candidate) {
+        for (auto& slot : slots) slot = -1;
+        for (size_t i = 0; i < N; ++i) {
+            size_t slot = hash_key(keys[i], candidate) & (TABLE_SIZE - 1);
+            if (slots[slot] != -1) return false;
+            slots[slot] = static_cast<int16_t>(i);
+        }
+        return true;
+    }
+
+    std::array<std::string_view, N> keys;
+    std::array<int16_t, TABLE_SIZE> slots{};
+    uint32_t seed = 0;
+};
+
+// 解析 "Key: value [unit]" 格式，把匹配的值写入 out 的对应成员，返回匹配的字段数
+template <typename T, size_t N>
+size_t parse_key_values(std::string_view text, const PerfectKeyMap<N>& keys,
+                        const std::array<uint64_t T::*, N>& members, T& out) {
+    size_t matched = 0;
+    LineScanner lines(text);
+    std::string_view line;
+    while (lines.next(line)) {
+        const char* colon = static_cast<const char*>(std::memchr(line.data(), ':', line.size()));
+        if (!colon) continue;
+        size_t key_len = static_cast<size_t>(colon - line.data());
+        int index = keys.find(line.substr(0, key_len));
+        if (index < 0) continue;
+        if (parse_u64(line.substr(key_len + 1), out.*members[static_cast<size_t>(index)])) {
+            ++matched;
+        }
+    }
+    return matched;
+}
+
+// /proc/meminfo 中关心的字段（单位 kB）
+struct MemInfo {
+    uint64_t mem_total = 0;
+    uint64_t mem_free = 0;
+    uint64_t mem_available = 0;
+    uint64_t buffers = 0;
+    uint64_t cached = 0;
+    uint64_t swap_cached = 0;
+    uint64_t swap_total = 0;
+    uint64_t swap_free = 0;
+    uint64_t shmem = 0;
+    uint64_t cma_total = 0;
+    uint64_t cma_free = 0;
+};
+
+// 解析 /proc/meminfo，返回是否至少解析到 MemTotal
+bool parse_meminfo(std::string_view text, MemInfo& info);
+
+// devfreq trans_stat：各频点的累计驻留时间与总切换次数
+struct DevfreqTransStat {
+    static constexpr size_t MAX_STATES = 32;
+
+    size_t state_count = 0;
+    uint64_t frequency_hz[MAX_STATES] = {};  // 与内核频率表顺序一致
+    uint64_t time_ms[MAX_STATES] = {};
+    int current = -1;                        // 带 '*' 标记的当前频点下标
+    uint64_t total_transitions = 0;
+};
+
+// 解析 devfreq trans_stat，返回是否至少解析到一个频点
+bool parse_trans_stat(std::string_view text, DevfreqTransStat& stat);
+
+// 解析 "0-3,6" 或 "4 5" 形式的 CPU 列表（sysfs cpulist 与配置文件通用，启动时使用）
+std::vector<int> parse_cpu_list(std::string_view text);
+
+// /proc/pressure/* 中的一行（some 或 full）
+struct PsiLine {
+    double avg10 = 0.0;    // 百分比
+    double avg60 = 0.0;
+    double avg300 = 0.0;
+    uint64_t total_us = 0; // 累计停顿时间
+};
+
+struct PsiInfo {
+    PsiLine some;
+    PsiLine full;
+    bool has_full = false; // 旧内核的 /proc/pressure/cpu 没有 full 行
+};
+
+// 解析 PSI 文件，返回是否解析到 some 行
+bool parse_psi(std::string_view text, PsiInfo& info);
+
+// /proc/<pid>/stat 中关心的字段（时间单位为时钟滴答）
+struct PidStat {
+    char state = '?';          // R/S/D/Z/T...
+    uint64_t utime = 0;        // 全部线程累计
+    uint64_t stime = 0;
+    uint64_t num_threads = 0;
+    uint64_t starttime = 0;    // 自开机起的启动时间，用于识别 PID 复用
+    uint64_t rss = 0;          // 常驻页数
+    std::string_view comm;     // 指向输入文本，不含括号
+};
+
+// 解析 /proc/<pid>/stat；comm 可能含空格与括号，从最后一个 ')' 之后开始计数
+bool parse_pid_stat(std::string_view text, PidStat& stat);
+
+// /proc/<pid>/statm（单位为页）
+struct PidStatm {
+    uint64_t size = 0;
+    uint64_t resident = 0;
+    uint64_t shared = 0;
+};
+
+bool parse_pid_statm(std::string_view text, PidStatm& statm);
+
+// /proc/<pid>/task/<tid>/schedstat：单个线程的运行时间、排队等待时间与被调度上 CPU 的次数
+struct SchedStat {
+    uint64_t cpu_ns = 0;
+    uint64_t run_delay_ns = 0;
+    uint64_t timeslices = 0;
+};
+
+bool parse_schedstat(std::string_view text, SchedStat& stat);
+
+// /proc/diskstats 中一个块设备的累计计数（扇区固定为 512 字节，时间单位 ms）
+struct DiskStats {
+    uint64_t reads = 0;
+    uint64_t reads_merged = 0;
+    uint64_t sectors_read = 0;
+    uint64_t read_ms = 0;
+    uint64_t writes = 0;
+    uint64_t writes_merged = 0;
+    uint64_t sectors_written = 0;
+    uint64_t write_ms = 0;
+    uint64_t in_flight = 0;
+    uint64_t io_ms = 0;        // 设备忙碌时间，用于计算利用率
+    uint64_t weighted_ms = 0;
+};
+
+// 在 /proc/diskstats 中查找名为 device 的行（如 "mmcblk0p3"）
+bool find_diskstats(std::string_view text, std::string_view device, DiskStats& stats);
+
+// /proc/net/dev 中一个网络接口的累计计数
+struct NetDevStats {
+    uint64_t rx_bytes = 0;
+    uint64_t rx_packets = 0;
+    uint64_t rx_errors = 0;
+    uint64_t rx_dropped = 0;
+    uint64_t tx_bytes = 0;
+    uint64_t tx_packets = 0;
+    uint64_t tx_errors = 0;
+    uint64_t tx_dropped = 0;
+};
+
+// 解析 /proc/net/dev 的一行 "  eth0: rx_bytes rx_packets errs drop fifo frame compressed multicast tx_bytes ..."，
+// 表头行返回 false。计数较大时接口名与冒号后的数字之间可能没有空格
+bool parse_netdev_line(std::string_view line, std::string_view& name, NetDevStats& stats);
+
+// /proc/interrupts 与 /proc/softirqs 的计数矩阵：首行为在线 CPU 的列名（离线 CPU 不出现），
+// 其余每行为 "标签: 各列计数 [描述]"。内核中计数为 unsigned int，会按 2^32 回绕
+constexpr size_t MAX_COUNTER_COLUMNS = 64;
+
+// 解析首行的 "CPU0 CPU1 ..."，把列对应的 CPU 编号写入 cpu_ids，返回列数
+size_t parse_cpu_columns(std::string_view header, int* cpu_ids, size_t capacity);
+
+// 判断字段是否全为数字
+inline bool is_digits(std::string_view token) {
+    if (token.empty()) return false;
+    for (char c : token) {
+        if (c < '0' || c > '9') return false;
+    }
+    return true;
+}
+
+// 逐行解析计数矩阵（跳过首行），对每行调用 fn(label, counts, count, description)。
+// counts 指向栈上缓冲区，仅在回调内有效；ERR/MIS 等行的列数可能少于 columns
+template <typename Fn>
+void for_each_counter_row(std::string_view text, size_t columns, Fn&& fn) {
+    LineScanner lines(text);
+    std::string_view line;
+    if (!lines.next(line)) return;
+
+    uint32_t counts[MAX_COUNTER_COLUMNS];
+    if (columns > MAX_COUNTER_COLUMNS) columns = MAX_COUNTER_COLUMNS;
+    while (lines.next(line)) {
+        const char* colon = static_cast<const char*>(std::memchr(line.data(), ':', line.size()));
+        if (!colon) continue;
+        const size_t label_end = static_cast<size_t>(colon - line.data());
+        std::string_view label = line.substr(0, label_end);
+        while (!label.empty() && (label.front() == ' ' || label.front() == '\t')) label.remove_prefix(1);
+
+        TokenScanner tokens(line.substr(label_end + 1));
+        size_t count = 0;
+        std::string_view description = tokens.rest();
+        std::string_view token;
+        while (count < columns) {
+            description = tokens.rest();
+            if (!tokens.next(token) || !is_digits(token)) break;
+            uint64_t value = 0;
+            parse_u64(token, value);
+            counts[count++] = static_cast<uint32_t>(value);
+            description = tokens.rest();
+        }
+        while (!description.empty() && (description.front() == ' ' || description.front() == '\t')) {
+            description.remove_prefix(1);
+        }
+        fn(label, counts, count, description);
+    }
+}
+
+} // namespace proc
+
+#endif // PROC_PARSER_H
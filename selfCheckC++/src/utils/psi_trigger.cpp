@@ -0,0 +1,33 @@
+#include "psi_trigger.h"
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+bool write_trigger(int fd, const std::string& trigger) {
+    // 内核要求连同结尾的 '\0' 一起写入
+    return ::write(fd, trigger.c_str(), trigger.size() + 1) >= 0;
+}
+
+} // namespace
+
+int open_psi_trigger(const std::string& path, long stall_us, long window_us, std::string& trigger) {
+    trigger = "some " + std::to_string(stall_us) + " " + std::to_string(window_us);
+    int fd = ::open(path.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    bool registered = write_trigger(fd, trigger);
+    if (!registered && errno == EINVAL && window_us % 2000000 != 0) {
+        const long relaxed_window = (window_us / 2000000 + 1) * 2000000;
+        trigger = "some " + std::to_string(stall_us * relaxed_window / window_us) + " " + std::to_string(relaxed_window);
+        registered = write_trigger(fd, trigger);
+    }
+    if (!registered) {
+        int saved_errno = errno;
+        ::close(fd);
+        errno = saved_errno;
+        return -1;
+    }
+    return fd;
+}
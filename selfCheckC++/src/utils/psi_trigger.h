@@ -0,0 +1,13 @@
+#ifndef PSI_TRIGGER_H
+#define PSI_TRIGGER_H
+
+#include <string>
+
+// 在 /proc/pressure/{cpu,io,memory} 上注册 PSI 触发器：
+// 窗口 window_us 内累计停顿超过 stall_us 时，返回的 fd 上出现 POLLPRI。
+// 没有 CAP_SYS_RESOURCE 时内核只接受 2 秒整数倍的窗口，此时按比例放大后重试。
+// 成功返回 fd（由调用方 close），失败返回 -1 并保留 errno；
+// trigger 输出实际写入的触发器描述，如 "some 150000 1000000"
+int open_psi_trigger(const std::string& path, long stall_us, long window_us, std::string& trigger);
+
+#endif // PSI_TRIGGER_H
@@ -0,0 +1,91 @@
+#include "serial_port.h"
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace {
+
+speed_t to_speed(int baud) {
+    switch (baud) {
+        case 9600: return B9600;
+        case 19200: return B19200;
+        case 38400: return B38400;
+        case 57600: return B57600;
+        case 115200: return B115200;
+        case 230400: return B230400;
+        case 460800: return B460800;
+        case 500000: return B500000;
+        case 576000: return B576000;
+        case 921600: return B921600;
+        case 1000000: return B1000000;
+        case 1500000: return B1500000;
+        case 2000000: return B2000000;
+        case 3000000: return B3000000;
+        case 4000000: return B4000000;
+        default: return B0;
+    }
+}
+
+} // namespace
+
+bool SerialPort::configure(int fd, int baud, std::string& error) {
+    termios tty{};
+    if (::tcgetattr(fd, &tty) != 0) {
+        error = std::string("读取串口属性失败: ") + strerror(errno);
+        return false;
+    }
+    const speed_t speed = to_speed(baud);
+    if (speed == B0) {
+        error = "不支持的波特率 " + std::to_string(baud);
+        return false;
+    }
+    ::cfmakeraw(&tty);
+    tty.c_cflag &= ~static_cast<tcflag_t>(PARENB | CSTOPB | CSIZE | CRTSCTS);
+    tty.c_cflag |= CS8 | CLOCAL | CREAD;
+    tty.c_iflag &= ~static_cast<tcflag_t>(IXON | IXOFF | IXANY);
+    tty.c_cc[VMIN] = 0;
+    tty.c_cc[VTIME] = 0;
+    ::cfsetispeed(&tty, speed);
+    ::cfsetospeed(&tty, speed);
+    if (::tcsetattr(fd, TCSANOW, &tty) != 0) {
+        error = std::string("设置串口属性失败: ") + strerror(errno);
+        return false;
+    }
+    ::tcflush(fd, TCIOFLUSH);
+    return true;
+}
+
+int SerialPort::find_user(const std::string& device) {
+    char resolved[PATH_MAX];
+    if (::realpath(device.c_str(), resolved) == nullptr) return -1;
+    const std::string target(resolved);
+    const int self = ::getpid();
+
+    DIR* proc = ::opendir("/proc");
+    if (!proc) return -1;
+    int user = -1;
+    while (dirent* entry = ::readdir(proc)) {
+        const int pid = std::atoi(entry->d_name);
+        if (pid <= 0 || pid == self) continue;
+        const std::string fd_dir = std::string("/proc/") + entry->d_name + "/fd";
+        DIR* fds = ::opendir(fd_dir.c_str());
+        if (!fds) continue;
+        while (dirent* fd = ::readdir(fds)) {
+            if (fd->d_name[0] == '.') continue;
+            char link[PATH_MAX];
+            const ssize_t n = ::readlinkat(::dirfd(fds), fd->d_name, link, sizeof(link) - 1);
+            if (n > 0 && static_cast<size_t>(n) == target.size() && target.compare(0, target.size(), link, n) == 0) {
+                user = pid;
+                break;
+            }
+        }
+        ::closedir(fds);
+        if (user > 0) break;
+    }
+    ::closedir(proc);
+    return user;
+}
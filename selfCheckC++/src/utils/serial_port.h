@@ -0,0 +1,16 @@
+#ifndef SERIAL_PORT_H
+#define SERIAL_PORT_H
+
+#include <string>
+
+// 串口公共操作：termios 配置与占用检测，供回环测试和数据流嗅探共用
+class SerialPort {
+public:
+    // 设置波特率、8N1、原始模式、无流控，并清空收发缓冲；失败返回 false 并填写 error
+    static bool configure(int fd, int baud, std::string& error);
+
+    // 遍历 /proc/<pid>/fd 查找打开了该设备的其他进程，返回进程号，未找到返回 -1
+    static int find_user(const std::string& device);
+};
+
+#endif // SERIAL_PORT_H
@@ -0,0 +1,268 @@
+#include "sha256.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#include <sys/auxv.h>
+#ifndef HWCAP_SHA2
+#define HWCAP_SHA2 (1 << 6)
+#endif
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+namespace {
+
+using CompressFn = void (*)(uint32_t* state, const uint8_t* blocks, size_t count);
+
+alignas(16) constexpr uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+constexpr uint32_t INITIAL_STATE[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+inline uint32_t rotr(uint32_t x, int n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+inline uint32_t load_be32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+void compress_portable(uint32_t* state, const uint8_t* blocks, size_t count) {
+    for (; count > 0; --count, blocks += 64) {
+        uint32_t w[64];
+        for (int i = 0; i < 16; ++i) w[i] = load_be32(blocks + 4 * i);
+        for (int i = 16; i < 64; ++i) {
+            const uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            const uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+        for (int i = 0; i < 64; ++i) {
+            const uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+            const uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+    }
+}
+
+#if defined(__aarch64__)
+
+#if defined(__clang__)
+#define SHA2_TARGET __attribute__((target("sha2")))
+#else
+#define SHA2_TARGET __attribute__((target("+crypto")))
+#endif
+
+// ARMv8 SHA2 扩展：每条 sha256h/sha256h2 完成 4 轮，消息扩展由 sha256su0/su1 完成
+SHA2_TARGET void compress_armv8(uint32_t* state, const uint8_t* blocks, size_t count) {
+    uint32x4_t abcd = vld1q_u32(state);
+    uint32x4_t efgh = vld1q_u32(state + 4);
+    for (; count > 0; --count, blocks += 64) {
+        const uint32x4_t abcd_save = abcd;
+        const uint32x4_t efgh_save = efgh;
+        uint32x4_t m[4];
+        for (int i = 0; i < 4; ++i) {
+            m[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(blocks + 16 * i)));
+        }
+#pragma GCC unroll 16
+        for (int i = 0; i < 16; ++i) {
+            const uint32x4_t wk = vaddq_u32(m[i & 3], vld1q_u32(K + 4 * i));
+            if (i < 12) {
+                m[i & 3] = vsha256su1q_u32(vsha256su0q_u32(m[i & 3], m[(i + 1) & 3]), m[(i + 2) & 3], m[(i + 3) & 3]);
+            }
+            const uint32x4_t abcd_prev = abcd;
+            abcd = vsha256hq_u32(abcd, efgh, wk);
+            efgh = vsha256h2q_u32(efgh, abcd_prev, wk);
+        }
+        abcd = vaddq_u32(abcd, abcd_save);
+        efgh = vaddq_u32(efgh, efgh_save);
+    }
+    vst1q_u32(state, abcd);
+    vst1q_u32(state + 4, efgh);
+}
+
+CompressFn detect() {
+    return (getauxval(AT_HWCAP) & HWCAP_SHA2) ? compress_armv8 : compress_portable;
+}
+
+const char* detected_name() {
+    return (getauxval(AT_HWCAP) & HWCAP_SHA2) ? "armv8-sha2" : "portable";
+}
+
+#elif defined(__x86_64__) || defined(__i386__)
+
+// SHA-NI：状态按 ABEF/CDGH 两个寄存器组织，sha256rnds2 每次完成 2 轮
+__attribute__((target("sha,sse4.1,ssse3")))
+void compress_shani(uint32_t* state, const uint8_t* blocks, size_t count) {
+    const __m128i byte_swap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0xB1);
+    __m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4)), 0x1B);
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);   // ABEF
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);         // CDGH
+
+    for (; count > 0; --count, blocks += 64) {
+        const __m128i abef_save = state0;
+        const __m128i cdgh_save = state1;
+        __m128i m[4];
+#pragma GCC unroll 16
+        for (int i = 0; i < 16; ++i) {
+            if (i < 4) {
+                m[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(blocks + 16 * i)), byte_swap);
+            } else {
+                __m128i w = _mm_sha256msg1_epu32(m[i & 3], m[(i + 1) & 3]);
+                w = _mm_add_epi32(w, _mm_alignr_epi8(m[(i + 3) & 3], m[(i + 2) & 3], 4));
+                m[i & 3] = _mm_sha256msg2_epu32(w, m[(i + 3) & 3]);
+            }
+            __m128i wk = _mm_add_epi32(m[i & 3], _mm_load_si128(reinterpret_cast<const __m128i*>(K + 4 * i)));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, wk);
+            wk = _mm_shuffle_epi32(wk, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, wk);
+        }
+        state0 = _mm_add_epi32(state0, abef_save);
+        state1 = _mm_add_epi32(state1, cdgh_save);
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1B);               // FEBA
+    state1 = _mm_shuffle_epi32(state1, 0xB1);            // DCHG
+    state0 = _mm_blend_epi16(tmp, state1, 0xF0);         // DCBA
+    state1 = _mm_alignr_epi8(state1, tmp, 8);            // HGFE
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), state0);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), state1);
+}
+
+bool has_shani() {
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_SSE4_1) || !(ecx & bit_SSSE3)) return false;
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) return false;
+    return (ebx & (1u << 29)) != 0;
+}
+
+CompressFn detect() {
+    return has_shani() ? compress_shani : compress_portable;
+}
+
+const char* detected_name() {
+    return has_shani() ? "sha-ni" : "portable";
+}
+
+#else
+
+CompressFn detect() {
+    return compress_portable;
+}
+
+const char* detected_name() {
+    return "portable";
+}
+
+#endif
+
+const CompressFn accelerated = detect();
+std::atomic<CompressFn> selected{accelerated};
+
+} // namespace
+
+Sha256::Sha256() {
+    std::memcpy(state, INITIAL_STATE, sizeof(state));
+}
+
+void Sha256::compress(const uint8_t* blocks, size_t count) {
+    selected.load(std::memory_order_relaxed)(state, blocks, count);
+}
+
+void Sha256::update(const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    total_bytes += size;
+    if (buffered > 0) {
+        const size_t take = std::min(size, sizeof(buffer) - buffered);
+        std::memcpy(buffer + buffered, bytes, take);
+        buffered += take;
+        bytes += take;
+        size -= take;
+        if (buffered < sizeof(buffer)) return;
+        compress(buffer, 1);
+        buffered = 0;
+    }
+    // 整块数据直接在原缓冲区（如 mmap 区域）上压缩，不做拷贝
+    const size_t blocks = size / 64;
+    if (blocks > 0) {
+        compress(bytes, blocks);
+        bytes += blocks * 64;
+        size -= blocks * 64;
+    }
+    if (size > 0) {
+        std::memcpy(buffer, bytes, size);
+        buffered = size;
+    }
+}
+
+Sha256::Digest Sha256::finish() {
+    const uint64_t bit_length = total_bytes * 8;
+    uint8_t padding[72] = {0x80};
+    const size_t pad = (buffered < 56 ? 56 - buffered : 120 - buffered);
+    for (int i = 0; i < 8; ++i) {
+        padding[pad + i] = static_cast<uint8_t>(bit_length >> (56 - 8 * i));
+    }
+    const uint64_t saved_total = total_bytes;
+    update(padding, pad + 8);
+    total_bytes = saved_total;
+
+    Digest digest;
+    for (int i = 0; i < 8; ++i) {
+        digest[4 * i] = static_cast<uint8_t>(state[i] >> 24);
+        digest[4 * i + 1] = static_cast<uint8_t>(state[i] >> 16);
+        digest[4 * i + 2] = static_cast<uint8_t>(state[i] >> 8);
+        digest[4 * i + 3] = static_cast<uint8_t>(state[i]);
+    }
+    return digest;
+}
+
+Sha256::Digest Sha256::hash(const void* data, size_t size) {
+    Sha256 sha;
+    sha.update(data, size);
+    return sha.finish();
+}
+
+std::string Sha256::to_hex(const Digest& digest) {
+    static const char HEX[] = "0123456789abcdef";
+    std::string text(digest.size() * 2, '0');
+    for (size_t i = 0; i < digest.size(); ++i) {
+        text[2 * i] = HEX[digest[i] >> 4];
+        text[2 * i + 1] = HEX[digest[i] & 0x0f];
+    }
+    return text;
+}
+
+const char* Sha256::implementation() {
+    return selected.load() == compress_portable ? "portable" : detected_name();
+}
+
+void Sha256::force_portable(bool enabled) {
+    selected.store(enabled ? compress_portable : accelerated);
+}
@@ -0,0 +1,41 @@
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// SHA-256（FIPS 180-4）增量计算。压缩函数在启动时按 CPU 能力选择：
+// aarch64 的 ARMv8 SHA2 指令（RK3588 的 A76/A55 均支持）、x86 的 SHA-NI，
+// 否则使用可移植实现
+class Sha256 {
+public:
+    using Digest = std::array<uint8_t, 32>;
+
+    Sha256();
+
+    void update(const void* data, size_t size);
+    Digest finish();
+
+    // 一次性计算
+    static Digest hash(const void* data, size_t size);
+
+    static std::string to_hex(const Digest& digest);
+
+    // 当前使用的压缩函数实现："armv8-sha2"、"sha-ni" 或 "portable"
+    static const char* implementation();
+
+    // 强制使用可移植实现（供基准测试对比硬件加速）
+    static void force_portable(bool enabled);
+
+private:
+    void compress(const uint8_t* blocks, size_t count);
+
+    uint32_t state[8];
+    uint8_t buffer[64];
+    size_t buffered = 0;
+    uint64_t total_bytes = 0;
+};
+
+#endif // SHA256_H
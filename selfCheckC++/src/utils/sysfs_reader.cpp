@@ -0,0 +1,79 @@
+#include "sysfs_reader.h"
+#include <cerrno>
+#include <charconv>
+#include <fcntl.h>
+#include <unistd.h>
+
+SysfsReader::SysfsReader(const std::vector<std::string>& candidates) {
+    open(candidates);
+}
+
+SysfsReader::~SysfsReader() {
+    close();
+}
+
+SysfsReader::SysfsReader(SysfsReader&& other) noexcept
+    : fd(other.fd), resolved_path(std::move(other.resolved_path)) {
+    other.fd = -1;
+}
+
+SysfsReader& SysfsReader::operator=(SysfsReader&& other) noexcept {
+    if (this != &other) {
+        close();
+        fd = other.fd;
+        resolved_path = std::move(other.resolved_path);
+        other.fd = -1;
+    }
+    return *this;
+}
+
+bool SysfsReader::open(const std::vector<std::string>& candidates) {
+    close();
+    for (const auto& candidate : candidates) {
+        int candidate_fd = ::open(candidate.c_str(), O_RDONLY | O_CLOEXEC);
+        if (candidate_fd < 0) continue;
+
+        // 部分 sysfs 属性可以打开但读取失败（如驱动未就绪），需要实际读一次确认
+        char probe[64];
+        if (::pread(candidate_fd, probe, sizeof(probe), 0) < 0) {
+            ::close(candidate_fd);
+            continue;
+        }
+
+        fd = candidate_fd;
+        resolved_path = candidate;
+        return true;
+    }
+    return false;
+}
+
+void SysfsReader::close() {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    resolved_path.clear();
+}
+
+ssize_t SysfsReader::read(char* buffer, size_t capacity) const {
+    if (fd < 0) return -1;
+    ssize_t n;
+    do {
+        n = ::pread(fd, buffer, capacity, 0);
+    } while (n < 0 && errno == EINTR);
+    return n;
+}
+
+bool SysfsReader::read_long(long& value) const {
+    char buffer[32];
+    ssize_t n = read(buffer, sizeof(buffer));
+    if (n <= 0) return false;
+
+    const char* begin = buffer;
+    const char* end = buffer + n;
+    while (begin < end && (*begin == ' ' || *begin == '\t' || *begin == '\n')) {
+        ++begin;
+    }
+    auto [ptr, ec] = std::from_chars(begin, end, value);
+    return ec == std::errc() && ptr != begin;
+}
@@ -0,0 +1,40 @@
+#ifndef SYSFS_READER_H
+#define SYSFS_READER_H
+
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+// sysfs/procfs 文件读取器：
+// 启动时从候选路径中解析出第一个可读文件并保持 fd 打开，
+// 之后每次采样只需一次 pread(fd, buf, n, 0)，不做任何堆分配
+class SysfsReader {
+public:
+    SysfsReader() = default;
+    explicit SysfsReader(const std::vector<std::string>& candidates);
+    ~SysfsReader();
+
+    SysfsReader(SysfsReader&& other) noexcept;
+    SysfsReader& operator=(SysfsReader&& other) noexcept;
+    SysfsReader(const SysfsReader&) = delete;
+    SysfsReader& operator=(const SysfsReader&) = delete;
+
+    // 依次尝试候选路径，打开第一个可成功读取的文件
+    bool open(const std::vector<std::string>& candidates);
+    void close();
+
+    bool is_open() const { return fd >= 0; }
+    const std::string& path() const { return resolved_path; }
+
+    // 从文件开头读取至多 capacity 字节，返回读取的字节数，失败返回 -1
+    ssize_t read(char* buffer, size_t capacity) const;
+
+    // 读取文件开头的十进制整数（忽略前导空白）
+    bool read_long(long& value) const;
+
+private:
+    int fd = -1;
+    std::string resolved_path;
+};
+
+#endif // SYSFS_READER_H
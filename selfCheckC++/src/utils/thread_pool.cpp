@@ -0,0 +1,60 @@
+#include "thread_pool.h"
+#include "logger.h"
+
+ThreadPool::ThreadPool(size_t worker_count, std::function<void()> on_thread_start)
+    : thread_start_hook(std::move(on_thread_start)) {
+    if (worker_count == 0) {
+        worker_count = 1;
+    }
+    workers.reserve(worker_count);
+    for (size_t i = 0; i < worker_count; ++i) {
+        workers.emplace_back(&ThreadPool::worker_loop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        stopping = true;
+    }
+    queue_cv.notify_all();
+    for (auto& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        tasks.push_back(std::move(task));
+    }
+    queue_cv.notify_one();
+}
+
+void ThreadPool::worker_loop() {
+    if (thread_start_hook) {
+        thread_start_hook();
+    }
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            queue_cv.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (stopping && tasks.empty()) {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+
+        try {
+            task();
+        } catch (const std::exception& e) {
+            Logger::error("工作线程任务异常: " + std::string(e.what()));
+        } catch (...) {
+            Logger::error("工作线程任务发生未知异常");
+        }
+    }
+}
@@ -0,0 +1,38 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 固定大小的工作线程池（任务队列无界，线程数有界）
+class ThreadPool {
+public:
+    // on_thread_start 在每个工作线程启动时执行一次（如设置亲和性）
+    explicit ThreadPool(size_t worker_count, std::function<void()> on_thread_start = nullptr);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // 提交任务，由空闲工作线程执行
+    void submit(std::function<void()> task);
+
+    // 工作线程数量
+    size_t size() const { return workers.size(); }
+
+private:
+    void worker_loop();
+
+    std::function<void()> thread_start_hook;
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    bool stopping = false;
+};
+
+#endif // THREAD_POOL_H
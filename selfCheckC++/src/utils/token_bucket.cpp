@@ -0,0 +1,45 @@
+#include "token_bucket.h"
+#include <algorithm>
+#include <thread>
+
+TokenBucket::TokenBucket(double initial_rate, double initial_burst)
+    : rate_bytes_per_sec(initial_rate),
+      burst_bytes(initial_burst),
+      tokens(initial_burst),
+      last_refill(std::chrono::steady_clock::now()) {}
+
+void TokenBucket::set_rate(double new_rate, double new_burst) {
+    std::lock_guard<std::mutex> lock(mutex);
+    refill(std::chrono::steady_clock::now());
+    rate_bytes_per_sec = new_rate;
+    burst_bytes = new_burst;
+    tokens = std::min(tokens, burst_bytes);
+}
+
+double TokenBucket::rate() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return rate_bytes_per_sec;
+}
+
+void TokenBucket::refill(std::chrono::steady_clock::time_point now) {
+    double elapsed = std::chrono::duration<double>(now - last_refill).count();
+    last_refill = now;
+    tokens = std::min(burst_bytes, tokens + elapsed * rate_bytes_per_sec);
+}
+
+std::chrono::nanoseconds TokenBucket::acquire(size_t bytes) {
+    std::chrono::nanoseconds wait(0);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (rate_bytes_per_sec <= 0) return wait;
+        refill(std::chrono::steady_clock::now());
+        tokens -= static_cast<double>(bytes);
+        if (tokens < 0) {
+            wait = std::chrono::nanoseconds(static_cast<long long>(-tokens / rate_bytes_per_sec * 1e9));
+        }
+    }
+    if (wait.count() > 0) {
+        std::this_thread::sleep_for(wait);
+    }
+    return wait;
+}
@@ -0,0 +1,31 @@
+#ifndef TOKEN_BUCKET_H
+#define TOKEN_BUCKET_H
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+
+// 字节令牌桶限速器，可在运行时调整速率，多个发送线程共享同一个桶。
+// 令牌允许透支：单次取用超过桶容量时先发送，再按透支量睡眠
+class TokenBucket {
+public:
+    // rate_bytes_per_sec <= 0 表示不限速
+    explicit TokenBucket(double rate_bytes_per_sec = 0.0, double burst_bytes = 0.0);
+
+    void set_rate(double rate_bytes_per_sec, double burst_bytes);
+    double rate() const;
+
+    // 取用 bytes 个令牌，不足时阻塞到令牌补足，返回等待时长
+    std::chrono::nanoseconds acquire(size_t bytes);
+
+private:
+    void refill(std::chrono::steady_clock::time_point now);
+
+    mutable std::mutex mutex;
+    double rate_bytes_per_sec;
+    double burst_bytes;
+    double tokens;
+    std::chrono::steady_clock::time_point last_refill;
+};
+
+#endif // TOKEN_BUCKET_H
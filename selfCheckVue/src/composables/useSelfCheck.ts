@@ -1,5 +1,5 @@
-import { ref, reactive, computed } from 'vue'
-import type { CheckItem, LogEntry, DetailItem, CheckStatus, OverallStatus } from '@/types/selfCheck'
+import { ref, reactive, computed, onMounted, onUnmounted } from 'vue'
+import type { CheckItem, LogEntry, DetailItem, CheckStatus, OverallStatus, BatchCheckResult, SystemEvent } from '@/types/selfCheck'
 
 export default function useSelfCheck() {
   // API基础路径
@@ -9,6 +9,7 @@ export default function useSelfCheck() {
   const checks = reactive<CheckItem[]>([
     {
       id: 1,
+      key: 'ssh',
       name: 'SSH连接检测',
       status: 'initial',
       message: '',
@@ -17,6 +18,7 @@ export default function useSelfCheck() {
     },
     {
       id: 2,
+      key: 'memory',
       name: '内存占用检测',
       status: 'initial',
       message: '',
@@ -25,6 +27,7 @@ export default function useSelfCheck() {
     },
     {
       id: 3,
+      key: 'gpu',
       name: 'GPU频率设置',
       status: 'initial',
       message: '',
@@ -33,6 +36,7 @@ export default function useSelfCheck() {
     },
     {
       id: 4,
+      key: 'serial',
       name: '串口设备状态',
       status: 'initial',
       message: '',
@@ -41,12 +45,112 @@ export default function useSelfCheck() {
     },
     {
       id: 5,
+      key: 'camera',
       name: '相机设备状态',
       status: 'initial',
       message: '',
       required: true,
       tips: '检查相机连接，确认相机驱动已正常加载。',
     },
+    {
+      id: 6,
+      key: 'cpu',
+      name: 'CPU状态',
+      status: 'initial',
+      message: '',
+      required: false,
+      tips: '检查大核簇是否被限频或负载饱和，确认调频策略与散热正常。',
+    },
+    {
+      id: 7,
+      key: 'thermal',
+      name: '温度状态',
+      status: 'initial',
+      message: '',
+      required: false,
+      tips: '检查散热风扇与散热片，温度接近触发点时芯片会降频。',
+    },
+    {
+      id: 8,
+      key: 'load',
+      name: '负载状态',
+      status: 'initial',
+      message: '',
+      required: false,
+      tips: '飞控进程压力过高时自检服务会自动降载，图片下载变慢、部分接口暂时不可用。',
+    },
+    {
+      id: 9,
+      key: 'processes',
+      name: '飞控进程状态',
+      status: 'initial',
+      message: '',
+      required: true,
+      tips: '确认 VO、DMatcher 与传输进程已启动；排队时间过长说明 CPU 被其他任务占用。',
+    },
+    {
+      id: 10,
+      key: 'interrupts',
+      name: '中断状态',
+      status: 'initial',
+      message: '',
+      required: false,
+      tips: '相机、串口或网卡中断风暴会导致 VO 丢帧，检查线缆与驱动，必要时调整 smp_affinity。',
+    },
+    {
+      id: 11,
+      key: 'storage',
+      name: '存储状态',
+      status: 'initial',
+      message: '',
+      required: false,
+      tips: '图片存储空间不足或写入变慢会导致采集丢图，清理旧图片或检查存储卡。',
+    },
+    {
+      id: 12,
+      key: 'network',
+      name: '网络状态',
+      status: 'initial',
+      message: '',
+      required: false,
+      tips: '图片下载缓慢时先查看链路速率与丢包，检查数传/网线连接与天线。',
+    },
+    {
+      id: 13,
+      key: 'ipc',
+      name: 'IPC端点',
+      status: 'initial',
+      message: '',
+      required: false,
+      tips: 'ipc 端点不可连接说明对应的 VO/DMatcher/传输进程未启动或已退出，检查进程状态与配置中的地址。',
+    },
+    {
+      id: 14,
+      key: 'models',
+      name: '模型文件',
+      status: 'initial',
+      message: '',
+      required: true,
+      tips: '模型文件缺失或摘要不一致时请重新拷贝模型，并核对 model_digests 中的期望摘要。',
+    },
+    {
+      id: 15,
+      key: 'can',
+      name: 'CAN总线',
+      status: 'initial',
+      message: '',
+      required: false,
+      tips: 'bus-off 或错误帧增多时请检查 CAN 线束、终端电阻与电调/云台供电，确认接口已按正确波特率启用。',
+    },
+    {
+      id: 16,
+      key: 'usb',
+      name: 'USB拓扑',
+      status: 'initial',
+      message: '',
+      required: false,
+      tips: '根端口带宽超额时请把 USB 相机分散到不同根端口或降低分辨率/帧率；设备降速时请更换线缆或直连主机端口。',
+    },
   ])
 
   // 详细诊断信息
@@ -182,6 +286,10 @@ export default function useSelfCheck() {
         endpoint = '/api/v1/check/camera'
         break
       default:
+        if (check.key) {
+          endpoint = `/api/v1/check/${check.key}`
+          break
+        }
         throw new Error(`未知检测项ID: ${check.id}`)
     }
     
@@ -267,6 +375,67 @@ export default function useSelfCheck() {
     }
   }
 
+  // 批量检测：一次请求并发执行全部检测项，结果按完成顺序流式返回
+  const performBatchCheck = async (): Promise<void> => {
+    const keys = checks.map((check) => check.key).join(',')
+    const response = await fetch(`${API_BASE_URL}/api/v1/check/all?checks=${keys}&stream=1`)
+    if (!response.ok || !response.body) {
+      throw new Error(`HTTP错误! 状态: ${response.status}`)
+    }
+
+    checks.forEach((check) => {
+      check.status = 'pending'
+    })
+    statusText.value = '正在并行检测所有项目'
+
+    const reader = response.body.getReader()
+    const decoder = new TextDecoder()
+    let buffer = ''
+    let completed = 0
+
+    const handleLine = (line: string): void => {
+      if (!line.trim()) return
+      const result = JSON.parse(line)
+      if (result.done) return
+
+      const item = result as BatchCheckResult
+      const check = checks.find((c) => c.key === item.name)
+      if (!check) return
+
+      check.status = item.status
+      check.message = item.message
+      addLog(check.name, check.status, item.message, check.tips)
+
+      completed++
+      progress.value = Math.round((completed / checks.length) * 100)
+    }
+
+    while (true) {
+      const { done, value } = await reader.read()
+      if (done) break
+      buffer += decoder.decode(value, { stream: true })
+
+      let newline = buffer.indexOf('\n')
+      while (newline >= 0) {
+        handleLine(buffer.slice(0, newline))
+        buffer = buffer.slice(newline + 1)
+        newline = buffer.indexOf('\n')
+      }
+    }
+    handleLine(buffer)
+
+    if (completed < checks.length) {
+      throw new Error(`批量检测未返回全部结果(${completed}/${checks.length})`)
+    }
+
+    isChecking.value = false
+    isFinished.value = true
+    statusText.value = '自检完成'
+    addLog('系统', 'success', '自检流程结束')
+
+    await fetchImages()
+  }
+
   // 启动自检函数 
   const startSelfTest = async (): Promise<void> => {
     logs.value = []
@@ -283,8 +452,18 @@ export default function useSelfCheck() {
     addLog('系统', 'pending', '开始自检流程')
     
     try {
-      // 开始实际检测流程
-      await performNextCheck()
+      // 优先使用批量检测，失败时退回逐项检测
+      try {
+        await performBatchCheck()
+      } catch (batchError: any) {
+        console.warn('批量检测失败，改为逐项检测:', batchError)
+        checks.forEach((check) => {
+          check.status = 'initial'
+          check.message = ''
+        })
+        progress.value = 0
+        await performNextCheck()
+      }
     } catch (error: any) {  // 添加 any 类型
       console.error('启动自检失败:', error)
       isChecking.value = false
@@ -400,6 +579,35 @@ export default function useSelfCheck() {
     addLog('图片库', 'success', `已下载图片: ${sanitizedImageName}`);
   };
 
+  // 订阅后端主动推送的监控事件（如内存压力告警），无需等待下一次自检
+  let eventSource: EventSource | null = null
+
+  const handleSystemEvent = (event: MessageEvent): void => {
+    const data = JSON.parse(event.data) as SystemEvent
+    const check = checks.find((c) => c.key === data.source)
+    const name = check ? check.name : data.source
+    addLog(name, data.status, data.message, check?.tips ?? '')
+    // 已判定为错误的检测项不被告警覆盖
+    if (check && check.status !== 'error') {
+      check.status = data.status
+      check.message = data.message
+    }
+  }
+
+  onMounted(() => {
+    eventSource = new EventSource(`${API_BASE_URL}/api/v1/events`)
+    checks.forEach((check) => {
+      if (check.key) {
+        eventSource?.addEventListener(check.key, handleSystemEvent as EventListener)
+      }
+    })
+  })
+
+  onUnmounted(() => {
+    eventSource?.close()
+    eventSource = null
+  })
+
   return {
     checks,
     details,
@@ -1,6 +1,7 @@
 // 自检项类型
 export interface CheckItem {
   id: number;
+  key: string;        // 后端检测项名称，对应 /api/v1/check/{key}
   name: string;
   status: CheckStatus;
   message: string;
@@ -28,6 +29,26 @@ export interface DetailItem {
   tips: string;
 }
 
+// 批量检测流式返回的单项结果
+export interface BatchCheckResult {
+  name: string;
+  status: CheckStatus;
+  message: string;
+  state: 'done' | 'skipped' | 'cancelled' | 'timeout';
+  started_ms: number;
+  elapsed_ms: number;
+}
+
+// /api/v1/events 推送的监控事件
+export interface SystemEvent {
+  id: number;
+  timestamp_ms: number;
+  source: string;     // 对应检测项 key
+  status: CheckStatus;
+  message: string;
+  details?: unknown;
+}
+
 // 自检状态枚举
 export type CheckStatus =
   | 'initial'